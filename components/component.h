@@ -2,6 +2,7 @@
 
 #include "../ecs.h"
 #include "../storage/batch_storage.h"
+#include "../storage/tag_storage.h"
 #include "core/object/class_db.h"
 #include "core/object/object.h"
 #include "core/templates/oa_hash_map.h"
@@ -51,6 +52,11 @@ public:                                                                \
 	m_class() = default;                                   \
 	m_class(const m_class &) = default;
 
+/// Register a tag component: a component without data, used to mark the
+/// `Entities`. It's stored using the `TagStorage`.
+#define COMPONENT_TAG(m_class) \
+	COMPONENT(m_class, TagStorage)
+
 /// Register a component using custom create storage function. The function is
 /// specified on `ECS::register_component<Component>([]() -> StorageBase * { /* Create the storage and return it. */ });`.
 #define COMPONENT_CUSTOM_STORAGE(m_class) \
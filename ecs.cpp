@@ -672,8 +672,9 @@ bool has_single_thread_only_databags(const SystemExeInfo &p_info) {
 }
 
 /// Returns true if these two `Set`s have at least 1 ID in common.
-bool collides(const RBSet<uint32_t> &p_set_1, const RBSet<uint32_t> &p_set_2) {
-	for (RBSet<uint32_t>::Element *e = p_set_1.front(); e; e = e->next()) {
+template <class T>
+bool collides(const RBSet<T> &p_set_1, const RBSet<T> &p_set_2) {
+	for (typename RBSet<T>::Element *e = p_set_1.front(); e; e = e->next()) {
 		if (p_set_2.has(e->get())) {
 			return true;
 		}
@@ -681,15 +682,6 @@ bool collides(const RBSet<uint32_t> &p_set_1, const RBSet<uint32_t> &p_set_2) {
 	return false;
 }
 
-bool collides(const RBSet<uint32_t> &p_set_1, const OAHashMap<uint32_t, RBSet<String>> &p_map_2) {
-	for (RBSet<uint32_t>::Element *e = p_set_1.front(); e; e = e->next()) {
-		if (p_map_2.has(e->get())) {
-			return true;
-		}
-	}
-	return false;
-}
-
 bool ECS::can_systems_run_in_parallel(godex::system_id p_system_a, godex::system_id p_system_b) {
 	ERR_FAIL_COND_V_MSG(verify_system_id(p_system_a) == false, false, "The SystemID: " + itos(p_system_a) + " doesn't exists. Are you passing a System ID?");
 	ERR_FAIL_COND_V_MSG(verify_system_id(p_system_b) == false, false, "The SystemID: " + itos(p_system_b) + " doesn't exists. Are you passing a System ID?");
@@ -749,20 +741,17 @@ bool ECS::can_systems_run_in_parallel(godex::system_id p_system_a, godex::system
 		return false;
 	}
 
-	// Check the events
-	if (collides(info_a.events_emitters, info_b.events_emitters)) {
-		// System A is emitting the same event the System B is emitting.
-		return false;
-	}
-	if (collides(info_a.events_emitters, info_b.events_receivers)) {
-		// System A is emitting an event that system B is receiving.
-		return false;
-	}
-	if (collides(info_b.events_emitters, info_a.events_receivers)) {
-		// System B is emitting an event that system A is receiving.
+	// Check the shared `QueryMatchCache`s.
+	if (collides(info_a.mutable_query_caches, info_b.mutable_query_caches)) {
+		// Both systems update the same cache.
 		return false;
 	}
 
+	// Note: The events never conflict. The emitters of the same event can run
+	// in parallel, since each thread emits into its own buffer; and the
+	// emitters and the receivers too, since the receivers read the events
+	// emitted by the previous stages.
+
 	// TODO Check NOT filter specialization.
 
 	return true;
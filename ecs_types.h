@@ -72,20 +72,36 @@ enum class StorageType {
 	BATCH_DENSE_VECTOR,
 };
 
+/// Identifies an `Entity`.
+/// The lower `INDEX_BITS` bits are the index, used by the storages to store the
+/// components; the upper bits are the generation. When an `Entity` is
+/// destroyed its index is reused, but with the next generation: so it's
+/// possible to detect a stale `EntityID` using `World::is_entity_alive`.
+///
+/// The conversion to `uint32_t` gives the index, while `get_raw` and the
+/// conversion to `Variant` give the full ID.
 class EntityID {
 	uint32_t id = UINT32_MAX;
 
 public:
+	static constexpr uint32_t INDEX_BITS = 24;
+	static constexpr uint32_t INDEX_MASK = (uint32_t(1) << INDEX_BITS) - 1;
+	static constexpr uint32_t GENERATION_MASK = UINT32_MAX >> INDEX_BITS;
+
 	EntityID() :
 			id(UINT32_MAX) {}
 
 	EntityID(const EntityID &) = default;
 
-	EntityID(uint32_t p_index) :
-			id(p_index) {}
+	/// Takes the full ID: with generation `0` it's just the index.
+	EntityID(uint32_t p_id) :
+			id(p_id) {}
+
+	EntityID(uint32_t p_index, uint32_t p_generation) :
+			id((p_index & INDEX_MASK) | ((p_generation & GENERATION_MASK) << INDEX_BITS)) {}
 
-	EntityID(Variant p_index) :
-			id(p_index.operator unsigned int()) {}
+	EntityID(Variant p_id) :
+			id(p_id.operator unsigned int()) {}
 
 	bool is_null() const {
 		return id == UINT32_MAX;
@@ -95,16 +111,29 @@ public:
 		return id != UINT32_MAX;
 	}
 
+	_FORCE_INLINE_ uint32_t get_index() const {
+		return id == UINT32_MAX ? UINT32_MAX : (id & INDEX_MASK);
+	}
+
+	uint32_t get_generation() const {
+		return id >> INDEX_BITS;
+	}
+
+	/// Returns the full ID, index and generation.
+	uint32_t get_raw() const {
+		return id;
+	}
+
 	bool operator==(const EntityID &p_other) const {
 		return id == p_other.id;
 	}
 
 	bool operator==(uint32_t p_naked_index) const {
-		return id == p_naked_index;
+		return get_index() == p_naked_index;
 	}
 
-	operator uint32_t() const {
-		return id;
+	_FORCE_INLINE_ operator uint32_t() const {
+		return get_index();
 	}
 
 	operator Variant() const {
@@ -146,6 +175,10 @@ constexpr system_bundle_id SYSTEM_BUNDLE_NONE = UINT32_MAX;
 /// Shared Component ID, used to identify a component.
 typedef uint32_t SID;
 constexpr SID SID_NONE = UINT32_MAX;
+
+/// Emitter ID, used to identify an event emitter within its `EventStorage`.
+typedef uint32_t EmitterId;
+constexpr EmitterId EMITTER_NONE = UINT32_MAX;
 } // namespace godex
 
 // ~~ PROPERTY MAPPER ~~
@@ -498,6 +531,25 @@ struct Token {
 	}
 };
 
+/// The tick up to which a change detection filter (`Changed`, `Added` or
+/// `Removed`) took the changes. The filter registers it to the `World`, check
+/// `World::register_tick_reader`, that clamps it so it never gets too old to
+/// be compared with the change ticks.
+struct ChangeTickReader {
+	/// The changes done after this tick are taken.
+	uint32_t last_run_tick = 0;
+	/// The components whose `Entities` logs are read, by the `Added` and
+	/// `Removed` filters: check `World::trim_entities_logs`.
+	LocalVector<godex::component_id> logged_components;
+	/// `false` while the filter is not used, so the logs don't wait for it.
+	bool active = true;
+
+	ChangeTickReader() = default;
+	// The `World` keeps its address, so it can't be copied.
+	ChangeTickReader(const ChangeTickReader &) = delete;
+	ChangeTickReader &operator=(const ChangeTickReader &) = delete;
+};
+
 /// This structure is used by the `SystemDispatcher` to hold some extra info
 /// useful during the Dispatcher execution.
 struct DispatcherSystemExecutionData {
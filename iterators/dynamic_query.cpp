@@ -11,6 +11,8 @@ void DynamicQuery::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("maybe_component", "component_id", "mutable"), &DynamicQuery::maybe_component);
 	ClassDB::bind_method(D_METHOD("changed_component", "component_id", "mutable"), &DynamicQuery::changed_component);
 	ClassDB::bind_method(D_METHOD("not_component", "component_id"), &DynamicQuery::not_component);
+	ClassDB::bind_method(D_METHOD("added_component", "component_id", "mutable"), &DynamicQuery::added_component);
+	ClassDB::bind_method(D_METHOD("removed_component", "component_id"), &DynamicQuery::removed_component);
 
 	ClassDB::bind_method(D_METHOD("is_valid"), &DynamicQuery::is_valid);
 	ClassDB::bind_method(D_METHOD("prepare_world"), &DynamicQuery::prepare_world_script);
@@ -32,6 +34,10 @@ void DynamicQuery::_bind_methods() {
 DynamicQuery::DynamicQuery() {
 }
 
+DynamicQuery::~DynamicQuery() {
+	unregister_tick_reader();
+}
+
 void DynamicQuery::set_space(Space p_space) {
 	space = p_space;
 }
@@ -52,6 +58,14 @@ void DynamicQuery::not_component(uint32_t p_component_id) {
 	_with_component(p_component_id, false, WITHOUT_MODE);
 }
 
+void DynamicQuery::added_component(uint32_t p_component_id, bool p_mutable) {
+	_with_component(p_component_id, p_mutable, ADDED_MODE);
+}
+
+void DynamicQuery::removed_component(uint32_t p_component_id) {
+	_with_component(p_component_id, false, REMOVED_MODE);
+}
+
 void DynamicQuery::_with_component(uint32_t p_component_id, bool p_mutable, FetchMode p_mode) {
 	ERR_FAIL_COND_MSG(is_valid() == false, "This query is not valid.");
 	ERR_FAIL_COND_MSG(can_change == false, "This query can't change at this point, you have to `clear` it.");
@@ -68,7 +82,6 @@ void DynamicQuery::_with_component(uint32_t p_component_id, bool p_mutable, Fetc
 	data.name = ECS::get_component_name(p_component_id);
 	data.mutability = p_mutable;
 	data.mode = p_mode;
-	data.entity_list_index = UINT32_MAX;
 	elements.push_back(data);
 }
 
@@ -80,6 +93,7 @@ void DynamicQuery::reset() {
 	valid = true;
 	can_change = true;
 	elements.reset();
+	unregister_tick_reader();
 	world = nullptr;
 }
 
@@ -139,27 +153,27 @@ void DynamicQuery::prepare_world(World *p_world) {
 	// complain, otherwise it needs to use pointers	(AccessComponent is a parent
 	// of Object).
 	accessors.resize(elements.size());
-	uint32_t entity_lists_count = 0;
 	for (uint32_t i = 0; i < elements.size(); i += 1) {
 		accessors[i].init(
 				elements[i].id,
 				elements[i].mutability);
-
-		if (elements[i].mode == CHANGED_MODE) {
-			entity_lists_count += 1;
-		}
 	}
 
-	// Resize once, so we can set valid pointers to the `World`.
-	entity_lists.resize(entity_lists_count);
-
-	uint32_t entity_list_i = 0;
+	bool reads_ticks = false;
+	tick_reader.logged_components.clear();
 	for (uint32_t i = 0; i < elements.size(); i += 1) {
-		if (elements[i].mode == CHANGED_MODE) {
-			elements[i].entity_list_index = entity_list_i;
-			p_world->get_storage(elements[i].id)->add_change_listener(entity_lists.ptr() + entity_list_i);
-			entity_list_i += 1;
+		if (elements[i].mode == ADDED_MODE || elements[i].mode == REMOVED_MODE) {
+			p_world->request_entities_log(elements[i].id);
+			tick_reader.logged_components.push_back(elements[i].id);
 		}
+		reads_ticks |= elements[i].mode == CHANGED_MODE || elements[i].mode == ADDED_MODE || elements[i].mode == REMOVED_MODE;
+	}
+
+	// Start tracking the changes from now.
+	tick_reader.last_run_tick = p_world->advance_change_tick();
+	if (reads_ticks) {
+		p_world->register_tick_reader(&tick_reader);
+		tick_reader_registered = true;
 	}
 }
 
@@ -176,10 +190,8 @@ void DynamicQuery::initiate_process(World *p_world) {
 	storages.resize(elements.size());
 	entities.count = UINT32_MAX;
 
-	// Freeze the EntityLists to avoid any changes.
-	for (uint32_t i = 0; i < entity_lists.size(); i += 1) {
-		entity_lists[i].freeze();
-	}
+	// Make sure the changes done from now on are not taken.
+	this_run_tick = world->advance_change_tick();
 
 	for (uint32_t i = 0; i < elements.size(); i += 1) {
 		storages[i] = world->get_storage(elements[i].id);
@@ -196,8 +208,15 @@ void DynamicQuery::initiate_process(World *p_world) {
 					// Not determinant, nothing to do.
 				} break;
 				case CHANGED_MODE: {
-					const EntityList &list = entity_lists[elements[i].entity_list_index];
-					eb = EntitiesBuffer(list.size(), list.get_entities_ptr());
+					// Iterates the storage, `has` takes only the changed one.
+					eb = storages[i]->get_stored_entities();
+				} break;
+				case ADDED_MODE: {
+					// Iterates only the `Entities` logged in this run window.
+					eb = storages[i]->get_added_entities(tick_reader.last_run_tick, this_run_tick);
+				} break;
+				case REMOVED_MODE: {
+					eb = storages[i]->get_removed_entities(tick_reader.last_run_tick, this_run_tick);
 				} break;
 			}
 			if (eb.count < entities.count) {
@@ -216,17 +235,9 @@ void DynamicQuery::initiate_process(World *p_world) {
 }
 
 void DynamicQuery::conclude_process(World *p_world) {
-	// Unfreeze the EntityLists.
-	for (uint32_t i = 0; i < entity_lists.size(); i += 1) {
-		entity_lists[i].unfreeze();
-	}
-
-	// Clear the changed entity_list at this point, so to start collecting the new
-	// changes.
-	for (uint32_t i = 0; i < elements.size(); i += 1) {
-		if (elements[i].mode == CHANGED_MODE) {
-			entity_lists[elements[i].entity_list_index].clear();
-		}
+	// Skip the changes done by this process, check `this_run_tick`.
+	if (likely(world != nullptr)) {
+		tick_reader.last_run_tick = world->advance_change_tick();
 	}
 
 	// Clear any component reference.
@@ -236,10 +247,17 @@ void DynamicQuery::conclude_process(World *p_world) {
 }
 
 void DynamicQuery::release_world(World *p_world) {
+	unregister_tick_reader();
 	world = nullptr;
 }
 
-void DynamicQuery::set_active(bool p_active) {}
+void DynamicQuery::set_active(bool p_active) {
+	tick_reader.active = p_active;
+	if (p_active && world != nullptr) {
+		// Ignores the changes happened while not active.
+		tick_reader.last_run_tick = world->advance_change_tick();
+	}
+}
 
 bool DynamicQuery::next() {
 	// Search the next Entity to fetch.
@@ -284,12 +302,26 @@ bool DynamicQuery::has(EntityID p_id) const {
 				non_determinant_count += 1;
 			} break;
 			case CHANGED_MODE: {
-				if (unlikely(storages[i] == nullptr) || entity_lists[elements[i].entity_list_index].has(p_id) == false) {
+				if (unlikely(storages[i] == nullptr) || storages[i]->is_changed(p_id, tick_reader.last_run_tick, this_run_tick) == false) {
 					// Returns false if the storage doesn't exists or is not
 					// changed.
 					return false;
 				}
 			} break;
+			case ADDED_MODE: {
+				if (unlikely(storages[i] == nullptr) ||
+						storages[i]->is_added(p_id, tick_reader.last_run_tick, this_run_tick) == false ||
+						storages[i]->has(p_id) == false) {
+					return false;
+				}
+			} break;
+			case REMOVED_MODE: {
+				if (unlikely(storages[i] == nullptr) ||
+						storages[i]->is_removed(p_id, tick_reader.last_run_tick, this_run_tick) == false ||
+						storages[i]->has(p_id)) {
+					return false;
+				}
+			} break;
 		}
 	}
 
@@ -336,7 +368,7 @@ void DynamicQuery::fetch(EntityID p_entity_id) {
 }
 
 uint32_t DynamicQuery::script_get_current_entity_id() const {
-	return get_current_entity_id();
+	return get_current_entity_id().get_raw();
 }
 
 EntityID DynamicQuery::get_current_entity_id() const {
@@ -401,3 +433,10 @@ int64_t DynamicQuery::find_element_by_name(const StringName &p_name) const {
 	}
 	return -1;
 }
+
+void DynamicQuery::unregister_tick_reader() {
+	if (tick_reader_registered && world != nullptr) {
+		world->unregister_tick_reader(&tick_reader);
+	}
+	tick_reader_registered = false;
+}
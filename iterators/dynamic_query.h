@@ -22,6 +22,8 @@ class DynamicQuery : public GodexWorldFetcher {
 		MAYBE_MODE,
 		CHANGED_MODE,
 		WITHOUT_MODE,
+		ADDED_MODE,
+		REMOVED_MODE,
 	};
 
 	struct DynamicQueryElement {
@@ -30,9 +32,6 @@ class DynamicQuery : public GodexWorldFetcher {
 		StringName name;
 		bool mutability;
 		FetchMode mode;
-		/// Points to the entity list when the mode is sert to `Inserted`,
-		/// `Changed`, `Removed`
-		uint32_t entity_list_index;
 	};
 
 	bool valid = true;
@@ -41,7 +40,14 @@ class DynamicQuery : public GodexWorldFetcher {
 	LocalVector<DynamicQueryElement> elements;
 	LocalVector<ComponentDynamicExposer> accessors;
 	LocalVector<StorageBase *> storages;
-	LocalVector<EntityList> entity_lists;
+	/// The `CHANGED_MODE`, `ADDED_MODE` and `REMOVED_MODE` take the changes
+	/// done after its tick. Registered to the `World` only when used.
+	ChangeTickReader tick_reader;
+	bool tick_reader_registered = false;
+	/// The `CHANGED_MODE`, `ADDED_MODE` and `REMOVED_MODE` ignore the changes
+	/// done after this tick: the ones done during the process are skipped,
+	/// like the `Changed` filter of the `Query`.
+	uint32_t this_run_tick = 0;
 
 	World *world = nullptr;
 	uint32_t iterator_index = 0;
@@ -52,6 +58,7 @@ class DynamicQuery : public GodexWorldFetcher {
 
 public:
 	DynamicQuery();
+	~DynamicQuery();
 
 	/// Set the fetch mode of this query.
 	void set_space(Space p_space);
@@ -60,6 +67,11 @@ public:
 	void with_component(uint32_t p_component_id, bool p_mutable = false);
 	void maybe_component(uint32_t p_component_id, bool p_mutable = false);
 	void changed_component(uint32_t p_component_id, bool p_mutable = false);
+	/// Takes the `Entities` that got this component since the last run.
+	void added_component(uint32_t p_component_id, bool p_mutable = false);
+
+	/// Takes the `Entities` that lost this component since the last run.
+	void removed_component(uint32_t p_component_id);
 
 	/// Excludes this component from the query.
 	void not_component(uint32_t p_component_id);
@@ -113,5 +125,8 @@ public:
 	virtual Variant getvar(const Variant &p_key, bool *r_valid = nullptr) const override;
 
 	int64_t find_element_by_name(const StringName &p_name) const;
+
+private:
+	void unregister_tick_reader();
 };
 } // namespace godex
@@ -12,6 +12,22 @@
 ///		p_emitter.emit("EmitterName2", MyEvent());
 /// }
 /// ```
+///
+/// When emitting many events, resolve the emitter name once and emit using
+/// the `EmitterId`, so the name is not looked up for each event:
+/// ```
+/// void my_emitter_system(EventsEmitter<MyEvent> &p_emitter){
+///		const godex::EmitterId emitter = p_emitter.get_emitter_id("EmitterName1");
+///		for(int i = 0; i < 100; i += 1) {
+///			p_emitter.emit(emitter, MyEvent());
+///		}
+/// }
+/// ```
+/// The `EmitterId` is valid as long as the `World` is; `EMITTER_NONE` is
+/// returned when no systems are receiving from that emitter.
+///
+/// The emitted events are readable by the receivers once the stage that
+/// emitted them is over.
 template <class E>
 class EventsEmitter {
 	EventStorage<E> *storage = nullptr;
@@ -19,17 +35,23 @@ class EventsEmitter {
 public:
 	void initiate_process(World *p_world) {
 		storage = p_world->get_events_storage<E>();
-		// Flush the old events.
-		storage->flush_events();
 	}
 
 	void release_world() {
 		storage = nullptr;
 	}
 
+	godex::EmitterId get_emitter_id(const String &p_emitter_name) const {
+		return storage->get_emitter_id(p_emitter_name);
+	}
+
 	void emit(const String &p_emitter_name, const E &p_event) {
 		storage->add_event(p_emitter_name, p_event);
 	}
+
+	void emit(godex::EmitterId p_emitter, const E &p_event) {
+		storage->add_event(p_emitter, p_event);
+	}
 };
 
 /// Utility that allow to fetch the events from the world. You can even use it
@@ -41,9 +63,18 @@ public:
 ///		}
 /// }
 /// ```
+///
+/// Each receiver reads every event exactly once: the events emitted in the
+/// previous stages, and those emitted since this receiver run the last time.
 template <class E, typename EmitterName>
 class EventsReceiver {
+	EventStorage<E> *storage = nullptr;
+	godex::EmitterId emitter_id = godex::EMITTER_NONE;
+	uint32_t receiver = UINT32_MAX;
+
 	const LocalVector<E> *emitter_storage = nullptr;
+	/// The first event this receiver didn't read yet.
+	uint32_t from = 0;
 
 public:
 	struct Iterator {
@@ -84,10 +115,29 @@ public:
 	};
 
 public:
+	EventsReceiver() = default;
+
+	/// Registers this receiver, so the events are kept until it reads them.
+	EventsReceiver(World *p_world) {
+		register_receiver(p_world);
+	}
+
+	EventsReceiver(const EventsReceiver &) = delete;
+	EventsReceiver &operator=(const EventsReceiver &) = delete;
+
+	~EventsReceiver() {
+		if (receiver != UINT32_MAX) {
+			storage->remove_event_receiver(emitter_id, receiver);
+		}
+	}
+
 	void initiate_process(World *p_world) {
-		EventStorage<E> *storage = p_world->get_events_storage<E>();
-		if (storage != nullptr) {
-			emitter_storage = storage->get_events(get_emitter_name());
+		if (receiver == UINT32_MAX) {
+			register_receiver(p_world);
+		}
+		if (receiver != UINT32_MAX) {
+			emitter_storage = storage->get_events(emitter_id);
+			from = storage->receive_events(emitter_id, receiver);
 		}
 	}
 
@@ -95,14 +145,26 @@ public:
 		emitter_storage = nullptr;
 	}
 
+	/// While not active the events are not kept for this receiver.
+	void set_active(bool p_active) {
+		if (receiver != UINT32_MAX) {
+			storage->set_event_receiver_active(emitter_id, receiver, p_active);
+		}
+	}
+
 	static String get_emitter_name() {
 		return String(EmitterName::data());
 	}
 
+	/// Returns the amount of events to read.
+	uint32_t size() const {
+		return emitter_storage == nullptr ? 0 : emitter_storage->size() - from;
+	}
+
 	/// Returns the forward iterator to fetch the events.
 	Iterator begin() {
 		ERR_FAIL_COND_V_MSG(emitter_storage == nullptr, Iterator(emitter_storage, 0), "The emitter `" + E::get_class_static() + "::" + get_emitter_name() + "` storage doesn't exist.");
-		return Iterator(emitter_storage, 0);
+		return Iterator(emitter_storage, from);
 	}
 
 	/// Used to know the last element of the `Iterator`.
@@ -110,4 +172,16 @@ public:
 		ERR_FAIL_COND_V_MSG(emitter_storage == nullptr, Iterator(emitter_storage, 0), "The emitter `" + E::get_class_static() + "::" + get_emitter_name() + "` storage doesn't exist.");
 		return Iterator(emitter_storage, emitter_storage->size());
 	}
+
+private:
+	void register_receiver(World *p_world) {
+		storage = p_world->get_events_storage<E>();
+		if (storage == nullptr) {
+			return;
+		}
+		emitter_id = storage->get_emitter_id(get_emitter_name());
+		if (emitter_id != godex::EMITTER_NONE) {
+			receiver = storage->add_event_receiver(emitter_id);
+		}
+	}
 };
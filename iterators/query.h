@@ -1,8 +1,13 @@
 #pragma once
 
+#include "../storage/archetype_table.h"
+#include "../storage/dense_group.h"
+#include "../storage/entity_bit_list.h"
 #include "../storage/storage.h"
 #include "../systems/system.h"
 #include "../world/world.h"
+#include "core/object/worker_thread_pool.h"
+#include <tuple>
 
 // ---------------------------------------------------------------- Query filters
 
@@ -18,6 +23,22 @@ struct Maybe {};
 template <class C>
 struct Changed {};
 
+/// The `Added` filter takes the `Entities` that got the component since the
+/// last time this `Query` run, and still have it:
+/// `Query<EntityID, Added<MeshComponent>> query;`
+///
+/// It iterates the log of the inserted `Entities`, so an initialization
+/// system costs as much as the `Entities` added, rather than the stored ones.
+template <class C>
+struct Added {};
+
+/// The `Removed` filter takes the `Entities` that lost the component since
+/// the last time this `Query` run, and didn't get it back. The component is
+/// not there anymore, so it's always `nullptr`:
+/// `Query<EntityID, Removed<MeshComponent>> query;`
+template <class C>
+struct Removed {};
+
 /// Some storages have the ability to store multiple components per `Entity`,
 /// to get all the stored components you can use the `Batch` filter:
 /// `Query<Batch<MyEvent>> query;`
@@ -221,6 +242,19 @@ struct fetch_element<S, S, Not<C>, Cs...> : fetch_element<S, S + 1, Cs...> {
 	using type = fetch_element_type<0, 0, C>;
 };
 
+/// We found the `Added` filter, fetch the type now.
+template <std::size_t S, class C, class... Cs>
+struct fetch_element<S, S, Added<C>, Cs...> : fetch_element<S, S + 1, Cs...> {
+	using type = C *;
+};
+
+/// We found the `Removed` filter, fetch the type now.
+template <std::size_t S, class C, class... Cs>
+struct fetch_element<S, S, Removed<C>, Cs...> : fetch_element<S, S + 1, Cs...> {
+	// Always `nullptr`, but typed like the `Not` filter.
+	using type = C *;
+};
+
 /// We found the `Create` filter, fetch the type now.
 template <std::size_t S, class C, class... Cs>
 struct fetch_element<S, S, Create<C>, Cs...> : fetch_element<S, S + 1, Cs...> {
@@ -402,6 +436,18 @@ constexpr void set_impl(T p_val, QueryResultTuple_Impl<S, Not<C>, Cs...> &tuple)
 	set_impl<S>(p_val, static_cast<QueryResultTuple_Impl<S, C, Cs...> &>(tuple));
 }
 
+/// Remove the filter `Added` and set the value.
+template <std::size_t S, class T, class C, class... Cs>
+constexpr void set_impl(T p_val, QueryResultTuple_Impl<S, Added<C>, Cs...> &tuple) noexcept {
+	set_impl<S>(p_val, static_cast<QueryResultTuple_Impl<S, C, Cs...> &>(tuple));
+}
+
+/// Ignore the filter `Removed` and set the value.
+template <std::size_t S, class T, class C, class... Cs>
+constexpr void set_impl(T p_val, QueryResultTuple_Impl<S, Removed<C>, Cs...> &tuple) noexcept {
+	set_impl<S>(p_val, static_cast<QueryResultTuple_Impl<S, C, Cs...> &>(tuple));
+}
+
 /// Ignore the filter `Create` and set the value.
 template <std::size_t S, class T, class C, class... Cs>
 constexpr void set_impl(T p_val, QueryResultTuple_Impl<S, Create<C>, Cs...> &tuple) noexcept {
@@ -478,6 +524,18 @@ constexpr auto get_impl(const QueryResultTuple_Impl<S, Not<C>, Cs...> &tuple) no
 	return get_impl<S>(static_cast<const QueryResultTuple_Impl<S, C, Cs...> &>(tuple));
 }
 
+/// Skip the filter `Added`.
+template <std::size_t S, class C, class... Cs>
+constexpr auto get_impl(const QueryResultTuple_Impl<S, Added<C>, Cs...> &tuple) noexcept {
+	return get_impl<S>(static_cast<const QueryResultTuple_Impl<S, C, Cs...> &>(tuple));
+}
+
+/// Skip the filter `Removed`.
+template <std::size_t S, class C, class... Cs>
+constexpr auto get_impl(const QueryResultTuple_Impl<S, Removed<C>, Cs...> &tuple) noexcept {
+	return get_impl<S>(static_cast<const QueryResultTuple_Impl<S, C, Cs...> &>(tuple));
+}
+
 /// Skip the filter `Maybe`.
 template <std::size_t S, class C, class... Cs>
 constexpr auto get_impl(const QueryResultTuple_Impl<S, Maybe<C>, Cs...> &tuple) noexcept {
@@ -517,6 +575,13 @@ struct QueryStorage {
 		return { UINT32_MAX, nullptr };
 	}
 
+	/// Adds the `entities_version` of the storages that provide the
+	/// `Entities` returned by `get_entities`. Returns `false` when a storage
+	/// doesn't track its `Entities`, so the version is unknown.
+	bool get_entities_version(uint64_t &r_version) const {
+		return true;
+	}
+
 	bool filter_satisfied(EntityID p_entity) const { return true; }
 	bool can_fetch(EntityID p_entity) const { return false; }
 
@@ -525,6 +590,11 @@ struct QueryStorage {
 		// Nothing to fetch.
 	}
 
+	template <class... Qs>
+	void fetch_archetype(void *const *p_columns, uint32_t p_row, EntityID p_id, QueryResultTuple<Qs...> &r_result) const {
+		// Nothing to fetch.
+	}
+
 	static void get_components(SystemExeInfo &r_info, const bool p_force_immutable = false) {}
 };
 
@@ -549,6 +619,10 @@ struct QueryStorage<I, EntityID, Cs...> : public QueryStorage<I + 1, Cs...> {
 		return QueryStorage<I + 1, Cs...>::get_entities();
 	}
 
+	bool get_entities_version(uint64_t &r_version) const {
+		return QueryStorage<I + 1, Cs...>::get_entities_version(r_version);
+	}
+
 	bool filter_satisfied(EntityID p_entity) const {
 		return QueryStorage<I + 1, Cs...>::filter_satisfied(p_entity);
 	}
@@ -565,6 +639,12 @@ struct QueryStorage<I, EntityID, Cs...> : public QueryStorage<I + 1, Cs...> {
 		QueryStorage<I + 1, Cs...>::fetch(p_id, p_mode, r_result);
 	}
 
+	template <class... Qs>
+	void fetch_archetype(void *const *p_columns, uint32_t p_row, EntityID p_id, QueryResultTuple<Qs...> &r_result) const {
+		set<I>(r_result, p_id);
+		QueryStorage<I + 1, Cs...>::fetch_archetype(p_columns, p_row, p_id, r_result);
+	}
+
 	static void get_components(SystemExeInfo &r_info, const bool p_force_immutable = false) {
 		QueryStorage<I + 1, Cs...>::get_components(r_info);
 	}
@@ -602,6 +682,10 @@ struct QueryStorage<I, Create<C>, Cs...> : public QueryStorage<I + 1, Cs...> {
 		return QueryStorage<I + 1, Cs...>::get_entities();
 	}
 
+	bool get_entities_version(uint64_t &r_version) const {
+		return QueryStorage<I + 1, Cs...>::get_entities_version(r_version);
+	}
+
 	bool filter_satisfied(EntityID p_entity) const {
 		// The `Create` filter never stops the execution.
 		return QueryStorage<I + 1, Cs...>::filter_satisfied(p_entity);
@@ -667,6 +751,10 @@ struct QueryStorage<I, Maybe<C>, Cs...> : public QueryStorage<I + 1, Cs...> {
 		return QueryStorage<I + 1, Cs...>::get_entities();
 	}
 
+	bool get_entities_version(uint64_t &r_version) const {
+		return QueryStorage<I + 1, Cs...>::get_entities_version(r_version);
+	}
+
 	bool filter_satisfied(EntityID p_entity) const {
 		// The `Maybe` filter never stops the execution.
 		return QueryStorage<I + 1, Cs...>::filter_satisfied(p_entity);
@@ -728,6 +816,10 @@ struct QueryStorage<I, Not<C>, Cs...> : public QueryStorage<I + 1, Cs...> {
 		return QueryStorage<I + 1, Cs...>::get_entities();
 	}
 
+	bool get_entities_version(uint64_t &r_version) const {
+		return QueryStorage<I + 1, Cs...>::get_entities_version(r_version);
+	}
+
 	bool filter_satisfied(EntityID p_entity) const {
 		// The `Not` filter is satisfied if the sub filter is not satisfied:
 		// it's a lot similar to an `!true == false`.
@@ -765,51 +857,53 @@ struct QueryStorage<I, Not<C>, Cs...> : public QueryStorage<I + 1, Cs...> {
 // --------------------------------------------------------------------- Changed
 
 /// `QueryStorage` `Changed` filter specialization.
+/// The storages mark each changed component with the `World` change tick, so
+/// this filter fetches the components changed since the last time this
+/// `Query` run, by the other systems: the changes done while it runs are
+/// skipped, so a system that writes the component it filters doesn't take
+/// its own changes back the next run.
 template <std::size_t I, class C, class... Cs>
 struct QueryStorage<I, Changed<C>, Cs...> : public QueryStorage<I + 1, Cs...> {
 	World *world = nullptr;
-	EntityList changed;
 	Storage<C> *storage = nullptr;
+	/// The changes done after its tick are taken.
+	ChangeTickReader tick_reader;
+	/// The changes done after this tick, during the process, are skipped:
+	/// while this `Query` runs no other system can write the component, so
+	/// those are the changes of this system, like the mutable fetch of this
+	/// filter.
+	uint32_t this_run_tick = 0;
 
 	QueryStorage(World *p_world) :
 			QueryStorage<I + 1, Cs...>(p_world),
 			world(p_world) {
-		Storage<C> *s = p_world->get_storage<C>();
-		if (s) {
-			s->add_change_listener(&changed);
-		}
+		tick_reader.last_run_tick = p_world->advance_change_tick();
+		p_world->register_tick_reader(&tick_reader);
 	}
+
 	~QueryStorage() {
-		Storage<C> *s = world->get_storage<C>();
-		if (s) {
-			s->remove_change_listener(&changed);
-		}
+		world->unregister_tick_reader(&tick_reader);
 	}
 
 	void initiate_process(World *p_world) {
 		QueryStorage<I + 1, Cs...>::initiate_process(p_world);
 		storage = p_world->get_storage<C>();
-		// Make sure this doesn't change at this point.
-		changed.freeze();
+		// Make sure the changes done from now on are not taken.
+		this_run_tick = p_world->advance_change_tick();
 	}
 
 	void conclude_process(World *p_world) {
 		QueryStorage<I + 1, Cs...>::conclude_process(p_world);
 		storage = nullptr;
-		// Unfreeze the list and clear it to listen on the new events.
-		changed.unfreeze();
-		changed.clear();
+		// Skip the changes done by this process, check `this_run_tick`.
+		tick_reader.last_run_tick = world->advance_change_tick();
 	}
 
 	void set_world_notification_active(bool p_active) {
 		QueryStorage<I + 1, Cs...>::set_world_notification_active(p_active);
-		Storage<C> *s = world->get_storage<C>();
-		if (s) {
-			if (p_active) {
-				s->add_change_listener(&changed);
-			} else {
-				s->remove_change_listener(&changed);
-			}
+		if (p_active) {
+			// Ignores the changes happened while not active.
+			tick_reader.last_run_tick = world->advance_change_tick();
 		}
 	}
 
@@ -819,23 +913,34 @@ struct QueryStorage<I, Changed<C>, Cs...> : public QueryStorage<I + 1, Cs...> {
 	}
 
 	EntitiesBuffer get_entities() const {
-		// This is a determinant filter, that iterates over the changed
-		// components of this storage.
+		// This is a determinant filter, that iterates over the components of
+		// this storage: `filter_satisfied` takes only the changed one.
 		const EntitiesBuffer o_entities = QueryStorage<I + 1, Cs...>::get_entities();
 		if (unlikely(storage == nullptr)) {
 			return o_entities;
 		}
-		const EntitiesBuffer entities(changed.size(), changed.get_entities_ptr());
+		const EntitiesBuffer entities = storage->get_stored_entities();
 		return entities.count < o_entities.count ? entities : o_entities;
 	}
 
+	bool get_entities_version(uint64_t &r_version) const {
+		if (storage != nullptr) {
+			const uint64_t version = storage->get_entities_version();
+			if (version == 0) {
+				return false;
+			}
+			r_version += version;
+		}
+		return QueryStorage<I + 1, Cs...>::get_entities_version(r_version);
+	}
+
 	bool filter_satisfied(EntityID p_entity) const {
 		if (unlikely(storage == nullptr)) {
 			// This is a required field, since there is no storage this can end
 			// immediately.
 			return false;
 		}
-		return changed.has(p_entity) && QueryStorage<I + 1, Cs...>::filter_satisfied(p_entity);
+		return storage->is_changed(p_entity, tick_reader.last_run_tick, this_run_tick) && QueryStorage<I + 1, Cs...>::filter_satisfied(p_entity);
 	}
 
 	bool can_fetch(EntityID p_entity) const {
@@ -873,6 +978,219 @@ struct QueryStorage<I, Changed<C>, Cs...> : public QueryStorage<I + 1, Cs...> {
 	}
 };
 
+// ----------------------------------------------------------------------- Added
+
+/// `QueryStorage` `Added` filter specialization.
+/// The storage logs the inserted `Entities` with the `World` change tick, so
+/// this filter iterates the `Entities` logged since the last time this
+/// `Query` run.
+template <std::size_t I, class C, class... Cs>
+struct QueryStorage<I, Added<C>, Cs...> : public QueryStorage<I + 1, Cs...> {
+	World *world = nullptr;
+	Storage<C> *storage = nullptr;
+	/// The changes done after its tick are taken.
+	ChangeTickReader tick_reader;
+	/// The `Entities` logged after this tick, during the process, are
+	/// skipped: those are inserted by this system, check `Changed`.
+	uint32_t this_run_tick = 0;
+
+	QueryStorage(World *p_world) :
+			QueryStorage<I + 1, Cs...>(p_world),
+			world(p_world) {
+		p_world->request_entities_log(C::get_component_id());
+		tick_reader.last_run_tick = p_world->advance_change_tick();
+		p_world->register_tick_reader(&tick_reader);
+	}
+
+	~QueryStorage() {
+		world->unregister_tick_reader(&tick_reader);
+	}
+
+	void initiate_process(World *p_world) {
+		QueryStorage<I + 1, Cs...>::initiate_process(p_world);
+		storage = p_world->get_storage<C>();
+		// Make sure the `Entities` inserted from now on are not taken.
+		this_run_tick = p_world->advance_change_tick();
+	}
+
+	void conclude_process(World *p_world) {
+		QueryStorage<I + 1, Cs...>::conclude_process(p_world);
+		storage = nullptr;
+		// Skip the `Entities` inserted by this process.
+		tick_reader.last_run_tick = world->advance_change_tick();
+	}
+
+	void set_world_notification_active(bool p_active) {
+		QueryStorage<I + 1, Cs...>::set_world_notification_active(p_active);
+		tick_reader.active = p_active;
+		if (p_active) {
+			// Ignores the `Entities` inserted while not active.
+			tick_reader.last_run_tick = world->advance_change_tick();
+		}
+	}
+
+	constexpr static bool is_filter_derminant() {
+		return true;
+	}
+
+	EntitiesBuffer get_entities() const {
+		// Iterates only the `Entities` logged in this run window.
+		const EntitiesBuffer o_entities = QueryStorage<I + 1, Cs...>::get_entities();
+		if (unlikely(storage == nullptr)) {
+			return o_entities;
+		}
+		const EntitiesBuffer entities = storage->get_added_entities(tick_reader.last_run_tick, this_run_tick);
+		return entities.count < o_entities.count ? entities : o_entities;
+	}
+
+	bool get_entities_version(uint64_t &r_version) const {
+		// The log window moves each run, even when no `Entity` is inserted.
+		return false;
+	}
+
+	bool filter_satisfied(EntityID p_entity) const {
+		if (unlikely(storage == nullptr)) {
+			return false;
+		}
+		return storage->is_added(p_entity, tick_reader.last_run_tick, this_run_tick) &&
+			   storage->has(p_entity) &&
+			   QueryStorage<I + 1, Cs...>::filter_satisfied(p_entity);
+	}
+
+	bool can_fetch(EntityID p_entity) const {
+		return storage && storage->has(p_entity);
+	}
+
+	template <class... Qs>
+	void fetch(EntityID p_id, Space p_mode, QueryResultTuple<Qs...> &r_result) const {
+#ifdef DEBUG_ENABLED
+		CRASH_COND_MSG(storage == nullptr, "The storage" + String(typeid(Storage<C>).name()) + " is null.");
+#endif
+
+		if constexpr (std::is_const<C>::value) {
+			set<I>(r_result, const_cast<const Storage<C> *>(storage)->get(p_id, p_mode));
+		} else {
+			set<I>(r_result, storage->get(p_id, p_mode));
+		}
+
+		// Keep going
+		QueryStorage<I + 1, Cs...>::fetch(p_id, p_mode, r_result);
+	}
+
+	auto get_inner_storage() const {
+		return storage;
+	}
+
+	static void get_components(SystemExeInfo &r_info, const bool p_force_immutable = false) {
+		if (std::is_const<C>::value || p_force_immutable) {
+			r_info.immutable_components.insert(C::get_component_id());
+		} else {
+			r_info.mutable_components.insert(C::get_component_id());
+		}
+		QueryStorage<I + 1, Cs...>::get_components(r_info);
+	}
+};
+
+// --------------------------------------------------------------------- Removed
+
+/// `QueryStorage` `Removed` filter specialization.
+/// The storage logs the removed `Entities` with the `World` change tick, so
+/// this filter iterates the `Entities` logged since the last time this
+/// `Query` run. There is nothing to fetch, like with the `Not` filter.
+template <std::size_t I, class C, class... Cs>
+struct QueryStorage<I, Removed<C>, Cs...> : public QueryStorage<I + 1, Cs...> {
+	World *world = nullptr;
+	Storage<C> *storage = nullptr;
+	/// The changes done after its tick are taken.
+	ChangeTickReader tick_reader;
+	/// The `Entities` logged after this tick, during the process, are
+	/// skipped: those are removed by this system, check `Changed`.
+	uint32_t this_run_tick = 0;
+
+	QueryStorage(World *p_world) :
+			QueryStorage<I + 1, Cs...>(p_world),
+			world(p_world) {
+		p_world->request_entities_log(C::get_component_id());
+		tick_reader.last_run_tick = p_world->advance_change_tick();
+		p_world->register_tick_reader(&tick_reader);
+	}
+
+	~QueryStorage() {
+		world->unregister_tick_reader(&tick_reader);
+	}
+
+	void initiate_process(World *p_world) {
+		QueryStorage<I + 1, Cs...>::initiate_process(p_world);
+		storage = p_world->get_storage<C>();
+		// Make sure the `Entities` removed from now on are not taken.
+		this_run_tick = p_world->advance_change_tick();
+	}
+
+	void conclude_process(World *p_world) {
+		QueryStorage<I + 1, Cs...>::conclude_process(p_world);
+		storage = nullptr;
+		// Skip the `Entities` removed by this process.
+		tick_reader.last_run_tick = world->advance_change_tick();
+	}
+
+	void set_world_notification_active(bool p_active) {
+		QueryStorage<I + 1, Cs...>::set_world_notification_active(p_active);
+		tick_reader.active = p_active;
+		if (p_active) {
+			// Ignores the `Entities` removed while not active.
+			tick_reader.last_run_tick = world->advance_change_tick();
+		}
+	}
+
+	constexpr static bool is_filter_derminant() {
+		return true;
+	}
+
+	EntitiesBuffer get_entities() const {
+		// Iterates only the `Entities` logged in this run window.
+		const EntitiesBuffer o_entities = QueryStorage<I + 1, Cs...>::get_entities();
+		if (unlikely(storage == nullptr)) {
+			return o_entities;
+		}
+		const EntitiesBuffer entities = storage->get_removed_entities(tick_reader.last_run_tick, this_run_tick);
+		return entities.count < o_entities.count ? entities : o_entities;
+	}
+
+	bool get_entities_version(uint64_t &r_version) const {
+		// The log window moves each run, even when no `Entity` is removed.
+		return false;
+	}
+
+	bool filter_satisfied(EntityID p_entity) const {
+		if (unlikely(storage == nullptr)) {
+			return false;
+		}
+		return storage->is_removed(p_entity, tick_reader.last_run_tick, this_run_tick) &&
+			   storage->has(p_entity) == false &&
+			   QueryStorage<I + 1, Cs...>::filter_satisfied(p_entity);
+	}
+
+	bool can_fetch(EntityID p_entity) const {
+		return false;
+	}
+
+	template <class... Qs>
+	void fetch(EntityID p_id, Space p_mode, QueryResultTuple<Qs...> &r_result) const {
+		// The component is gone, nothing to fetch.
+		QueryStorage<I + 1, Cs...>::fetch(p_id, p_mode, r_result);
+	}
+
+	auto get_inner_storage() const {
+		return storage;
+	}
+
+	static void get_components(SystemExeInfo &r_info, const bool p_force_immutable = false) {
+		// Nothing is fetched, so the storage is always taken immutably.
+		r_info.immutable_components.insert(C::get_component_id());
+		QueryStorage<I + 1, Cs...>::get_components(r_info);
+	}
+};
+
 // ----------------------------------------------------------------------- Batch
 
 /// `QueryStorage` `Batch` filter specialization.
@@ -905,6 +1223,10 @@ struct QueryStorage<I, Batch<C>, Cs...> : public QueryStorage<I + 1, Cs...> {
 		return query_storage.get_entities();
 	}
 
+	bool get_entities_version(uint64_t &r_version) const {
+		return query_storage.get_entities_version(r_version);
+	}
+
 	bool filter_satisfied(EntityID p_entity) const {
 		return query_storage.filter_satisfied(p_entity);
 	}
@@ -983,7 +1305,11 @@ struct AJUtility {
 		return false;
 	}
 
-	void get_entities(EntityList &r_entities) const {}
+	void get_entities(EntityBitList &r_entities) const {}
+
+	bool get_entities_version(uint64_t &r_version) const {
+		return true;
+	}
 
 	bool filter_satisfied(EntityID p_entity) const {
 		// Not satisfied.
@@ -1044,16 +1370,20 @@ struct AJUtility<I, INCREMENT, C, Cs...> : AJUtility<I + INCREMENT, INCREMENT, C
 		}
 	}
 
-	void get_entities(EntityList &r_entities) const {
-		if (storage.get_entities().count != UINT32_MAX) {
+	void get_entities(EntityBitList &r_entities) const {
+		const EntitiesBuffer buffer = storage.get_entities();
+		if (buffer.count != UINT32_MAX) {
 			// This is a determinant fitler, take the `Entities`.
-			for (uint32_t i = 0; i < storage.get_entities().count; i += 1) {
-				r_entities.insert(storage.get_entities().entities[i]);
-			}
+			r_entities.insert(buffer.entities, buffer.count);
 		}
 		AJUtility<I + INCREMENT, INCREMENT, Cs...>::get_entities(r_entities);
 	}
 
+	bool get_entities_version(uint64_t &r_version) const {
+		return storage.get_entities_version(r_version) &&
+				AJUtility<I + INCREMENT, INCREMENT, Cs...>::get_entities_version(r_version);
+	}
+
 	bool filter_satisfied(EntityID p_entity) const {
 		// Is someone able to satisfy the filter?
 		if (storage.filter_satisfied(p_entity)) {
@@ -1116,7 +1446,10 @@ template <std::size_t I, class... C, class... Cs>
 struct QueryStorage<I, Any<C...>, Cs...> : QueryStorage<AJUtility<I, 1, C...>::LAST_INDEX, Cs...> {
 	AJUtility<I, 1, C...> sub_storages;
 
-	EntityList entities;
+	EntityBitList entities;
+	/// The version of the sub storages `entities` is built from, or
+	/// `UINT64_MAX` when it has to be rebuilt.
+	uint64_t entities_version = UINT64_MAX;
 
 	QueryStorage(World *p_world) :
 			QueryStorage<AJUtility<I, 1, C...>::LAST_INDEX, Cs...>(p_world),
@@ -1126,12 +1459,17 @@ struct QueryStorage<I, Any<C...>, Cs...> : QueryStorage<AJUtility<I, 1, C...>::L
 		QueryStorage<AJUtility<I, 1, C...>::LAST_INDEX, Cs...>::initiate_process(p_world);
 		sub_storages.initiate_process(p_world);
 
-		entities.clear();
-		// TODO Can we cache this somehow?
-		// 	track of the biggest `EntityID` it has.
-		// 	So the `entities` list we have here could be prepared, and a lot of
-		// 	reallocation can be avoided.
-		sub_storages.get_entities(entities);
+		// The union is rebuilt only when the `Entities` of the sub storages
+		// change. The memory is kept between runs, and both the clear and the
+		// rebuild cost as much as the inserted `Entities`.
+		uint64_t version = 0;
+		const bool tracked = sub_storages.get_entities_version(version);
+		if (tracked == false || version != entities_version) {
+			entities.clear();
+			entities.reserve(p_world->get_entity_index_limit());
+			sub_storages.get_entities(entities);
+			entities_version = tracked ? version : UINT64_MAX;
+		}
 	}
 
 	void conclude_process(World *p_world) {
@@ -1157,6 +1495,10 @@ struct QueryStorage<I, Any<C...>, Cs...> : QueryStorage<AJUtility<I, 1, C...>::L
 		}
 	}
 
+	bool get_entities_version(uint64_t &r_version) const {
+		return sub_storages.get_entities_version(r_version);
+	}
+
 	bool filter_satisfied(EntityID p_entity) const {
 		// Just check if we have this entity.
 		if constexpr (AJUtility<I, 1, C...>::all_determinant()) {
@@ -1206,7 +1548,10 @@ template <std::size_t I, class... C, class... Cs>
 struct QueryStorage<I, Join<C...>, Cs...> : QueryStorage<I + 1, Cs...> {
 	AJUtility<0, 0, C...> sub_storages;
 
-	EntityList entities;
+	EntityBitList entities;
+	/// The version of the sub storages `entities` is built from, or
+	/// `UINT64_MAX` when it has to be rebuilt.
+	uint64_t entities_version = UINT64_MAX;
 
 	QueryStorage(World *p_world) :
 			QueryStorage<I + 1, Cs...>(p_world),
@@ -1216,12 +1561,17 @@ struct QueryStorage<I, Join<C...>, Cs...> : QueryStorage<I + 1, Cs...> {
 		QueryStorage<I + 1, Cs...>::initiate_process(p_world);
 		sub_storages.initiate_process(p_world);
 
-		entities.clear();
-		// TODO Exist a way to cache this?
-		// 	track of the biggest `EntityID` it has.
-		// 	So the `entities` list we have here could be prepared, and a lot of
-		// 	reallocation can be avoided.
-		sub_storages.get_entities(entities);
+		// The union is rebuilt only when the `Entities` of the sub storages
+		// change. The memory is kept between runs, and both the clear and the
+		// rebuild cost as much as the inserted `Entities`.
+		uint64_t version = 0;
+		const bool tracked = sub_storages.get_entities_version(version);
+		if (tracked == false || version != entities_version) {
+			entities.clear();
+			entities.reserve(p_world->get_entity_index_limit());
+			sub_storages.get_entities(entities);
+			entities_version = tracked ? version : UINT64_MAX;
+		}
 	}
 
 	void conclude_process(World *p_world) {
@@ -1247,6 +1597,10 @@ struct QueryStorage<I, Join<C...>, Cs...> : QueryStorage<I + 1, Cs...> {
 		}
 	}
 
+	bool get_entities_version(uint64_t &r_version) const {
+		return sub_storages.get_entities_version(r_version);
+	}
+
 	bool filter_satisfied(EntityID p_entity) const {
 		// Just check if we have this entity.
 		if constexpr (AJUtility<0, 0, C...>::all_determinant()) {
@@ -1290,7 +1644,13 @@ struct QueryStorage<I, Join<C...>, Cs...> : QueryStorage<I + 1, Cs...> {
 /// `QueryStorage` no filter specialization.
 template <std::size_t I, class C, class... Cs>
 struct QueryStorage<I, C, Cs...> : QueryStorage<I + 1, Cs...> {
+	/// The storage class, when it's known at compile time.
+	typedef typename godex_component_storage<C>::type StaticStorage;
+
 	Storage<C> *storage = nullptr;
+	/// `true` when `storage` is exactly a `StaticStorage`, so the calls can
+	/// be devirtualized.
+	bool is_static_storage = false;
 
 	QueryStorage(World *p_world) :
 			QueryStorage<I + 1, Cs...>(p_world) {}
@@ -1298,11 +1658,15 @@ struct QueryStorage<I, C, Cs...> : QueryStorage<I + 1, Cs...> {
 	void initiate_process(World *p_world) {
 		QueryStorage<I + 1, Cs...>::initiate_process(p_world);
 		storage = p_world->get_storage<C>();
+		if constexpr (std::is_void<StaticStorage>::value == false) {
+			is_static_storage = storage != nullptr && typeid(*static_cast<StorageBase *>(storage)) == typeid(StaticStorage);
+		}
 	}
 
 	void conclude_process(World *p_world) {
 		QueryStorage<I + 1, Cs...>::conclude_process(p_world);
 		storage = nullptr;
+		is_static_storage = false;
 	}
 
 	void set_world_notification_active(bool p_active) {
@@ -1325,17 +1689,28 @@ struct QueryStorage<I, C, Cs...> : QueryStorage<I + 1, Cs...> {
 		return entities.count < o_entities.count ? entities : o_entities;
 	}
 
+	bool get_entities_version(uint64_t &r_version) const {
+		if (storage != nullptr) {
+			const uint64_t version = storage->get_entities_version();
+			if (version == 0) {
+				return false;
+			}
+			r_version += version;
+		}
+		return QueryStorage<I + 1, Cs...>::get_entities_version(r_version);
+	}
+
 	bool filter_satisfied(EntityID p_entity) const {
 		if (unlikely(storage == nullptr)) {
 			// This is a required field, since there is no storage this can end
 			// immediately.
 			return false;
 		}
-		return storage->has(p_entity) && QueryStorage<I + 1, Cs...>::filter_satisfied(p_entity);
+		return storage_has(p_entity) && QueryStorage<I + 1, Cs...>::filter_satisfied(p_entity);
 	}
 
 	bool can_fetch(EntityID p_entity) const {
-		return storage && storage->has(p_entity);
+		return storage && storage_has(p_entity);
 	}
 
 	template <class... Qs>
@@ -1346,6 +1721,19 @@ struct QueryStorage<I, C, Cs...> : QueryStorage<I + 1, Cs...> {
 #endif
 
 		// Set the `Component` inside th tuple.
+		if constexpr (std::is_void<StaticStorage>::value == false) {
+			if (likely(is_static_storage)) {
+				// Qualified call, so the compiler can inline it.
+				if constexpr (std::is_const<C>::value) {
+					set<I>(r_result, static_cast<const StaticStorage *>(static_cast<const StorageBase *>(storage))->StaticStorage::get(p_id, p_mode));
+				} else {
+					set<I>(r_result, static_cast<StaticStorage *>(static_cast<StorageBase *>(storage))->StaticStorage::get(p_id, p_mode));
+				}
+				QueryStorage<I + 1, Cs...>::fetch(p_id, p_mode, r_result);
+				return;
+			}
+		}
+
 		if constexpr (std::is_const<C>::value) {
 			set<I>(r_result, const_cast<const Storage<C> *>(storage)->get(p_id, p_mode));
 		} else {
@@ -1356,6 +1744,21 @@ struct QueryStorage<I, C, Cs...> : QueryStorage<I + 1, Cs...> {
 		QueryStorage<I + 1, Cs...>::fetch(p_id, p_mode, r_result);
 	}
 
+	/// Fetch the component directly from the packed chunk column: an
+	/// `ArchetypeTable` chunk or the packed range of a `DenseGroup`.
+	template <class... Qs>
+	void fetch_archetype(void *const *p_columns, uint32_t p_row, EntityID p_id, QueryResultTuple<Qs...> &r_result) const {
+		if constexpr (std::is_const<C>::value) {
+			set<I>(r_result, static_cast<const C *>(p_columns[I]) + p_row);
+		} else {
+			storage->notify_changed(p_id);
+			set<I>(r_result, static_cast<C *>(p_columns[I]) + p_row);
+		}
+
+		// Keep going.
+		QueryStorage<I + 1, Cs...>::fetch_archetype(p_columns, p_row, p_id, r_result);
+	}
+
 	auto get_inner_storage() const {
 		return storage;
 	}
@@ -1368,6 +1771,157 @@ struct QueryStorage<I, C, Cs...> : QueryStorage<I + 1, Cs...> {
 		}
 		QueryStorage<I + 1, Cs...>::get_components(r_info);
 	}
+
+private:
+	_FORCE_INLINE_ bool storage_has(EntityID p_entity) const {
+		if constexpr (std::is_void<StaticStorage>::value == false) {
+			if (likely(is_static_storage)) {
+				// Qualified call, so the compiler can inline it.
+				return static_cast<const StaticStorage *>(static_cast<const StorageBase *>(storage))->StaticStorage::has(p_entity);
+			}
+		}
+		return storage->has(p_entity);
+	}
+};
+
+// ------------------------------------------------------------ Archetype utils
+
+/// `true` when all the elements are `EntityID` or components stored using the
+/// `ArchetypeStorage`.
+template <class... Cs>
+struct query_is_archetype_compatible : std::true_type {};
+
+template <class C, class... Cs>
+struct query_is_archetype_compatible<C, Cs...> : std::integral_constant<bool,
+														 (std::is_same<C, EntityID>::value || godex_is_archetype_component<C>::value) &&
+																 query_is_archetype_compatible<Cs...>::value> {};
+
+/// `true` when all the elements are `EntityID` or components stored using a
+/// storage that can be part of a `DenseGroup`.
+template <class... Cs>
+struct query_is_group_compatible : std::true_type {};
+
+template <class C, class... Cs>
+struct query_is_group_compatible<C, Cs...> : std::integral_constant<bool,
+													 (std::is_same<C, EntityID>::value || godex_is_group_component<C>::value) &&
+															 query_is_group_compatible<Cs...>::value> {};
+
+/// `true` when the element, or one of its sub filters, is a `Changed`,
+/// `Added` or `Removed` filter: these depend on the change ticks.
+template <class C>
+struct query_has_changed_filter : std::false_type {};
+
+template <class C>
+struct query_has_changed_filter<Changed<C>> : std::true_type {};
+
+template <class C>
+struct query_has_changed_filter<Added<C>> : std::true_type {};
+
+template <class C>
+struct query_has_changed_filter<Removed<C>> : std::true_type {};
+
+template <template <class...> class F, class... Cs>
+struct query_has_changed_filter<F<Cs...>> : std::integral_constant<bool, (query_has_changed_filter<Cs>::value || ...)> {};
+
+/// Returns the component id or `UINT32_MAX` for the `EntityID`.
+template <class C>
+godex::component_id query_archetype_component_id() {
+	if constexpr (std::is_same<C, EntityID>::value) {
+		return UINT32_MAX;
+	} else {
+		return std::remove_const_t<C>::get_component_id();
+	}
+}
+
+/// `true` when `Query::for_each_chunk` can fetch this element as a contiguous
+/// array: the `EntityID`, a component, or the `Changed` and `Added` filters
+/// of a component. The other filters may fetch nothing for an `Entity`.
+template <class C>
+struct query_is_chunk_compatible : std::true_type {};
+
+template <class C>
+struct query_is_chunk_compatible<Changed<C>> : query_is_chunk_compatible<C> {};
+
+template <class C>
+struct query_is_chunk_compatible<Added<C>> : query_is_chunk_compatible<C> {};
+
+template <template <class...> class F, class... Cs>
+struct query_is_chunk_compatible<F<Cs...>> : std::false_type {};
+
+/// `true` when `Query::par_for_each` can fetch this element from many
+/// threads at once: the `Create` filter inserts the component while fetching,
+/// so it's rejected even when nested in another filter.
+template <class C>
+struct query_is_par_compatible : std::true_type {};
+
+template <class C>
+struct query_is_par_compatible<Create<C>> : std::false_type {};
+
+template <template <class...> class F, class... Cs>
+struct query_is_par_compatible<F<Cs...>> : std::bool_constant<(query_is_par_compatible<Cs>::value && ...)> {};
+
+/// The value stored by `Query::for_each_chunk` when it gathers this element.
+template <class C>
+struct query_chunk_value {
+	using type = std::remove_const_t<C>;
+};
+
+template <class C>
+struct query_chunk_value<Changed<C>> : query_chunk_value<C> {};
+
+template <class C>
+struct query_chunk_value<Added<C>> : query_chunk_value<C> {};
+
+/// A range of `Entities` fetched by `Query::for_each_chunk`: each element of
+/// the `Query` is a contiguous array of `get_count` components, in the order
+/// of `get_entities`. So the loops on it can be vectorized:
+/// ```
+/// query.for_each_chunk([](ChunkView<TransformComponent, const Velocity> &p_chunk) {
+/// 	TransformComponent *transforms = p_chunk.get<0>();
+/// 	const Velocity *velocities = p_chunk.get<1>();
+/// 	for (uint32_t i = 0; i < p_chunk.get_count(); i += 1) {
+/// 		transforms[i].origin += velocities[i].linear;
+/// 	}
+/// });
+/// ```
+/// The `EntityID` element is the `get_entities` array.
+template <class... Cs>
+class ChunkView {
+	template <class... Qs>
+	friend class Query;
+
+	const EntityID *entities = nullptr;
+	uint32_t count = 0;
+	/// The array of each element, `nullptr` for the `EntityID`.
+	void *columns[sizeof...(Cs)];
+	bool gathered = false;
+
+public:
+	uint32_t get_count() const {
+		return count;
+	}
+
+	const EntityID *get_entities() const {
+		return entities;
+	}
+
+	/// Returns `true` when the components are copies gathered into a scratch
+	/// buffer, rather than the storage memory: the mutable ones are written
+	/// back once the callback returns.
+	bool is_gathered() const {
+		return gathered;
+	}
+
+	/// Returns the array of the element `I`.
+	template <std::size_t I>
+	auto get() const {
+		using T = fetch_element_type<I, 0, Cs...>;
+		if constexpr (std::is_same<T, EntityID>::value) {
+			return entities;
+		} else {
+			return static_cast<T>(columns[I]);
+		}
+	}
 };
 
 /// This is the fastest `Query`.
@@ -1379,21 +1933,102 @@ class Query {
 	/// Fetch space.
 	Space m_space = LOCAL;
 
+	/// A packed range of `Entities` that satisfies this `Query`: a chunk of
+	/// an `Archetype` or the packed range of a `DenseGroup`.
+	struct PackedChunk {
+		const EntityID *entities = nullptr;
+		uint32_t count = 0;
+		/// The column of each element, `nullptr` for the `EntityID`.
+		void *columns[sizeof...(Cs)];
+	};
+
+	/// A range of `Entities` processed by a task of `par_for_each`.
+	struct ParallelRange {
+		const EntityID *entities = nullptr;
+		uint32_t count = 0;
+		/// The `PackedChunk` index, or `UINT32_MAX` when the range is taken
+		/// from the `entities` buffer.
+		uint32_t chunk = UINT32_MAX;
+		/// The row of the first `Entity` into the `PackedChunk`.
+		uint32_t row = 0;
+	};
+
+	template <class F>
+	struct ParallelTask {
+		Query<Cs...> *query = nullptr;
+		F *func = nullptr;
+		/// The fetched `Entities` of each not packed range, marked as changed
+		/// once all the tasks are done. `nullptr` when nothing is mutable.
+		LocalVector<EntityID> *fetched = nullptr;
+	};
+
+	World *world = nullptr;
+
+	/// `true` when the cached mode is requested, check `set_cached`.
+	bool cached = false;
+	/// All the components used by this `Query`, notifying the cache.
+	LocalVector<godex::component_id> cache_components;
+	QueryMatchCache *match_cache = nullptr;
+	/// The matches of `match_cache`, copied by this `Query` since the cache
+	/// is shared.
+	LocalVector<EntityID> cached_matches;
+
 	/// List of entities to check.
 	EntitiesBuffer entities = EntitiesBuffer(0, nullptr);
 
+	ArchetypeTable *archetype_table = nullptr;
+	/// The group that has exactly the fetched components, if any.
+	const DenseGroup *group = nullptr;
+	LocalVector<PackedChunk> packed_chunks;
+	LocalVector<ParallelRange> parallel_ranges;
+	/// The `Entities` gathered by `for_each_chunk`, with their fetched data.
+	LocalVector<EntityID> chunk_entities;
+	LocalVector<QueryResultTuple<Cs...>> chunk_fetched;
+	/// The scratch buffer of each element, used by `for_each_chunk`.
+	std::tuple<LocalVector<typename query_chunk_value<Cs>::type>...> chunk_scratch;
+
 	// Storages
 	QueryStorage<0, Cs...> q;
 
 public:
+	/// When all the fetched components use the `ArchetypeStorage` the `Query`
+	/// iterates the `ArchetypeTable` chunks linearly, without any lookup.
+	static constexpr bool ARCHETYPE_MODE =
+			query_is_archetype_compatible<Cs...>::value &&
+			(!std::is_same<Cs, EntityID>::value || ...);
+
+	/// When all the fetched components use the `DenseVectorStorage` and are
+	/// part of the same `DenseGroup` (check `World::create_group`), the
+	/// `Query` iterates the packed range of the group linearly, without any
+	/// lookup. This is detected at runtime.
+	static constexpr bool GROUP_MODE =
+			!ARCHETYPE_MODE &&
+			query_is_group_compatible<Cs...>::value &&
+			(!std::is_same<Cs, EntityID>::value || ...);
+
+	/// `true` when the `ARCHETYPE_MODE` or the `GROUP_MODE` can be used.
+	static constexpr bool PACKED_MODE = ARCHETYPE_MODE || GROUP_MODE;
+
+	/// The `Changed`, `Added` and `Removed` filters depend on the change
+	/// ticks, that don't notify the cache: so these `Query`s can't be cached.
+	static constexpr bool HAS_CHANGED_FILTER = (query_has_changed_filter<Cs>::value || ...);
+
 	Query(World *p_world) :
 			q(p_world) {
 	}
 
 	void initiate_process(World *p_world) {
 		m_space = LOCAL;
+		world = p_world;
 		q.initiate_process(p_world);
 
+		if constexpr (ARCHETYPE_MODE) {
+			archetype_table = p_world->get_archetype_table();
+		} else if constexpr (GROUP_MODE) {
+			const godex::component_id ids[] = { query_archetype_component_id<Cs>()... };
+			group = p_world->get_group(ids, sizeof...(Cs));
+		}
+
 		// Prepare the query:
 		// Ask all the pointed storage to return a list of entities to iterate;
 		// the query, takes the smallest one, and iterates over it.
@@ -1402,10 +2037,79 @@ public:
 			entities.count = 0;
 			ERR_PRINT("This query is not valid, you are using only non determinant fileters (like `Not` and `Maybe`).");
 		}
+
+		if constexpr (HAS_CHANGED_FILTER == false) {
+			if (cached && is_packed() == false) {
+				// Iterates only the matching `Entities`.
+				match_cache = p_world->get_query_cache(get_cache_key(), cache_components);
+				if (match_cache != nullptr) {
+					match_cache->update(
+							entities.entities,
+							entities.count,
+							[&](EntityID p_entity) -> bool {
+								return q.filter_satisfied(p_entity);
+							},
+							cached_matches);
+					entities = EntitiesBuffer(cached_matches.size(), cached_matches.ptr());
+				}
+			}
+		}
 	}
 
 	void conclude_process(World *p_world) {
 		q.conclude_process(p_world);
+		world = nullptr;
+		match_cache = nullptr;
+		archetype_table = nullptr;
+		group = nullptr;
+		packed_chunks.clear();
+		parallel_ranges.clear();
+		chunk_entities.clear();
+		chunk_fetched.clear();
+	}
+
+	/// Returns `true` when this `Query` is iterating packed ranges, check
+	/// `ARCHETYPE_MODE` and `GROUP_MODE`.
+	bool is_packed() const {
+		if constexpr (ARCHETYPE_MODE) {
+			return true;
+		} else if constexpr (GROUP_MODE) {
+			return group != nullptr;
+		} else {
+			return false;
+		}
+	}
+
+	/// Enables the cached mode, used by the next `initiate_process`.
+	/// The `World` keeps the list of the `Entities` that satisfy this
+	/// `Query`, and updates it when a storage used by this `Query` inserts or
+	/// removes a component: the `Query` iterates only the matching
+	/// `Entities`, rather than testing all the `Entities` of the smallest
+	/// storage each time. Use it when few `Entities` match, like with
+	/// `Query<A, Not<Disabled>, B>`.
+	///
+	/// The cache is shared by all the `Query`s of the same type, and the
+	/// `Entities` are not iterated in storage order. It's not used when the
+	/// `Query` is packed, has a `Changed`, `Added` or `Removed` filter, or
+	/// when a storage doesn't track its `Entities`.
+	void set_cached(bool p_cached) {
+		cached = p_cached;
+		cache_components.clear();
+		if (cached) {
+			SystemExeInfo info;
+			get_components(info);
+			for (const uint32_t &id : info.mutable_components) {
+				cache_components.push_back(id);
+			}
+			for (const uint32_t &id : info.immutable_components) {
+				cache_components.push_back(id);
+			}
+		}
+	}
+
+	/// Returns `true` when this `Query` iterates the cached `Entities`.
+	bool is_cached() const {
+		return match_cache != nullptr;
 	}
 
 	void set_world_notification_active(bool p_active) {
@@ -1417,8 +2121,8 @@ public:
 		using difference_type = std::ptrdiff_t;
 		using value_type = QueryResultTuple<Cs...>;
 
-		Iterator(Query<Cs...> *p_query, const EntityID *p_entity) :
-				query(p_query), entity(p_entity) {}
+		Iterator(Query<Cs...> *p_query, const EntityID *p_entity, uint32_t p_chunk = 0) :
+				query(p_query), entity(p_entity), chunk(p_chunk) {}
 
 		bool is_valid() const {
 			return *this != query->end();
@@ -1430,11 +2134,29 @@ public:
 
 		value_type operator*() const {
 			QueryResultTuple<Cs...> result;
+			if constexpr (PACKED_MODE) {
+				if (query->is_packed()) {
+					const PackedChunk &c = query->packed_chunks[chunk];
+					query->q.fetch_archetype(c.columns, uint32_t(entity - c.entities), *entity, result);
+					return result;
+				}
+			}
 			query->q.fetch(*entity, query->m_space, result);
 			return result;
 		}
 
 		Iterator &operator++() {
+			if constexpr (PACKED_MODE) {
+				if (query->is_packed()) {
+					entity += 1;
+					if (entity == query->packed_chunks[chunk].entities + query->packed_chunks[chunk].count) {
+						// Move to the next chunk.
+						chunk += 1;
+						entity = chunk < query->packed_chunks.size() ? query->packed_chunks[chunk].entities : nullptr;
+					}
+					return *this;
+				}
+			}
 			entity = query->next_valid_entity(entity);
 			return *this;
 		}
@@ -1445,12 +2167,14 @@ public:
 			return tmp;
 		}
 
-		friend bool operator==(const Iterator &a, const Iterator &b) { return a.entity == b.entity; }
-		friend bool operator!=(const Iterator &a, const Iterator &b) { return a.entity != b.entity; }
+		friend bool operator==(const Iterator &a, const Iterator &b) { return a.entity == b.entity && a.chunk == b.chunk; }
+		friend bool operator!=(const Iterator &a, const Iterator &b) { return a.entity != b.entity || a.chunk != b.chunk; }
 
 	private:
 		Query<Cs...> *query;
 		const EntityID *entity;
+		/// The `PackedChunk` index, used only when the `Query` is packed.
+		uint32_t chunk;
 	};
 
 	/// Allow to specify the space you want to fetch the data, you can use this
@@ -1478,9 +2202,21 @@ public:
 	/// }
 	/// ```
 	Iterator begin() {
+		if constexpr (PACKED_MODE) {
+			if (is_packed()) {
+				// Collects the chunks now, so the `Iterator` always sees the
+				// current state of the storages.
+				fetch_packed_chunks();
+				if (packed_chunks.size() == 0) {
+					return end();
+				}
+				return Iterator(this, packed_chunks[0].entities, 0);
+			}
+		}
+
 		// Returns the next available Entity.
 		if (entities.count > 0) {
-			if (q.filter_satisfied(*entities.entities) == false) {
+			if (is_match(*entities.entities) == false) {
 				return Iterator(this, next_valid_entity(entities.entities));
 			}
 		}
@@ -1489,6 +2225,11 @@ public:
 
 	/// Used to know the last element of the `Iterator`.
 	Iterator end() {
+		if constexpr (PACKED_MODE) {
+			if (is_packed()) {
+				return Iterator(this, nullptr, packed_chunks.size());
+			}
+		}
 		return Iterator(this, entities.entities + entities.count);
 	}
 
@@ -1528,17 +2269,395 @@ public:
 		return count;
 	}
 
+	/// Calls `p_func` for each `Entity` that meets the requirements of this
+	/// `Query`, using the threads of the `WorkerThreadPool`. Returns once all
+	/// the `Entities` are processed.
+	/// ```
+	/// query.par_for_each([](QueryResultTuple<TransformComponent, const Velocity> p_result) {
+	/// 	auto [transform, velocity] = p_result;
+	/// 	// ...
+	/// });
+	/// ```
+	/// The `Entities` to check are split in ranges of `p_grain_size`, and each
+	/// range is processed by a single task. `p_threads` limits the amount of
+	/// threads used, `-1` uses all the threads of the pool.
+	///
+	/// IMPORTANT: `p_func` is called by many threads at once, so it must
+	/// only access the components it receives. The changes are marked once
+	/// all the tasks are done: all the mutable components of the fetched
+	/// `Entities` are marked as changed.
+	/// The fetch must not change the storages, so the `Create` filter is not
+	/// supported: use the iterator instead.
+	template <class F>
+	void par_for_each(F p_func, uint32_t p_grain_size = 1024, int p_threads = -1) {
+		static_assert((query_is_par_compatible<Cs>::value && ...), "`par_for_each` doesn't support the `Create` filter, since it inserts the component while fetching: use the iterator.");
+		ERR_FAIL_COND_MSG(world == nullptr, "The `Query` is not initiated, call `initiate_process` first.");
+		p_grain_size = MAX(p_grain_size, 1u);
+
+		parallel_ranges.clear();
+		bool packed_ranges = false;
+		if constexpr (PACKED_MODE) {
+			if (is_packed()) {
+				packed_ranges = true;
+				fetch_packed_chunks();
+				for (uint32_t c = 0; c < packed_chunks.size(); c += 1) {
+					for (uint32_t row = 0; row < packed_chunks[c].count; row += p_grain_size) {
+						ParallelRange range;
+						range.entities = packed_chunks[c].entities + row;
+						range.count = MIN(p_grain_size, packed_chunks[c].count - row);
+						range.chunk = c;
+						range.row = row;
+						parallel_ranges.push_back(range);
+					}
+				}
+			}
+		}
+		if (packed_ranges == false) {
+			for (uint32_t i = 0; i < entities.count; i += p_grain_size) {
+				ParallelRange range;
+				range.entities = entities.entities + i;
+				range.count = MIN(p_grain_size, entities.count - i);
+				parallel_ranges.push_back(range);
+			}
+		}
+
+		if (parallel_ranges.size() == 0) {
+			return;
+		}
+
+		// The storages written by this `Query`.
+		SystemExeInfo info;
+		get_components(info);
+		LocalVector<StorageBase *> mutable_storages;
+		for (const uint32_t &id : info.mutable_components) {
+			StorageBase *storage = world->get_storage(id);
+			if (storage != nullptr && storage->is_changes_deferred() == false) {
+				storage->set_changes_deferred(true);
+				mutable_storages.push_back(storage);
+			}
+		}
+
+		LocalVector<LocalVector<EntityID>> fetched;
+		if (mutable_storages.size() > 0) {
+			fetched.resize(parallel_ranges.size());
+		}
+
+		ParallelTask<F> task;
+		task.query = this;
+		task.func = &p_func;
+		task.fetched = fetched.size() > 0 ? fetched.ptr() : nullptr;
+
+		if (parallel_ranges.size() == 1 || p_threads == 1) {
+			// Not worth to wake up the threads.
+			for (uint32_t i = 0; i < parallel_ranges.size(); i += 1) {
+				process_parallel_range<F>(&task, i);
+			}
+		} else {
+			WorkerThreadPool::GroupID group_id = WorkerThreadPool::get_singleton()->add_native_group_task(
+					&Query<Cs...>::process_parallel_range<F>,
+					&task,
+					parallel_ranges.size(),
+					p_threads,
+					true,
+					"Query::par_for_each");
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+		}
+
+		// All the tasks are done, mark the changes from this thread.
+		for (uint32_t s = 0; s < mutable_storages.size(); s += 1) {
+			StorageBase *storage = mutable_storages[s];
+			storage->set_changes_deferred(false);
+			for (uint32_t i = 0; i < parallel_ranges.size(); i += 1) {
+				if (parallel_ranges[i].chunk != UINT32_MAX) {
+					// The packed chunks contain only `Entities` with all the
+					// components.
+					storage->notify_deferred_changed(parallel_ranges[i].entities, parallel_ranges[i].count);
+				} else {
+					for (uint32_t e = 0; e < fetched[i].size(); e += 1) {
+						// The `Entity` may not have it, like with `Maybe`.
+						if (storage->has(fetched[i][e])) {
+							storage->notify_deferred_changed(&fetched[i][e], 1);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/// Calls `p_func` for each chunk of the `Entities` that meet the
+	/// requirements of this `Query`, check `ChunkView`.
+	///
+	/// When the `Query` is packed (check `ARCHETYPE_MODE` and `GROUP_MODE`),
+	/// or all its components are taken from the same `DenseVectorStorage`,
+	/// the chunks point directly to the storage memory. Otherwise the
+	/// components of up to `p_chunk_size` `Entities` are copied into a
+	/// scratch buffer, and the mutable ones are copied back once `p_func`
+	/// returns.
+	/// All the mutable components of the fetched `Entities` are marked as
+	/// changed.
+	template <class F>
+	void for_each_chunk(F p_func, uint32_t p_chunk_size = 256) {
+		static_assert((query_is_chunk_compatible<Cs>::value && ...), "`for_each_chunk` supports only the components, the `EntityID`, and the `Changed` and `Added` filters.");
+		ERR_FAIL_COND_MSG(world == nullptr, "The `Query` is not initiated, call `initiate_process` first.");
+
+		ChunkView<Cs...> view;
+
+		if constexpr (PACKED_MODE) {
+			if (is_packed()) {
+				// The storages written by this `Query`.
+				SystemExeInfo info;
+				get_components(info);
+				LocalVector<StorageBase *> mutable_storages;
+				for (const uint32_t &id : info.mutable_components) {
+					StorageBase *storage = world->get_storage(id);
+					if (storage != nullptr) {
+						mutable_storages.push_back(storage);
+					}
+				}
+
+				fetch_packed_chunks();
+				for (uint32_t c = 0; c < packed_chunks.size(); c += 1) {
+					view.entities = packed_chunks[c].entities;
+					view.count = packed_chunks[c].count;
+					for (uint32_t i = 0; i < sizeof...(Cs); i += 1) {
+						view.columns[i] = packed_chunks[c].columns[i];
+					}
+					for (uint32_t s = 0; s < mutable_storages.size(); s += 1) {
+						mutable_storages[s]->notify_changed(view.entities, view.count);
+					}
+					p_func(view);
+				}
+				return;
+			}
+		}
+
+		if constexpr (GROUP_MODE) {
+			DenseGroupStorage *dense_storage = get_single_dense_storage();
+			if (dense_storage != nullptr) {
+				// The whole storage is a single chunk, already in the order
+				// of the `Entities`.
+				if (entities.count == 0) {
+					return;
+				}
+				view.entities = entities.entities;
+				view.count = entities.count;
+				const godex::component_id ids[] = { query_archetype_component_id<Cs>()... };
+				for (uint32_t i = 0; i < sizeof...(Cs); i += 1) {
+					view.columns[i] = ids[i] == UINT32_MAX ? nullptr : dense_storage->group_get_data();
+				}
+				SystemExeInfo info;
+				get_components(info);
+				for (const uint32_t &id : info.mutable_components) {
+					world->get_storage(id)->notify_changed(view.entities, view.count);
+				}
+				p_func(view);
+				return;
+			}
+		}
+
+		p_chunk_size = MAX(p_chunk_size, 1u);
+		view.gathered = true;
+		uint32_t index = 0;
+		while (index < entities.count) {
+			chunk_entities.clear();
+			chunk_fetched.clear();
+			for (; index < entities.count && chunk_entities.size() < p_chunk_size; index += 1) {
+				const EntityID entity = entities.entities[index];
+				if (is_match(entity)) {
+					QueryResultTuple<Cs...> result;
+					q.fetch(entity, m_space, result);
+					chunk_entities.push_back(entity);
+					chunk_fetched.push_back(result);
+				}
+			}
+			if (chunk_entities.size() == 0) {
+				break;
+			}
+
+			view.entities = chunk_entities.ptr();
+			view.count = chunk_entities.size();
+			gather_chunk(view, std::index_sequence_for<Cs...>());
+			p_func(view);
+			scatter_chunk(std::index_sequence_for<Cs...>());
+		}
+	}
+
 	static void get_components(SystemExeInfo &r_info) {
 		QueryStorage<0, Cs...>::get_components(r_info);
 	}
 
+	/// Identifies the `QueryMatchCache` shared by the `Query`s of this type.
+	static uint64_t get_cache_key() {
+		return typeid(Query<Cs...>).hash_code();
+	}
+
 private:
+	/// Returns the storage of the fetched components when they are all the
+	/// same component, and the `Entities` to check are the ones of its
+	/// storage: so its data is already in the `Entities` order. `nullptr`
+	/// otherwise, like when the `Query` is cached.
+	DenseGroupStorage *get_single_dense_storage() const {
+		const godex::component_id ids[] = { query_archetype_component_id<Cs>()... };
+		godex::component_id component = UINT32_MAX;
+		for (uint32_t i = 0; i < sizeof...(Cs); i += 1) {
+			if (ids[i] == UINT32_MAX) {
+				// This is the `EntityID`.
+				continue;
+			}
+			if (component != UINT32_MAX && component != ids[i]) {
+				return nullptr;
+			}
+			component = ids[i];
+		}
+
+		DenseGroupStorage *storage = dynamic_cast<DenseGroupStorage *>(world->get_storage(component));
+		if (storage == nullptr ||
+				storage->group_get_entities() != entities.entities ||
+				storage->group_get_count() != entities.count) {
+			return nullptr;
+		}
+		return storage;
+	}
+
+	template <std::size_t... Is>
+	void gather_chunk(ChunkView<Cs...> &r_view, std::index_sequence<Is...>) {
+		(gather_chunk_element<Is>(r_view), ...);
+	}
+
+	/// Copies the element `I` of the fetched `Entities` into its scratch
+	/// buffer.
+	template <std::size_t I>
+	void gather_chunk_element(ChunkView<Cs...> &r_view) {
+		if constexpr (std::is_same<fetch_element_type<I, 0, Cs...>, EntityID>::value) {
+			r_view.columns[I] = nullptr;
+		} else {
+			auto &scratch = std::get<I>(chunk_scratch);
+			scratch.resize(chunk_fetched.size());
+			for (uint32_t i = 0; i < chunk_fetched.size(); i += 1) {
+				scratch[i] = *get<I>(chunk_fetched[i]);
+			}
+			r_view.columns[I] = scratch.ptr();
+		}
+	}
+
+	template <std::size_t... Is>
+	void scatter_chunk(std::index_sequence<Is...>) {
+		(scatter_chunk_element<Is>(), ...);
+	}
+
+	/// Copies the scratch buffer of the element `I` back to the storage,
+	/// when it's mutable.
+	template <std::size_t I>
+	void scatter_chunk_element() {
+		using T = fetch_element_type<I, 0, Cs...>;
+		if constexpr (std::is_pointer<T>::value && std::is_const<std::remove_pointer_t<T>>::value == false) {
+			const auto &scratch = std::get<I>(chunk_scratch);
+			for (uint32_t i = 0; i < chunk_fetched.size(); i += 1) {
+				*get<I>(chunk_fetched[i]) = scratch[i];
+			}
+		}
+	}
+
+	template <class F>
+	static void process_parallel_range(void *p_task, uint32_t p_index) {
+		ParallelTask<F> *task = static_cast<ParallelTask<F> *>(p_task);
+		Query<Cs...> *query = task->query;
+		const ParallelRange &range = query->parallel_ranges[p_index];
+
+		if constexpr (PACKED_MODE) {
+			if (range.chunk != UINT32_MAX) {
+				const PackedChunk &chunk = query->packed_chunks[range.chunk];
+				for (uint32_t i = 0; i < range.count; i += 1) {
+					QueryResultTuple<Cs...> result;
+					query->q.fetch_archetype(chunk.columns, range.row + i, range.entities[i], result);
+					(*task->func)(result);
+				}
+				return;
+			}
+		}
+
+		LocalVector<EntityID> *fetched = task->fetched ? task->fetched + p_index : nullptr;
+		for (uint32_t i = 0; i < range.count; i += 1) {
+			const EntityID entity = range.entities[i];
+			if (query->is_match(entity)) {
+				QueryResultTuple<Cs...> result;
+				query->q.fetch(entity, query->m_space, result);
+				(*task->func)(result);
+				if (fetched) {
+					fetched->push_back(entity);
+				}
+			}
+		}
+	}
+
+	void fetch_packed_chunks() {
+		packed_chunks.clear();
+		const godex::component_id ids[] = { query_archetype_component_id<Cs>()... };
+
+		if constexpr (GROUP_MODE) {
+			// The whole packed range of the group is a single chunk.
+			if (group->get_size() > 0) {
+				PackedChunk chunk;
+				chunk.entities = group->get_entities();
+				chunk.count = group->get_size();
+				for (uint32_t i = 0; i < sizeof...(Cs); i += 1) {
+					chunk.columns[i] = ids[i] == UINT32_MAX ? nullptr : group->get_data(ids[i]);
+				}
+				packed_chunks.push_back(chunk);
+			}
+			return;
+		}
+
+		if (unlikely(archetype_table == nullptr)) {
+			return;
+		}
+
+		int64_t columns[sizeof...(Cs)];
+
+		for (uint32_t a = 0; a < archetype_table->get_archetype_count(); a += 1) {
+			const Archetype *archetype = archetype_table->get_archetype(a);
+			if (archetype->count == 0) {
+				continue;
+			}
+
+			bool match = true;
+			for (uint32_t i = 0; i < sizeof...(Cs); i += 1) {
+				columns[i] = ids[i] == UINT32_MAX ? -1 : archetype->find_column(ids[i]);
+				if (ids[i] != UINT32_MAX && columns[i] == -1) {
+					match = false;
+					break;
+				}
+			}
+			if (match == false) {
+				continue;
+			}
+
+			for (uint32_t c = 0; c < archetype->chunks.size(); c += 1) {
+				PackedChunk chunk;
+				chunk.entities = archetype->get_entities(c);
+				chunk.count = archetype->chunks[c].count;
+				for (uint32_t i = 0; i < sizeof...(Cs); i += 1) {
+					chunk.columns[i] = columns[i] == -1 ? nullptr : archetype->get_column(c, columns[i]);
+				}
+				packed_chunks.push_back(chunk);
+			}
+		}
+	}
+
+	_FORCE_INLINE_ bool is_match(EntityID p_entity) const {
+		if (match_cache != nullptr) {
+			// The cache contains only the matching `Entities`.
+			return true;
+		}
+		return q.filter_satisfied(p_entity);
+	}
+
 	const EntityID *next_valid_entity(const EntityID *p_current) {
 		const EntityID *next = p_current + 1;
 
 		// Search the next valid entity.
 		for (; next != (entities.entities + entities.count); next += 1) {
-			if (q.filter_satisfied(*next)) {
+			if (is_match(*next)) {
 				// This is fine to return.
 				return next;
 			}
@@ -1548,3 +2667,28 @@ private:
 		return next;
 	}
 };
+
+/// A `Query` in cached mode, check `Query::set_cached`. It can be used as
+/// `System` argument:
+/// ```
+/// void my_system(CachedQuery<A, Not<Disabled>, B> &p_query) {
+/// 	for (auto [a, b] : p_query) {
+/// 		// ...
+/// 	}
+/// }
+/// ```
+template <class... Cs>
+class CachedQuery : public Query<Cs...> {
+public:
+	CachedQuery(World *p_world) :
+			Query<Cs...>(p_world) {
+		Query<Cs...>::set_cached(true);
+	}
+
+	/// The `QueryMatchCache` is updated by each `Query` of this type, so the
+	/// systems using it don't run in parallel.
+	static void get_components(SystemExeInfo &r_info) {
+		Query<Cs...>::get_components(r_info);
+		r_info.mutable_query_caches.insert(Query<Cs...>::get_cache_key());
+	}
+};
@@ -0,0 +1,117 @@
+#include "world_allocator.h"
+
+#include "core/string/ustring.h"
+
+WorldAllocator::~WorldAllocator() {
+	reset();
+}
+
+void WorldAllocator::configure(uint64_t p_budget, uint64_t p_slab_size) {
+	const uint64_t new_slab_size = MAX(get_block_size(p_slab_size), ALIGNMENT * 16);
+
+	lock.lock();
+	budget = p_budget;
+	// The blocks taken so far depend on the slab size: `free` tells the small
+	// blocks from the big ones using it, and the last slab is filled up to it.
+	const bool can_change_slab_size = reserved == 0;
+	if (can_change_slab_size) {
+		slab_size = new_slab_size;
+	}
+	lock.unlock();
+
+	ERR_FAIL_COND_MSG(can_change_slab_size == false && new_slab_size != slab_size, "The slab size can't change once the memory is allocated, call `reset` first. Only the budget is set.");
+}
+
+void *WorldAllocator::alloc(uint64_t p_size) {
+	const uint64_t size = get_block_size(p_size);
+	void *memory = nullptr;
+
+	lock.lock();
+
+	if (size > slab_size / 4) {
+		// Big block, taken directly from the system.
+		memory = memalloc(size);
+		big_blocks.push_back(memory);
+		reserved += size;
+	} else {
+		void **head = free_lists.lookup_ptr(size);
+		if (head != nullptr && *head != nullptr) {
+			// Reuse a released block.
+			memory = *head;
+			*head = *static_cast<void **>(memory);
+		} else {
+			if (slabs.size() == 0 || slab_offset + size > slab_size) {
+				slabs.push_back(static_cast<uint8_t *>(memalloc(slab_size)));
+				slab_offset = 0;
+				reserved += slab_size;
+			}
+			memory = slabs[slabs.size() - 1] + slab_offset;
+			slab_offset += size;
+		}
+	}
+
+	const bool was_over_budget = is_over_budget();
+	used += size;
+	peak_used = MAX(peak_used, used);
+	if (is_over_budget()) {
+		over_budget_count += 1;
+		if (was_over_budget == false) {
+			ERR_PRINT("The World memory budget of " + itos(budget) + " bytes is exceeded: " + itos(used) + " bytes are in use.");
+		}
+	}
+
+	lock.unlock();
+	return memory;
+}
+
+void WorldAllocator::free(void *p_memory, uint64_t p_size) {
+	if (p_memory == nullptr) {
+		return;
+	}
+	const uint64_t size = get_block_size(p_size);
+
+	lock.lock();
+
+	if (size > slab_size / 4) {
+		for (uint32_t i = 0; i < big_blocks.size(); i += 1) {
+			if (big_blocks[i] == p_memory) {
+				big_blocks.remove_at_unordered(i);
+				break;
+			}
+		}
+		memfree(p_memory);
+		reserved -= size;
+	} else {
+		// Keep it for the next allocation of the same size.
+		void **head = free_lists.lookup_ptr(size);
+		if (head != nullptr) {
+			*static_cast<void **>(p_memory) = *head;
+			*head = p_memory;
+		} else {
+			*static_cast<void **>(p_memory) = nullptr;
+			free_lists.set(size, p_memory);
+		}
+	}
+	used -= size;
+
+	lock.unlock();
+}
+
+void WorldAllocator::reset() {
+	lock.lock();
+	for (uint32_t i = 0; i < slabs.size(); i += 1) {
+		memfree(slabs[i]);
+	}
+	for (uint32_t i = 0; i < big_blocks.size(); i += 1) {
+		memfree(big_blocks[i]);
+	}
+	slabs.reset();
+	big_blocks.reset();
+	free_lists.clear();
+	slab_offset = 0;
+	used = 0;
+	peak_used = 0;
+	reserved = 0;
+	over_budget_count = 0;
+	lock.unlock();
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "core/os/memory.h"
+#include "core/os/spin_lock.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/oa_hash_map.h"
+
+/// The memory allocator of a `World`: the storages pages, the
+/// `ArchetypeTable` chunks and the `Pipeline` systems data are allocated
+/// from it.
+///
+/// The small blocks are carved out of big slabs, and the released blocks are
+/// kept into a free list per size: the storages allocate blocks of few
+/// sizes (their pages), so the released blocks are reused without touching
+/// the system allocator. The blocks bigger than a quarter of slab are
+/// allocated and released separately.
+/// All the memory is freed at once by `reset`, so destroying a `World` doesn't
+/// release its blocks one by one.
+///
+/// The budget is a hard limit on the bytes in use: the allocation that
+/// exceeds it is reported and counted. It's still done, since the storages
+/// can't recover from a failed allocation.
+///
+/// It's thread safe, since the systems that run in parallel may allocate.
+class WorldAllocator {
+public:
+	static constexpr uint64_t ALIGNMENT = 16;
+	static constexpr uint64_t DEFAULT_SLAB_SIZE = 256 * 1024;
+
+private:
+	SpinLock lock;
+	uint64_t slab_size = DEFAULT_SLAB_SIZE;
+	/// `0` means no budget.
+	uint64_t budget = 0;
+
+	LocalVector<uint8_t *> slabs;
+	/// The used bytes of the last slab.
+	uint64_t slab_offset = 0;
+	/// Block size -> first released block, each released block stores the
+	/// pointer to the next one.
+	OAHashMap<uint64_t, void *> free_lists;
+	LocalVector<void *> big_blocks;
+
+	/// Bytes in use.
+	uint64_t used = 0;
+	uint64_t peak_used = 0;
+	/// Bytes taken from the system, including the released blocks.
+	uint64_t reserved = 0;
+	uint32_t over_budget_count = 0;
+
+public:
+	WorldAllocator() = default;
+	WorldAllocator(const WorldAllocator &) = delete;
+	WorldAllocator &operator=(const WorldAllocator &) = delete;
+	~WorldAllocator();
+
+	/// Sets the budget in bytes, `0` to disable it, and the size of the slabs.
+	/// The slab size can change only before the first allocation, or after
+	/// `reset`; the budget at any time.
+	void configure(uint64_t p_budget, uint64_t p_slab_size = DEFAULT_SLAB_SIZE);
+
+	/// Returns a block of `p_size` bytes, aligned to `ALIGNMENT`.
+	void *alloc(uint64_t p_size);
+
+	/// Releases the block, `p_size` must be the size used to allocate it.
+	void free(void *p_memory, uint64_t p_size);
+
+	/// Frees all the memory at once. The allocated blocks are invalid after
+	/// this call, so it must be called when nothing uses them anymore.
+	void reset();
+
+	uint64_t get_budget() const {
+		return budget;
+	}
+
+	/// Returns the bytes in use.
+	uint64_t get_used() const {
+		return used;
+	}
+
+	/// Returns the most bytes in use at once, since the last `reset`.
+	uint64_t get_peak_used() const {
+		return peak_used;
+	}
+
+	/// Returns the bytes taken from the system.
+	uint64_t get_reserved() const {
+		return reserved;
+	}
+
+	/// Returns the amount of allocations that exceeded the budget, since the
+	/// last `reset`.
+	uint32_t get_over_budget_count() const {
+		return over_budget_count;
+	}
+
+	bool is_over_budget() const {
+		return budget != 0 && used > budget;
+	}
+
+private:
+	static uint64_t get_block_size(uint64_t p_size) {
+		return (MAX(p_size, uint64_t(sizeof(void *))) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	}
+};
@@ -3,8 +3,8 @@
 #include "collision_object_bullet.h"
 
 void BtArea::_bind_methods() {
-	ECS_BIND_PROPERTY(BtArea, PropertyInfo(Variant::STRING, "enter_emitter_name", (PropertyHint)godex::PROPERTY_HINT_ECS_EVENT_EMITTER, "OverlapStart"), enter_emitter_name);
-	ECS_BIND_PROPERTY(BtArea, PropertyInfo(Variant::STRING, "exit_emitter_name", (PropertyHint)godex::PROPERTY_HINT_ECS_EVENT_EMITTER, "OverlapEnd"), exit_emitter_name);
+	ECS_BIND_PROPERTY_FUNC(BtArea, PropertyInfo(Variant::STRING, "enter_emitter_name", (PropertyHint)godex::PROPERTY_HINT_ECS_EVENT_EMITTER, "OverlapStart"), set_enter_emitter_name, get_enter_emitter_name);
+	ECS_BIND_PROPERTY_FUNC(BtArea, PropertyInfo(Variant::STRING, "exit_emitter_name", (PropertyHint)godex::PROPERTY_HINT_ECS_EVENT_EMITTER, "OverlapEnd"), set_exit_emitter_name, get_exit_emitter_name);
 	ECS_BIND_PROPERTY_FUNC(BtArea, PropertyInfo(Variant::INT, "layer", PROPERTY_HINT_LAYERS_3D_PHYSICS), set_layer, get_layer);
 	ECS_BIND_PROPERTY_FUNC(BtArea, PropertyInfo(Variant::INT, "mask", PROPERTY_HINT_LAYERS_3D_PHYSICS), set_mask, get_mask);
 }
@@ -57,6 +57,24 @@ uint32_t BtArea::get_mask() const {
 	return mask;
 }
 
+void BtArea::set_enter_emitter_name(const String &p_name) {
+	enter_emitter_name = p_name;
+	enter_emitter = godex::EMITTER_NONE;
+}
+
+const String &BtArea::get_enter_emitter_name() const {
+	return enter_emitter_name;
+}
+
+void BtArea::set_exit_emitter_name(const String &p_name) {
+	exit_emitter_name = p_name;
+	exit_emitter = godex::EMITTER_NONE;
+}
+
+const String &BtArea::get_exit_emitter_name() const {
+	return exit_emitter_name;
+}
+
 bool BtArea::need_body_reload() const {
 	return reload_flags & RELOAD_FLAGS_BODY;
 }
@@ -27,10 +27,15 @@ private:
 
 	uint32_t reload_flags = 0;
 
-public:
 	String enter_emitter_name;
 	String exit_emitter_name;
 
+public:
+	/// The resolved emitters, cached so the names are not looked up each
+	/// step: reset when the name changes. Check `bt_overlap_check`.
+	godex::EmitterId enter_emitter = godex::EMITTER_NONE;
+	godex::EmitterId exit_emitter = godex::EMITTER_NONE;
+
 	/// List of overlapping objects.
 	LocalVector<Overlap> overlaps;
 
@@ -57,6 +62,12 @@ public:
 	void set_mask(uint32_t p_mask);
 	uint32_t get_mask() const;
 
+	void set_enter_emitter_name(const String &p_name);
+	const String &get_enter_emitter_name() const;
+
+	void set_exit_emitter_name(const String &p_name);
+	const String &get_exit_emitter_name() const;
+
 	bool need_body_reload() const;
 	void reload_body(BtSpaceIndex p_index);
 
@@ -425,6 +425,17 @@ void bt_spaces_step(
 	}
 }
 
+/// Resolves the emitter into `r_emitter`, only when not yet resolved: it's
+/// `EMITTER_NONE` when the `Area` doesn't emit, or no systems are receiving
+/// from this emitter yet.
+template <class E>
+void resolve_emitter(const EventsEmitter<E> &p_emitter, const String &p_emitter_name, godex::EmitterId &r_emitter) {
+	if (likely(r_emitter != godex::EMITTER_NONE) || p_emitter_name.is_empty()) {
+		return;
+	}
+	r_emitter = p_emitter.get_emitter_id(p_emitter_name);
+}
+
 void bt_overlap_check(
 		const BtPhysicsSpaces *p_spaces,
 		BtCache *p_cache,
@@ -524,16 +535,19 @@ void bt_overlap_check(
 			}
 		}
 
+		// The emitters are resolved once and cached on the `Area`.
+		resolve_emitter(p_exit_event_emitter, area->get_exit_emitter_name(), area->exit_emitter);
+		const godex::EmitterId exit_emitter = area->exit_emitter;
 		for (int i = int(area->overlaps.size()) - 1; i >= 0; i -= 1) {
 			if (area->overlaps[i].detect_frame != frame_id) {
 				// This object is no more overlapping
 
-				if (area->exit_emitter_name.is_empty() == false) {
+				if (exit_emitter != godex::EMITTER_NONE) {
 					const EntityID other_entity = area->overlaps[i].object->getUserIndex3();
 					OverlapEnd e;
 					e.area = entity;
 					e.other_body = other_entity;
-					p_exit_event_emitter.emit(area->exit_emitter_name, e);
+					p_exit_event_emitter.emit(exit_emitter, e);
 				}
 
 				// Remove the object.
@@ -541,13 +555,15 @@ void bt_overlap_check(
 			}
 		}
 
-		if (area->enter_emitter_name.is_empty() == false) {
+		resolve_emitter(p_enter_event_emitter, area->get_enter_emitter_name(), area->enter_emitter);
+		const godex::EmitterId enter_emitter = area->enter_emitter;
+		if (enter_emitter != godex::EMITTER_NONE) {
 			for (uint32_t i = 0; i < new_overlaps.size(); i += 1) {
 				const EntityID other_entity = new_overlaps[i]->getUserIndex3();
 				OverlapStart e;
 				e.area = entity;
 				e.other_body = other_entity;
-				p_enter_event_emitter.emit(area->enter_emitter_name, e);
+				p_enter_event_emitter.emit(enter_emitter, e);
 			}
 		}
 
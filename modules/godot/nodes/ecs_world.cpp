@@ -219,6 +219,8 @@ void WorldECS::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_databag_by_name", "databag_name"), &WorldECS::get_databag_by_name);
 	ClassDB::bind_method(D_METHOD("get_databag", "databag_name"), &WorldECS::get_databag);
+
+	ClassDB::bind_method(D_METHOD("get_memory_report"), &WorldECS::get_memory_report);
 }
 
 bool WorldECS::_set(const StringName &p_name, const Variant &p_value) {
@@ -622,7 +624,7 @@ void WorldECS::unactive_world() {
 
 uint32_t WorldECS::create_entity() {
 	CRASH_COND_MSG(world == nullptr, "The world is never nullptr.");
-	return world->create_entity_index();
+	return world->create_entity_index().get_raw();
 }
 
 void WorldECS::destroy_entity(uint32_t p_entity_id) {
@@ -636,7 +638,7 @@ uint32_t WorldECS::create_entity_from_prefab(Object *p_entity) {
 	const Entity3D *entity = cast_to<Entity3D>(p_entity);
 	ERR_FAIL_COND_V_MSG(entity == nullptr, UINT32_MAX, "The passed object is not an `Entity` `Node`.");
 
-	return entity->_create_entity(world);
+	return entity->_create_entity(world).get_raw();
 }
 
 void WorldECS::add_component_by_name(uint32_t entity_id, const StringName &p_component_name, const Dictionary &p_data) {
@@ -707,6 +709,11 @@ Object *WorldECS::get_databag(uint32_t p_databag_id) {
 	return &databag_accessor;
 }
 
+Dictionary WorldECS::get_memory_report() const {
+	CRASH_COND_MSG(world == nullptr, "The world is never nullptr.");
+	return world->get_memory_report();
+}
+
 void WorldECS::clear_inputs() {
 	InputDatabag *input = world->get_databag<InputDatabag>();
 	if (likely(input)) {
@@ -178,6 +178,9 @@ public:
 	Object *get_databag_by_name(const StringName &p_databag_name);
 	Object *get_databag(uint32_t p_databag_id);
 
+	/// Returns the memory used by the storages, see `World::get_memory_report`.
+	Dictionary get_memory_report() const;
+
 	void pre_process();
 	void post_process();
 
@@ -175,7 +175,7 @@ public:
 		entity._notification(p_what);
 	}
 
-	uint32_t script_get_entity_id() const { return entity.entity_id; }
+	uint32_t script_get_entity_id() const { return entity.entity_id.get_raw(); }
 	EntityID get_entity_id() const { return entity.entity_id; }
 
 	void add_component(const StringName &p_component_name, const Dictionary &p_values) {
@@ -297,7 +297,7 @@ public:
 		entity._notification(p_what);
 	}
 
-	uint32_t script_get_entity_id() const { return entity.entity_id; }
+	uint32_t script_get_entity_id() const { return entity.entity_id.get_raw(); }
 	EntityID get_entity_id() const { return entity.entity_id; }
 
 	void add_component(const StringName &p_component_name, const Dictionary &p_values) {
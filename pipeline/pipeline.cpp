@@ -7,6 +7,17 @@
 
 Pipeline::Pipeline() {}
 
+Pipeline::~Pipeline() {
+	for (uint32_t i = 0; i < worlds.size(); i += 1) {
+		if (worlds[i].world != nullptr) {
+			Token token;
+			token.index = i;
+			token.generation = worlds[i].generation;
+			release_world(token);
+		}
+	}
+}
+
 bool Pipeline::is_ready() const {
 	return ready;
 }
@@ -125,7 +136,7 @@ Token Pipeline::prepare_world(World *p_world) {
 			}
 		}
 
-		worlds[token.index].system_data_buffer = static_cast<uint8_t *>(memalloc(worlds[token.index].system_data_buffer_size));
+		worlds[token.index].system_data_buffer = static_cast<uint8_t *>(p_world->get_allocator().alloc(worlds[token.index].system_data_buffer_size));
 	}
 
 	// Phase 5: Initialize the SystemExecutionData pointers.
@@ -165,7 +176,7 @@ Token Pipeline::prepare_world(World *p_world) {
 	// Initialize the temporary systems.
 	for (uint32_t i = 0; i < temporary_systems.size(); i += 1) {
 		const uint64_t size = ECS::system_get_size_system_data(temporary_systems[i]);
-		uint8_t *mem = (uint8_t *)memalloc(size);
+		uint8_t *mem = (uint8_t *)p_world->get_allocator().alloc(size);
 		ECS::system_new_placement_system_data(temporary_systems[i], mem, token, p_world, this);
 
 		TemporaryExecutionSystemData d;
@@ -216,6 +227,8 @@ void Pipeline::create_used_storage(const SystemExeInfo &p_info, World *p_world)
 			it = p_info.events_receivers.next_iter(it)) {
 		p_world->create_events_storage(*it.key);
 		EventStorageBase *s = p_world->get_events_storage(*it.key);
+		// Assigns the `EmitterId`s, so the emitters are then accessed without
+		// looking up the name.
 		for (const RBSet<String>::Element *e = it.value->front(); e; e = e->next()) {
 			s->add_event_emitter(e->get());
 		}
@@ -243,7 +256,7 @@ void Pipeline::release_world(Token p_token) {
 			}
 		}
 
-		memfree(worlds[p_token.index].system_data_buffer);
+		worlds[p_token.index].world->get_allocator().free(worlds[p_token.index].system_data_buffer, worlds[p_token.index].system_data_buffer_size);
 	}
 
 	// Clear temporary system data
@@ -251,10 +264,16 @@ void Pipeline::release_world(Token p_token) {
 		const LocalVector<TemporaryExecutionSystemData> &temp_systems = worlds[p_token.index].temporary_systems;
 		for (uint32_t i = 0; i < temp_systems.size(); i += 1) {
 			ECS::system_delete_placement_system_data(temp_systems[i].id, temp_systems[i].system_data);
-			memfree(temp_systems[i].system_data);
+			worlds[p_token.index].world->get_allocator().free(temp_systems[i].system_data, ECS::system_get_size_system_data(temp_systems[i].id));
 		}
 	}
 
+	// The `World` doesn't need to release this pipeline anymore.
+	const int64_t pipeline_index = worlds[p_token.index].world->associated_pipelines.find(this);
+	if (pipeline_index != -1) {
+		worlds[p_token.index].world->associated_pipelines.remove_at_unordered(pipeline_index);
+	}
+
 	// Just reset this, we will reuse this memory eventually.
 	worlds[p_token.index].system_data_buffer = nullptr;
 	worlds[p_token.index].system_data_buffer_size = 0;
@@ -333,6 +352,13 @@ void Pipeline::dispatch(Token p_token) {
 		hierarchy->flush_hierarchy_changes();
 	}
 
+	// The `Added` and `Removed` filters of the previous dispatch read all the
+	// older entries, drop them.
+	world->trim_entities_logs();
+
+	// Keep the change ticks close enough to be compared.
+	world->check_change_ticks();
+
 	// Process the `TemporarySystem`, if any.
 	for (int i = 0; i < int(worlds[p_token.index].temporary_systems.size()); i += 1) {
 		if (worlds[p_token.index].temporary_systems[i].exec_func(
@@ -341,7 +367,7 @@ void Pipeline::dispatch(Token p_token) {
 			// This system is done, deallocate.
 			uint8_t *mem = worlds[p_token.index].temporary_systems[i].system_data;
 			ECS::system_delete_placement_system_data(worlds[p_token.index].temporary_systems[i].id, mem);
-			memfree(mem);
+			world->get_allocator().free(mem, ECS::system_get_size_system_data(worlds[p_token.index].temporary_systems[i].id));
 			worlds[p_token.index].temporary_systems.remove_at(i);
 			i -= 1;
 		}
@@ -349,14 +375,6 @@ void Pipeline::dispatch(Token p_token) {
 
 	dispatch_sub_dispatcher(p_token, 0);
 
-	// TODO remove this, in favour of the new mechanism
-	// Flush changed.
-	for (uint32_t c = 0; c < world->storages.size(); c += 1) {
-		if (world->storages[c] != nullptr) {
-			world->storages[c]->flush_changed();
-		}
-	}
-
 	// Release the world dispatching.
 	pipeline_commands->world_data = nullptr;
 	pipeline_commands->pipeline = nullptr;
@@ -385,6 +403,11 @@ void Pipeline::dispatch_sub_dispatcher(Token p_token, int p_dispatcher_index) {
 		for (uint32_t f = 0; f < dispatcher.exec_stages[stage_i].notify_list_release_write.size(); f += 1) {
 			world->get_storage(dispatcher.exec_stages[stage_i].notify_list_release_write[f])->on_system_release();
 		}
+
+		// Make the events emitted in this stage readable.
+		for (uint32_t e = 0; e < dispatcher.exec_stages[stage_i].swap_list_events.size(); e += 1) {
+			world->get_events_storage(dispatcher.exec_stages[stage_i].swap_list_events[e])->swap_events();
+		}
 	}
 }
 
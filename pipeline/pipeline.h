@@ -29,6 +29,10 @@ struct ExecutionStageData {
 
 	/// Storages that want to be notified at the end of the `System` execution.
 	LocalVector<godex::component_id> notify_list_release_write;
+
+	/// Events emitted in this stage: the events are swapped at the end of the
+	/// stage, so the next stages can read them.
+	LocalVector<godex::event_id> swap_list_events;
 };
 
 struct DispatcherData {
@@ -69,6 +73,8 @@ private:
 
 public:
 	Pipeline();
+	/// Releases the `World`s still prepared by this pipeline.
+	~Pipeline();
 
 	/// Returns false if this pipeline has some bind world, that it's necessary to
 	/// release before altering this pipeline.
@@ -344,6 +344,11 @@ void PipelineBuilder::build_pipeline(
 							}
 						}
 					}
+					for (const RBSet<uint32_t>::Element *e = stage->get().systems[i]->info.events_emitters.front(); e; e = e->next()) {
+						if (r_pipeline->dispatchers[dispatcher_index].exec_stages[stage_index].swap_list_events.find(e->get()) == -1) {
+							r_pipeline->dispatchers[dispatcher_index].exec_stages[stage_index].swap_list_events.push_back(e->get());
+						}
+					}
 				}
 			}
 
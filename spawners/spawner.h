@@ -85,6 +85,25 @@ public:
 		world->get_storage<C>()->insert(p_entity, p_data);
 	}
 
+	/// Inserts the components to all these `Entities` at once: `p_data[i]` is
+	/// assigned to `p_entities[i]`.
+	template <class C>
+	void insert_batch(const EntityID *p_entities, const C *p_data, uint32_t p_count) {
+		if (unlikely(godex::spawner_validate_insert(I::get_spawner_id(), C::get_component_id()) == false)) {
+			return;
+		}
+		world->get_storage<C>()->insert_batch(p_entities, p_data, p_count);
+	}
+
+	/// Inserts the same component to all these `Entities` at once.
+	template <class C>
+	void insert_batch(const EntityID *p_entities, const C &p_data, uint32_t p_count) {
+		if (unlikely(godex::spawner_validate_insert(I::get_spawner_id(), C::get_component_id()) == false)) {
+			return;
+		}
+		world->get_storage<C>()->insert_batch(p_entities, p_data, p_count);
+	}
+
 	template <class C>
 	void insert_dynamic(EntityID p_entity, const Dictionary &p_data) {
 		insert_dynamic(C::get_component_id(), p_entity, p_data);
@@ -109,6 +128,18 @@ public:
 		world->get_storage(p_component)->remove(p_entity);
 	}
 
+	template <class C>
+	void remove_batch(const EntityID *p_entities, uint32_t p_count) {
+		remove_batch(C::get_component_id(), p_entities, p_count);
+	}
+
+	void remove_batch(godex::component_id p_component, const EntityID *p_entities, uint32_t p_count) {
+		if (unlikely(godex::spawner_validate_insert(I::get_spawner_id(), p_component) == false)) {
+			return;
+		}
+		world->get_storage(p_component)->remove_batch(p_entities, p_count);
+	}
+
 	static void get_components(SystemExeInfo &r_info) {
 		godex::spawner_get_components(I::get_spawner_id(), r_info);
 	}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "../ecs.h"
+#include "archetype_table.h"
+#include "storage.h"
+
+/// Archetype storage.
+/// The components using this storage are stored inside the `ArchetypeTable`
+/// of the `World`: the `Entities` having the same set of archetype components
+/// share the same chunks, where each component has its own column.
+///
+/// A `Query` that fetches only components stored in this way, iterates the
+/// chunks linearly.
+///
+/// ```
+/// struct Position {
+/// 	COMPONENT(Position, ArchetypeStorage)
+/// 	Vector3 value;
+/// };
+/// ```
+///
+/// Note: Adding and removing components moves the `Entity` to another
+/// archetype, so this storage is good for components that are not inserted
+/// or removed each frame.
+template <class T>
+class ArchetypeStorage : public Storage<T>, public ArchetypeStorageBase {
+	static_assert(std::is_trivially_copyable<T>::value, "The components stored by the `ArchetypeStorage` must be trivially copyable.");
+
+	/// Entities that have this component, used as determinant list.
+	EntityList entities;
+
+public:
+	virtual ~ArchetypeStorage() {
+		if (table != nullptr) {
+			// Release the data stored inside the table.
+			clear();
+		}
+	}
+
+	virtual void set_table(ArchetypeTable *p_table) override {
+		CRASH_COND_MSG(table != nullptr, "This storage is already using an ArchetypeTable.");
+		table = p_table;
+		table->register_component(T::get_component_id(), sizeof(T));
+	}
+
+	virtual String get_type_name() const override {
+		return "ArchetypeStorage[" + String(typeid(T).name()) + "]";
+	}
+
+	virtual void insert(EntityID p_entity, const T &p_data) override {
+#ifdef DEBUG_ENABLED
+		CRASH_COND_MSG(table == nullptr, "The ArchetypeStorage is not yet initialized by the World.");
+#endif
+		const bool overwrite = has(p_entity);
+		table->insert(p_entity, T::get_component_id(), &p_data);
+		if (overwrite) {
+			// Already stored, only the data changes.
+			StorageBase::notify_changed(p_entity);
+			return;
+		}
+		entities.insert(p_entity);
+		StorageBase::notify_inserted(p_entity);
+	}
+
+	virtual bool is_tracking_entities() const override {
+		return true;
+	}
+
+	virtual bool has(EntityID p_entity) const override {
+		return entities.has(p_entity);
+	}
+
+	virtual T *get(EntityID p_entity, Space p_mode = Space::LOCAL) override {
+		StorageBase::notify_changed(p_entity);
+		return static_cast<T *>(table->get(p_entity, T::get_component_id()));
+	}
+
+	virtual const T *get(EntityID p_entity, Space p_mode = Space::LOCAL) const override {
+		return static_cast<const T *>(const_cast<const ArchetypeTable *>(table)->get(p_entity, T::get_component_id()));
+	}
+
+	virtual void remove(EntityID p_entity) override {
+		ERR_FAIL_COND_MSG(entities.has(p_entity) == false, "No entity: " + itos(p_entity) + " in this storage.");
+		table->remove(p_entity, T::get_component_id());
+		entities.remove(p_entity);
+		// Make sure to remove as changed.
+		StorageBase::notify_removed(p_entity);
+	}
+
+	virtual void clear() override {
+		StorageBase::notify_clearing();
+		const EntityID *ptr = entities.get_entities_ptr();
+		for (uint32_t i = 0; i < entities.size(); i += 1) {
+			table->remove(ptr[i], T::get_component_id());
+		}
+		entities.clear();
+		StorageBase::notify_cleared();
+	}
+
+	virtual EntitiesBuffer get_stored_entities() const override {
+		return { entities.size(), entities.get_entities_ptr() };
+	}
+
+	virtual StorageMemoryStats get_memory_stats() const override {
+		StorageMemoryStats stats = StorageBase::get_memory_stats();
+		// The data is stored inside the `ArchetypeTable`, accounted by the
+		// `World`.
+		entities.add_memory_stats(stats);
+		return stats;
+	}
+};
@@ -0,0 +1,359 @@
+#include "archetype_table.h"
+
+ArchetypeTable::~ArchetypeTable() {
+	reset();
+}
+
+void ArchetypeTable::register_component(godex::component_id p_component, uint32_t p_size) {
+	if (p_component >= component_sizes.size()) {
+		const uint32_t start = component_sizes.size();
+		component_sizes.resize(p_component + 1);
+		for (uint32_t i = start; i < component_sizes.size(); i += 1) {
+			component_sizes[i] = 0;
+		}
+	}
+	component_sizes[p_component] = p_size;
+}
+
+bool ArchetypeTable::has(EntityID p_entity, godex::component_id p_component) const {
+	if (has_location(p_entity) == false) {
+		return false;
+	}
+	return archetypes[get_location(p_entity).archetype]->find_column(p_component) != -1;
+}
+
+void ArchetypeTable::insert(EntityID p_entity, godex::component_id p_component, const void *p_data) {
+	ERR_FAIL_COND_MSG(p_component >= component_sizes.size() || component_sizes[p_component] == 0, "The component " + itos(p_component) + " is not registered to this ArchetypeTable.");
+
+	ArchetypeLocation to;
+
+	if (has_location(p_entity)) {
+		const ArchetypeLocation from = get_location(p_entity);
+		const int64_t column = archetypes[from.archetype]->find_column(p_component);
+		if (column != -1) {
+			// Already in the archetype, just update the data.
+			memcpy(archetypes[from.archetype]->get_data(from.chunk, column, from.row), p_data, component_sizes[p_component]);
+			return;
+		}
+
+		// Move the `Entity` to the new archetype.
+		to = allocate_row(get_archetype_with(from.archetype, p_component), p_entity);
+		copy_shared(from, to);
+		free_row(from);
+		get_location(p_entity) = to;
+	} else {
+		LocalVector<godex::component_id> components;
+		components.push_back(p_component);
+		to = allocate_row(get_or_create_archetype(components), p_entity);
+		insert_location(p_entity, to);
+	}
+
+	const Archetype *archetype = archetypes[to.archetype];
+	memcpy(archetype->get_data(to.chunk, archetype->find_column(p_component), to.row), p_data, component_sizes[p_component]);
+}
+
+void ArchetypeTable::remove(EntityID p_entity, godex::component_id p_component) {
+	ERR_FAIL_COND_MSG(has_location(p_entity) == false, "The entity " + itos(p_entity) + " is not in this ArchetypeTable.");
+
+	const ArchetypeLocation from = get_location(p_entity);
+	ERR_FAIL_COND_MSG(archetypes[from.archetype]->find_column(p_component) == -1, "The entity " + itos(p_entity) + " doesn't have the component " + itos(p_component) + ".");
+
+	if (archetypes[from.archetype]->components.size() == 1) {
+		// This was the last component, the `Entity` leaves the table.
+		free_row(from);
+		remove_location(p_entity);
+		return;
+	}
+
+	const ArchetypeLocation to = allocate_row(get_archetype_without(from.archetype, p_component), p_entity);
+	copy_shared(from, to);
+	free_row(from);
+	get_location(p_entity) = to;
+}
+
+void *ArchetypeTable::get(EntityID p_entity, godex::component_id p_component) {
+	return const_cast<void *>(const_cast<const ArchetypeTable *>(this)->get(p_entity, p_component));
+}
+
+const void *ArchetypeTable::get(EntityID p_entity, godex::component_id p_component) const {
+#ifdef DEBUG_ENABLED
+	CRASH_COND_MSG(has_location(p_entity) == false, "The entity " + itos(p_entity) + " is not in this ArchetypeTable.");
+#endif
+	const ArchetypeLocation &location = get_location(p_entity);
+	const Archetype *archetype = archetypes[location.archetype];
+	const int64_t column = archetype->find_column(p_component);
+#ifdef DEBUG_ENABLED
+	CRASH_COND_MSG(column == -1, "The entity " + itos(p_entity) + " doesn't have the component " + itos(p_component) + ".");
+#endif
+	return archetype->get_data(location.chunk, column, location.row);
+}
+
+void ArchetypeTable::add_memory_stats(StorageMemoryStats &r_stats) const {
+	for (uint32_t a = 0; a < archetypes.size(); a += 1) {
+		const Archetype *archetype = archetypes[a];
+		uint64_t row_size = sizeof(EntityID);
+		for (uint32_t i = 0; i < archetype->component_sizes.size(); i += 1) {
+			row_size += archetype->component_sizes[i];
+		}
+		r_stats.bytes_used += archetype->count * row_size;
+		r_stats.bytes_reserved += uint64_t(archetype->chunks.size()) * archetype->chunk_size;
+		r_stats.add_vector(archetype->chunks);
+		r_stats.add_vector(archetype->component_columns);
+		r_stats.live_count += archetype->count;
+	}
+	r_stats.add_vector(archetypes);
+	entity_to_location.add_memory_stats(r_stats);
+	r_stats.add_vector(locations);
+	r_stats.add_vector(location_to_entity);
+}
+
+void ArchetypeTable::reset() {
+	for (uint32_t a = 0; a < archetypes.size(); a += 1) {
+		for (uint32_t c = 0; c < archetypes[a]->chunks.size(); c += 1) {
+			free_chunk(archetypes[a]->chunks[c].memory, archetypes[a]->chunk_size);
+		}
+		memdelete(archetypes[a]);
+	}
+	archetypes.reset();
+	entity_to_location.reset();
+	locations.reset();
+	location_to_entity.reset();
+}
+
+void ArchetypeTable::insert_location(EntityID p_entity, const ArchetypeLocation &p_location) {
+	entity_to_location.set(p_entity, locations.size());
+	locations.push_back(p_location);
+	location_to_entity.push_back(p_entity);
+}
+
+void ArchetypeTable::remove_location(EntityID p_entity) {
+	const uint32_t index = entity_to_location.get_unchecked(p_entity);
+	const uint32_t last = locations.size() - 1;
+	if (index != last) {
+		locations[index] = locations[last];
+		location_to_entity[index] = location_to_entity[last];
+		entity_to_location.update(location_to_entity[index], index);
+	}
+	locations.remove_at(last);
+	location_to_entity.remove_at(last);
+	entity_to_location.unset(p_entity);
+}
+
+bool ArchetypeTable::archetype_matches(const Archetype *p_archetype, const godex::component_id *p_components, uint32_t p_count) {
+	for (uint32_t i = 0; i < p_count; i += 1) {
+		if (p_archetype->find_column(p_components[i]) == -1) {
+			return false;
+		}
+	}
+	return true;
+}
+
+uint32_t ArchetypeTable::find_archetype(const LocalVector<godex::component_id> &p_components) const {
+	for (uint32_t a = 0; a < archetypes.size(); a += 1) {
+		const LocalVector<godex::component_id> &components = archetypes[a]->components;
+		if (components.size() != p_components.size()) {
+			continue;
+		}
+		bool same = true;
+		for (uint32_t i = 0; i < components.size(); i += 1) {
+			if (components[i] != p_components[i]) {
+				same = false;
+				break;
+			}
+		}
+		if (same) {
+			return a;
+		}
+	}
+	return UINT32_MAX;
+}
+
+uint32_t ArchetypeTable::get_or_create_archetype(const LocalVector<godex::component_id> &p_components) {
+	const uint32_t existing = find_archetype(p_components);
+	if (existing != UINT32_MAX) {
+		return existing;
+	}
+
+	Archetype *archetype = memnew(Archetype);
+	archetype->components = p_components;
+	archetype->component_sizes.resize(p_components.size());
+
+	// The components are sorted, so the last one has the biggest id.
+	if (p_components.size() > 0) {
+		archetype->component_columns.resize(p_components[p_components.size() - 1] + 1);
+		for (uint32_t i = 0; i < archetype->component_columns.size(); i += 1) {
+			archetype->component_columns[i] = UINT32_MAX;
+		}
+		for (uint32_t i = 0; i < p_components.size(); i += 1) {
+			archetype->component_columns[p_components[i]] = i;
+		}
+	}
+
+	uint32_t row_size = sizeof(EntityID);
+	for (uint32_t i = 0; i < p_components.size(); i += 1) {
+		archetype->component_sizes[i] = component_sizes[p_components[i]];
+		row_size += archetype->component_sizes[i];
+	}
+
+	// Find how many rows fit the chunk, taking into account the columns
+	// alignment padding.
+	uint32_t capacity = MAX(1u, CHUNK_SIZE / row_size);
+	uint32_t chunk_size = 0;
+	archetype->column_offsets.resize(p_components.size());
+	while (true) {
+		uint32_t offset = capacity * sizeof(EntityID);
+		for (uint32_t i = 0; i < p_components.size(); i += 1) {
+			offset = (offset + COLUMN_ALIGNMENT - 1) & ~(COLUMN_ALIGNMENT - 1);
+			archetype->column_offsets[i] = offset;
+			offset += capacity * archetype->component_sizes[i];
+		}
+		chunk_size = offset;
+		if (chunk_size <= CHUNK_SIZE || capacity == 1) {
+			break;
+		}
+		capacity -= 1;
+	}
+
+	archetype->chunk_capacity = capacity;
+	archetype->chunk_size = MAX(chunk_size, CHUNK_SIZE);
+
+	archetypes.push_back(archetype);
+	return archetypes.size() - 1;
+}
+
+uint32_t ArchetypeTable::get_archetype_with(uint32_t p_archetype, godex::component_id p_component) {
+	{
+		const LocalVector<uint32_t> &edges = archetypes[p_archetype]->add_edges;
+		if (p_component < edges.size() && edges[p_component] != UINT32_MAX) {
+			return edges[p_component];
+		}
+	}
+
+	LocalVector<godex::component_id> components = archetypes[p_archetype]->components;
+	uint32_t position = 0;
+	while (position < components.size() && components[position] < p_component) {
+		position += 1;
+	}
+	components.insert(position, p_component);
+
+	const uint32_t result = get_or_create_archetype(components);
+
+	// Cache the transition.
+	LocalVector<uint32_t> &edges = archetypes[p_archetype]->add_edges;
+	if (p_component >= edges.size()) {
+		const uint32_t start = edges.size();
+		edges.resize(p_component + 1);
+		for (uint32_t i = start; i < edges.size(); i += 1) {
+			edges[i] = UINT32_MAX;
+		}
+	}
+	edges[p_component] = result;
+	return result;
+}
+
+uint32_t ArchetypeTable::get_archetype_without(uint32_t p_archetype, godex::component_id p_component) {
+	{
+		const LocalVector<uint32_t> &edges = archetypes[p_archetype]->remove_edges;
+		if (p_component < edges.size() && edges[p_component] != UINT32_MAX) {
+			return edges[p_component];
+		}
+	}
+
+	LocalVector<godex::component_id> components = archetypes[p_archetype]->components;
+	const int64_t position = components.find(p_component);
+	CRASH_COND_MSG(position == -1, "The component is not part of this archetype. This is a bug.");
+	components.remove_at(position);
+
+	const uint32_t result = get_or_create_archetype(components);
+
+	// Cache the transition.
+	LocalVector<uint32_t> &edges = archetypes[p_archetype]->remove_edges;
+	if (p_component >= edges.size()) {
+		const uint32_t start = edges.size();
+		edges.resize(p_component + 1);
+		for (uint32_t i = start; i < edges.size(); i += 1) {
+			edges[i] = UINT32_MAX;
+		}
+	}
+	edges[p_component] = result;
+	return result;
+}
+
+ArchetypeLocation ArchetypeTable::allocate_row(uint32_t p_archetype, EntityID p_entity) {
+	Archetype *archetype = archetypes[p_archetype];
+
+	ArchetypeLocation location;
+	location.archetype = p_archetype;
+	location.chunk = archetype->count / archetype->chunk_capacity;
+	location.row = archetype->count % archetype->chunk_capacity;
+
+	if (location.chunk >= archetype->chunks.size()) {
+		ArchetypeChunk chunk;
+		chunk.memory = alloc_chunk(archetype->chunk_size);
+		chunk.count = 0;
+		archetype->chunks.push_back(chunk);
+	}
+
+	archetype->get_entities(location.chunk)[location.row] = p_entity;
+	archetype->chunks[location.chunk].count += 1;
+	archetype->count += 1;
+
+	return location;
+}
+
+void ArchetypeTable::free_row(const ArchetypeLocation &p_location) {
+	Archetype *archetype = archetypes[p_location.archetype];
+
+	const uint32_t last = archetype->count - 1;
+	const uint32_t last_chunk = last / archetype->chunk_capacity;
+	const uint32_t last_row = last % archetype->chunk_capacity;
+
+	if (last_chunk != p_location.chunk || last_row != p_location.row) {
+		// Move the last row on the freed one, so the chunks are kept packed.
+		const EntityID moved_entity = archetype->get_entities(last_chunk)[last_row];
+		archetype->get_entities(p_location.chunk)[p_location.row] = moved_entity;
+		for (uint32_t i = 0; i < archetype->components.size(); i += 1) {
+			memcpy(
+					archetype->get_data(p_location.chunk, i, p_location.row),
+					archetype->get_data(last_chunk, i, last_row),
+					archetype->component_sizes[i]);
+		}
+		get_location(moved_entity) = p_location;
+	}
+
+	archetype->chunks[last_chunk].count -= 1;
+	archetype->count -= 1;
+
+	if (archetype->chunks[last_chunk].count == 0) {
+		// The last chunk is empty, release it.
+		free_chunk(archetype->chunks[last_chunk].memory, archetype->chunk_size);
+		archetype->chunks.remove_at(last_chunk);
+	}
+}
+
+uint8_t *ArchetypeTable::alloc_chunk(uint32_t p_size) {
+	return static_cast<uint8_t *>(allocator ? allocator->alloc(p_size) : memalloc(p_size));
+}
+
+void ArchetypeTable::free_chunk(uint8_t *p_memory, uint32_t p_size) {
+	if (allocator) {
+		allocator->free(p_memory, p_size);
+	} else {
+		memfree(p_memory);
+	}
+}
+
+void ArchetypeTable::copy_shared(const ArchetypeLocation &p_from, const ArchetypeLocation &p_to) {
+	const Archetype *from = archetypes[p_from.archetype];
+	const Archetype *to = archetypes[p_to.archetype];
+
+	for (uint32_t i = 0; i < from->components.size(); i += 1) {
+		const int64_t column = to->find_column(from->components[i]);
+		if (column != -1) {
+			memcpy(
+					to->get_data(p_to.chunk, column, p_to.row),
+					from->get_data(p_from.chunk, i, p_from.row),
+					from->component_sizes[i]);
+		}
+	}
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "core/templates/local_vector.h"
+#include "paged_sparse_index.h"
+#include "storage.h"
+
+/// Chunk of an `Archetype`: it's a `CHUNK_SIZE` piece of memory that stores
+/// the `EntityID` column followed by one column per component.
+struct ArchetypeChunk {
+	uint8_t *memory = nullptr;
+	uint32_t count = 0;
+};
+
+/// An `Archetype` groups all the `Entities` that have the exact same set of
+/// components stored in the `ArchetypeTable`.
+/// The data is stored in chunks, using a SoA layout, so it's possible to
+/// iterate it linearly.
+struct Archetype {
+	/// Sorted list of components.
+	LocalVector<godex::component_id> components;
+	/// Size of each component, in the same order of `components`.
+	LocalVector<uint32_t> component_sizes;
+	/// Byte offset of each column within the chunk, in the same order of
+	/// `components`. The `EntityID` column is always at offset 0.
+	LocalVector<uint32_t> column_offsets;
+	/// Amount of `Entities` that fits in one chunk.
+	uint32_t chunk_capacity = 0;
+	/// Size in bytes of each chunk.
+	uint32_t chunk_size = 0;
+	/// The chunks are always kept full, except the last one.
+	LocalVector<ArchetypeChunk> chunks;
+	/// Amount of `Entities` stored in this archetype.
+	uint32_t count = 0;
+
+	/// Cached transitions to the archetype with (add) or without (remove) the
+	/// component, indexed by component id.
+	LocalVector<uint32_t> add_edges;
+	LocalVector<uint32_t> remove_edges;
+
+	/// The column of each component, indexed by component id: `UINT32_MAX`
+	/// when this archetype doesn't have it. Sized to the biggest component
+	/// id of this archetype.
+	LocalVector<uint32_t> component_columns;
+
+	/// Returns the column index of this component or -1.
+	_FORCE_INLINE_ int64_t find_column(godex::component_id p_component) const {
+		if (p_component >= component_columns.size() || component_columns[p_component] == UINT32_MAX) {
+			return -1;
+		}
+		return component_columns[p_component];
+	}
+
+	_FORCE_INLINE_ EntityID *get_entities(uint32_t p_chunk) const {
+		return reinterpret_cast<EntityID *>(chunks[p_chunk].memory);
+	}
+
+	_FORCE_INLINE_ uint8_t *get_column(uint32_t p_chunk, uint32_t p_column) const {
+		return chunks[p_chunk].memory + column_offsets[p_column];
+	}
+
+	_FORCE_INLINE_ void *get_data(uint32_t p_chunk, uint32_t p_column, uint32_t p_row) const {
+		return get_column(p_chunk, p_column) + (component_sizes[p_column] * p_row);
+	}
+};
+
+/// Points to the `Entity` data within the `ArchetypeTable`.
+struct ArchetypeLocation {
+	uint32_t archetype = UINT32_MAX;
+	uint32_t chunk = 0;
+	uint32_t row = 0;
+};
+
+/// The `ArchetypeTable` stores the components of the `Entities` grouped by
+/// `Archetype`. It's owned by the `World` and shared by all the
+/// `ArchetypeStorage`s.
+///
+/// The components stored here must be trivially copyable, since the table
+/// moves them across the archetypes using `memcpy`.
+class ArchetypeTable {
+public:
+	static constexpr uint32_t CHUNK_SIZE = 16 * 1024;
+	static constexpr uint32_t COLUMN_ALIGNMENT = 16;
+
+private:
+	LocalVector<Archetype *> archetypes;
+	/// Size of the components, indexed by component id. 0 if not registered.
+	LocalVector<uint32_t> component_sizes;
+	/// Sparse index `EntityID` -> `locations`.
+	PagedSparseIndex entity_to_location;
+	LocalVector<ArchetypeLocation> locations;
+	LocalVector<EntityID> location_to_entity;
+	WorldAllocator *allocator = nullptr;
+
+public:
+	ArchetypeTable() = default;
+	ArchetypeTable(WorldAllocator *p_allocator) :
+			allocator(p_allocator) {}
+	ArchetypeTable(const ArchetypeTable &) = delete;
+	ArchetypeTable &operator=(const ArchetypeTable &) = delete;
+	~ArchetypeTable();
+
+	/// Must be called before using the component with the table.
+	void register_component(godex::component_id p_component, uint32_t p_size);
+
+	bool has(EntityID p_entity, godex::component_id p_component) const;
+
+	/// Inserts the component to the `Entity`, moving it to the new archetype.
+	/// If the `Entity` has the component already, the data is just updated.
+	void insert(EntityID p_entity, godex::component_id p_component, const void *p_data);
+
+	/// Removes the component from the `Entity`, moving it to the new archetype.
+	void remove(EntityID p_entity, godex::component_id p_component);
+
+	void *get(EntityID p_entity, godex::component_id p_component);
+	const void *get(EntityID p_entity, godex::component_id p_component) const;
+
+	/// Frees all the memory.
+	void reset();
+
+	/// Accounts the chunks and the `Entities` locations of all the archetypes.
+	void add_memory_stats(StorageMemoryStats &r_stats) const;
+
+	uint32_t get_archetype_count() const {
+		return archetypes.size();
+	}
+
+	const Archetype *get_archetype(uint32_t p_index) const {
+		return archetypes[p_index];
+	}
+
+	/// Returns `true` if the archetype contains all the given components.
+	static bool archetype_matches(const Archetype *p_archetype, const godex::component_id *p_components, uint32_t p_count);
+
+private:
+	_FORCE_INLINE_ bool has_location(EntityID p_entity) const {
+		return entity_to_location.has(p_entity);
+	}
+	_FORCE_INLINE_ ArchetypeLocation &get_location(EntityID p_entity) {
+		return locations[entity_to_location.get_unchecked(p_entity)];
+	}
+	_FORCE_INLINE_ const ArchetypeLocation &get_location(EntityID p_entity) const {
+		return locations[entity_to_location.get_unchecked(p_entity)];
+	}
+	void insert_location(EntityID p_entity, const ArchetypeLocation &p_location);
+	void remove_location(EntityID p_entity);
+
+	uint32_t find_archetype(const LocalVector<godex::component_id> &p_components) const;
+	uint32_t get_or_create_archetype(const LocalVector<godex::component_id> &p_components);
+	uint32_t get_archetype_with(uint32_t p_archetype, godex::component_id p_component);
+	uint32_t get_archetype_without(uint32_t p_archetype, godex::component_id p_component);
+
+	/// Allocates a new row at the end of the archetype.
+	ArchetypeLocation allocate_row(uint32_t p_archetype, EntityID p_entity);
+	/// Frees the row by moving the last row of the archetype on it.
+	void free_row(const ArchetypeLocation &p_location);
+	/// The chunks are taken from the `World` allocator, when set.
+	uint8_t *alloc_chunk(uint32_t p_size);
+	void free_chunk(uint8_t *p_memory, uint32_t p_size);
+	/// Copies the components shared between the two archetypes.
+	void copy_shared(const ArchetypeLocation &p_from, const ArchetypeLocation &p_to);
+};
+
+/// Base class of the `ArchetypeStorage`, used by the `World` to assign the
+/// `ArchetypeTable`.
+class ArchetypeStorageBase {
+	friend class World;
+
+protected:
+	ArchetypeTable *table = nullptr;
+
+public:
+	virtual ~ArchetypeStorageBase() {}
+
+	virtual void set_table(ArchetypeTable *p_table) = 0;
+
+	ArchetypeTable *get_table() const {
+		return table;
+	}
+};
+
+/// Returns `true` when the component `C` uses the `ArchetypeStorage`.
+template <typename C, typename = void>
+struct godex_is_archetype_component : std::false_type {};
+
+template <typename C>
+struct godex_is_archetype_component<C, std::enable_if_t<std::is_base_of<ArchetypeStorageBase, std::remove_pointer_t<decltype(std::remove_const_t<C>::create_storage())>>::value>> : std::true_type {};
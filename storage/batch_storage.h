@@ -24,12 +24,18 @@ public:
 			} else {
 				v.push_back(p_data);
 			}
+			// The batch was already stored, only its data changes.
+			StorageBase::notify_changed(p_entity);
 		} else {
 			StaticVector<T, SIZE> v;
 			v.push_back(p_data);
 			storage.insert(p_entity, v);
+			StorageBase::notify_inserted(p_entity);
 		}
-		StorageBase::notify_changed(p_entity);
+	}
+
+	virtual bool is_tracking_entities() const override {
+		return true;
 	}
 
 	virtual bool has(EntityID p_entity) const override {
@@ -52,41 +58,113 @@ public:
 	virtual void remove(EntityID p_entity) override {
 		storage.remove(p_entity);
 		// Make sure to remove as changed.
-		StorageBase::notify_updated(p_entity);
+		StorageBase::notify_removed(p_entity);
 	}
 
 	virtual void clear() override {
+		StorageBase::notify_clearing();
 		storage.clear();
-		StorageBase::flush_changed();
+		StorageBase::notify_cleared();
 	}
 
 	virtual EntitiesBuffer get_stored_entities() const {
 		return { storage.get_entities().size(), storage.get_entities().ptr() };
 	}
+
+	virtual bool compact(uint32_t &r_budget) override {
+		return storage.compact(r_budget);
+	}
+
+	virtual StorageMemoryStats get_memory_stats() const override {
+		StorageMemoryStats stats = StorageBase::get_memory_stats();
+		storage.add_memory_stats(stats);
+		// The free slots of each batch are reserved but not used.
+		const LocalVector<EntityID> &entities = storage.get_entities();
+		for (uint32_t e = 0; e < entities.size(); e += 1) {
+			stats.bytes_used -= uint64_t(SIZE - storage.get(entities[e]).size()) * sizeof(T);
+		}
+		return stats;
+	}
 };
 
-/// The size can be chosen on the fly, but the components are stored in a
-/// de-localized memory, which may invalidate cache coherency.
+/// The size can be chosen on the fly.
+/// All the batches are stored into a single arena, one after the other, and
+/// each `Entity` points to its span of the arena. When a batch is full, it's
+/// moved to the end of the arena with double the capacity; the arena is
+/// compacted each time it grows.
+/// The `clear` keeps the arena memory, so the batches that are filled and
+/// cleared each frame (like the forces) don't allocate in steady state.
+///
+/// Note: inserting a component may move the arena, so the pointers returned
+/// by `get` are valid until the next `insert`.
 template <template <class> class STORAGE, class T>
 class BatchStorage<STORAGE, -1, T> : public Storage<T> {
+	static constexpr uint32_t MIN_BATCH_CAPACITY = 2;
+	static constexpr uint32_t MIN_ARENA_CAPACITY = 16;
+
+	struct Span {
+		uint32_t offset = 0;
+		uint32_t size = 0;
+		uint32_t capacity = 0;
+	};
+
 protected:
-	STORAGE<LocalVector<T>> storage;
+	STORAGE<Span> storage;
+
+	/// The arena memory: only the first `size` elements of each span are
+	/// constructed.
+	T *arena = nullptr;
+	/// Used elements, including the unused spans.
+	uint32_t arena_size = 0;
+	uint32_t arena_capacity = 0;
+	/// Elements used by the stored spans.
+	uint32_t arena_used = 0;
+	/// The arena capacity set by `configure`, kept by `compact`.
+	uint32_t pre_allocated = 0;
 
 public:
+	virtual ~BatchStorage() {
+		destroy_batches();
+		if (arena != nullptr) {
+			StorageBase::free_memory(arena, sizeof(T) * arena_capacity);
+		}
+	}
+
+	virtual void configure(const Dictionary &p_config) override {
+		clear();
+		pre_allocated = p_config.get("pre_allocate", 0);
+		if (pre_allocated > arena_capacity) {
+			relocate(pre_allocated);
+		}
+	}
+
 	virtual String get_type_name() const override {
 		return "DynamicSizedBatchStorage<" + String(typeid(T).name()) + ">";
 	}
 
 	virtual void insert(EntityID p_entity, const T &p_data) override {
 		if (storage.has(p_entity)) {
-			storage.get(p_entity).push_back(p_data);
+			if (storage.get(p_entity).size == storage.get(p_entity).capacity) {
+				grow_span(p_entity);
+			}
+			Span &span = storage.get(p_entity);
+			memnew_placement(arena + span.offset + span.size, T(p_data));
+			span.size += 1;
+			// The batch was already stored, only its data changes.
+			StorageBase::notify_changed(p_entity);
 		} else {
-			LocalVector<T> s;
-			s.resize(1);
-			s[0] = p_data;
-			storage.insert(p_entity, s);
+			Span span;
+			span.offset = alloc_elements(MIN_BATCH_CAPACITY);
+			span.capacity = MIN_BATCH_CAPACITY;
+			span.size = 1;
+			memnew_placement(arena + span.offset, T(p_data));
+			storage.insert(p_entity, span);
+			StorageBase::notify_inserted(p_entity);
 		}
-		StorageBase::notify_changed(p_entity);
+	}
+
+	virtual bool is_tracking_entities() const override {
+		return true;
 	}
 
 	virtual bool has(EntityID p_entity) const override {
@@ -95,31 +173,147 @@ public:
 
 	virtual T *get(EntityID p_entity, Space p_mode = Space::LOCAL) override {
 		StorageBase::notify_changed(p_entity);
-		LocalVector<T> &data = storage.get(p_entity);
-		return data.ptr();
+		return arena + storage.get(p_entity).offset;
 	}
 
 	virtual const T *get(EntityID p_entity, Space p_mode = Space::LOCAL) const override {
-		const LocalVector<T> &data = storage.get(p_entity);
-		return data.ptr();
+		return arena + storage.get(p_entity).offset;
 	}
 
 	virtual uint32_t get_batch_size(EntityID p_entity) const override {
-		return storage.get(p_entity).size();
+		return storage.get(p_entity).size;
 	}
 
 	virtual void remove(EntityID p_entity) override {
+		ERR_FAIL_COND_MSG(storage.has(p_entity) == false, "No entity: " + itos(p_entity) + " in this storage.");
+		const Span &span = storage.get(p_entity);
+		destroy_elements(span);
+		// The span memory is reclaimed when the arena is compacted.
+		arena_used -= span.capacity;
 		storage.remove(p_entity);
 		// Make sure to remove as changed.
-		StorageBase::notify_updated(p_entity);
+		StorageBase::notify_removed(p_entity);
 	}
 
 	virtual void clear() override {
+		StorageBase::notify_clearing();
+		destroy_batches();
 		storage.clear();
-		StorageBase::flush_changed();
+		// Keep the memory, so it can be reused.
+		arena_size = 0;
+		arena_used = 0;
+		StorageBase::notify_cleared();
 	}
 
 	virtual EntitiesBuffer get_stored_entities() const {
 		return { storage.get_entities().size(), storage.get_entities().ptr() };
 	}
+
+	virtual bool compact(uint32_t &r_budget) override {
+		if (storage.compact(r_budget) == false) {
+			return false;
+		}
+
+		// Remove the unused spans, and release the over-reserved memory.
+		// The relocated spans follow the `Entities` order.
+		const uint32_t target = MAX(pre_allocated, next_power_of_2(MAX(arena_used * 2, MIN_ARENA_CAPACITY)));
+		const bool over_reserved = arena_capacity > target * 2;
+		if (arena_size != arena_used || over_reserved) {
+			if (r_budget == 0) {
+				return false;
+			}
+			r_budget -= MIN(r_budget, arena_used);
+			relocate(over_reserved ? target : arena_capacity);
+		}
+		return true;
+	}
+
+	virtual StorageMemoryStats get_memory_stats() const override {
+		StorageMemoryStats stats = StorageBase::get_memory_stats();
+		storage.add_memory_stats(stats);
+		// The unused part of the spans, and the spans not yet compacted, are
+		// reserved but not used.
+		uint64_t used = 0;
+		const LocalVector<EntityID> &entities = storage.get_entities();
+		for (uint32_t e = 0; e < entities.size(); e += 1) {
+			used += storage.get(entities[e]).size;
+		}
+		stats.add(used, arena_capacity, sizeof(T));
+		return stats;
+	}
+
+	/// Returns the amount of elements the arena can store before growing.
+	uint32_t get_arena_capacity() const {
+		return arena_capacity;
+	}
+
+private:
+	/// Returns the offset of `p_count` new elements at the end of the arena.
+	uint32_t alloc_elements(uint32_t p_count) {
+		if (unlikely(arena_size + p_count > arena_capacity)) {
+			// Grow, leaving enough room for the spans to double.
+			const uint32_t required = arena_used + p_count;
+			relocate(MAX(arena_capacity, next_power_of_2(MAX(required * 4, MIN_ARENA_CAPACITY))));
+		}
+		const uint32_t offset = arena_size;
+		arena_size += p_count;
+		arena_used += p_count;
+		return offset;
+	}
+
+	/// Moves the batch at the end of the arena, doubling its capacity.
+	void grow_span(EntityID p_entity) {
+		const uint32_t old_capacity = storage.get(p_entity).capacity;
+		const uint32_t capacity = old_capacity * 2;
+		// Note: this may relocate the arena, so the span is taken after.
+		const uint32_t offset = alloc_elements(capacity);
+
+		Span &span = storage.get(p_entity);
+		for (uint32_t i = 0; i < span.size; i += 1) {
+			memnew_placement(arena + offset + i, T(arena[span.offset + i]));
+			arena[span.offset + i].~T();
+		}
+		span.offset = offset;
+		span.capacity = capacity;
+		arena_used -= old_capacity;
+	}
+
+	/// Moves all the batches to a new arena of `p_capacity` elements, removing
+	/// the unused spans.
+	void relocate(uint32_t p_capacity) {
+		CRASH_COND_MSG(p_capacity < arena_used, "The arena can't be smaller than the used elements, this is a bug.");
+		T *new_arena = static_cast<T *>(StorageBase::alloc_memory(sizeof(T) * p_capacity));
+
+		uint32_t offset = 0;
+		const LocalVector<EntityID> &entities = storage.get_entities();
+		for (uint32_t e = 0; e < entities.size(); e += 1) {
+			Span &span = storage.get(entities[e]);
+			for (uint32_t i = 0; i < span.size; i += 1) {
+				memnew_placement(new_arena + offset + i, T(arena[span.offset + i]));
+				arena[span.offset + i].~T();
+			}
+			span.offset = offset;
+			offset += span.capacity;
+		}
+
+		if (arena != nullptr) {
+			StorageBase::free_memory(arena, sizeof(T) * arena_capacity);
+		}
+		arena = new_arena;
+		arena_size = offset;
+		arena_capacity = p_capacity;
+	}
+
+	void destroy_elements(const Span &p_span) {
+		for (uint32_t i = 0; i < p_span.size; i += 1) {
+			arena[p_span.offset + i].~T();
+		}
+	}
+
+	void destroy_batches() {
+		const LocalVector<EntityID> &entities = storage.get_entities();
+		for (uint32_t e = 0; e < entities.size(); e += 1) {
+			destroy_elements(storage.get(entities[e]));
+		}
+	}
 };
@@ -0,0 +1,84 @@
+#include "dense_group.h"
+
+DenseGroup::DenseGroup(const LocalVector<godex::component_id> &p_components, const LocalVector<DenseGroupStorage *> &p_storages) :
+		components(p_components),
+		storages(p_storages) {
+	CRASH_COND_MSG(components.size() != storages.size(), "Each grouped component needs its storage, this is a bug.");
+	CRASH_COND_MSG(storages.size() == 0, "The group needs at least one storage, this is a bug.");
+}
+
+bool DenseGroup::matches(const godex::component_id *p_components, uint32_t p_count) const {
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < p_count; i += 1) {
+		if (p_components[i] == UINT32_MAX) {
+			// This is the `EntityID`.
+			continue;
+		}
+		if (components.find(p_components[i]) == -1) {
+			return false;
+		}
+		count += 1;
+	}
+	return count == components.size();
+}
+
+void *DenseGroup::get_data(godex::component_id p_component) const {
+	const int64_t index = components.find(p_component);
+	ERR_FAIL_COND_V_MSG(index == -1, nullptr, "The component " + itos(p_component) + " is not part of this group.");
+	return storages[index]->group_get_data();
+}
+
+void DenseGroup::pack() {
+	size = 0;
+
+	// Copy the `Entities` first, since packing reorders them.
+	LocalVector<EntityID> entities;
+	entities.resize(storages[0]->group_get_count());
+	const EntityID *ptr = storages[0]->group_get_entities();
+	for (uint32_t i = 0; i < entities.size(); i += 1) {
+		entities[i] = ptr[i];
+	}
+
+	for (uint32_t i = 0; i < entities.size(); i += 1) {
+		notify_inserted(entities[i]);
+	}
+}
+
+void DenseGroup::notify_inserted(EntityID p_entity) {
+	for (uint32_t i = 0; i < storages.size(); i += 1) {
+		if (storages[i]->group_get_index(p_entity) == UINT32_MAX) {
+			// This `Entity` doesn't have all the components yet.
+			return;
+		}
+	}
+
+	if (storages[0]->group_get_index(p_entity) < size) {
+		// Already packed.
+		return;
+	}
+
+	for (uint32_t i = 0; i < storages.size(); i += 1) {
+		const uint32_t index = storages[i]->group_get_index(p_entity);
+		if (index != size) {
+			storages[i]->group_swap(index, size);
+		}
+	}
+	size += 1;
+}
+
+void DenseGroup::notify_removed(EntityID p_entity) {
+	const uint32_t index = storages[0]->group_get_index(p_entity);
+	if (index == UINT32_MAX || index >= size) {
+		// Not packed, nothing to do.
+		return;
+	}
+
+	// Move it right after the packed range.
+	size -= 1;
+	for (uint32_t i = 0; i < storages.size(); i += 1) {
+		const uint32_t current = storages[i]->group_get_index(p_entity);
+		if (current != size) {
+			storages[i]->group_swap(current, size);
+		}
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "core/templates/local_vector.h"
+#include "storage.h"
+
+class DenseGroup;
+
+/// Base class of the storages that can be part of a `DenseGroup`: the
+/// `DenseGroup` uses it to reorder the storage data.
+class DenseGroupStorage {
+	friend class World;
+
+protected:
+	DenseGroup *group = nullptr;
+
+public:
+	virtual ~DenseGroupStorage() {}
+
+	DenseGroup *get_group() const {
+		return group;
+	}
+
+	/// Returns the position of this `Entity` in the storage, or `UINT32_MAX`.
+	virtual uint32_t group_get_index(EntityID p_entity) const = 0;
+	/// Swaps the data (and the `Entities`) stored at these two positions.
+	virtual void group_swap(uint32_t p_index_a, uint32_t p_index_b) = 0;
+	/// Amount of stored `Entities`.
+	virtual uint32_t group_get_count() const = 0;
+	/// The `Entities`, in the same order of the data.
+	virtual const EntityID *group_get_entities() const = 0;
+	/// Pointer to the data, stored contiguously.
+	virtual void *group_get_data() = 0;
+};
+
+/// Owning group: keeps two or more storages co-sorted, so that the `Entities`
+/// having all the grouped components are packed at the front of each storage,
+/// in the same order.
+/// The `Query` that fetches exactly the grouped components iterates this
+/// packed range linearly, without any lookup or `has` check.
+///
+/// The storages notify the group each time a component is inserted or
+/// removed, and the group moves the `Entity` in or out the packed range.
+class DenseGroup {
+	/// The grouped components, in the same order of `storages`.
+	LocalVector<godex::component_id> components;
+	LocalVector<DenseGroupStorage *> storages;
+	/// Amount of `Entities` in the packed range.
+	uint32_t size = 0;
+
+public:
+	DenseGroup(const LocalVector<godex::component_id> &p_components, const LocalVector<DenseGroupStorage *> &p_storages);
+
+	const LocalVector<godex::component_id> &get_components() const {
+		return components;
+	}
+
+	/// Returns `true` when this group has exactly these components.
+	/// The `UINT32_MAX` IDs are ignored.
+	bool matches(const godex::component_id *p_components, uint32_t p_count) const;
+
+	/// Amount of `Entities` that have all the grouped components.
+	uint32_t get_size() const {
+		return size;
+	}
+
+	/// The packed `Entities`; valid up to `get_size()`.
+	const EntityID *get_entities() const {
+		return storages[0]->group_get_entities();
+	}
+
+	/// The packed data of this component; valid up to `get_size()`.
+	void *get_data(godex::component_id p_component) const;
+
+	/// Moves all the `Entities` that have the grouped components in the
+	/// packed range.
+	void pack();
+
+	/// Must be called after the component is inserted.
+	void notify_inserted(EntityID p_entity);
+
+	/// Must be called before the component is removed.
+	void notify_removed(EntityID p_entity);
+
+	/// Must be called when a grouped storage is cleared.
+	void notify_cleared() {
+		size = 0;
+	}
+};
+
+/// Returns `true` when the component `C` uses a storage that can be grouped.
+template <typename C, typename = void>
+struct godex_is_group_component : std::false_type {};
+
+template <typename C>
+struct godex_is_group_component<C, std::enable_if_t<std::is_base_of<DenseGroupStorage, std::remove_pointer_t<decltype(std::remove_const_t<C>::create_storage())>>::value>> : std::true_type {};
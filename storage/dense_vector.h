@@ -2,77 +2,202 @@
 
 #include "../ecs.h"
 #include "core/templates/local_vector.h"
+#include "paged_sparse_index.h"
 #include "storage.h"
 
 template <class T>
 class DenseVector {
+public:
+	/// Returns `true` when `p_a` goes before `p_b`, see `set_sort_key`.
+	typedef bool (*SortKey)(const T &p_a, const T &p_b);
+
 protected:
 	LocalVector<T> data;
 	LocalVector<EntityID> data_to_entity;
-	// Each position of this vector is an Entity Index.
-	LocalVector<uint32_t> entity_to_data;
+	// Sparse index, points each Entity to its data.
+	PagedSparseIndex entity_to_data;
+	/// The amount of elements reserved by `configure`.
+	uint32_t reserved = 0;
+	/// The most elements stored at once: the memory is never released, so
+	/// this is the capacity.
+	uint32_t peak_size = 0;
+
+	/// The order used by `compact`: by `EntityID` when `nullptr`.
+	SortKey sort_key = nullptr;
+	/// `true` when the data is in `compact` order.
+	bool is_sorted = true;
+
+	/// The steps of the `compact` pass, each one done in slices.
+	enum CompactPhase {
+		COMPACT_IDLE,
+		/// Copies the `Entities` into `compact_order`.
+		COMPACT_COPY,
+		/// Sorts each `COMPACT_RUN_SIZE` long run of `compact_order`.
+		COMPACT_SORT_RUNS,
+		/// Merges the sorted runs, doubling their size each time.
+		COMPACT_MERGE,
+		/// Moves each `Entity` to its position.
+		COMPACT_MOVE,
+		/// Checks the `Entities` inserted while the pass was in progress.
+		COMPACT_CHECK,
+	};
+	static constexpr uint32_t COMPACT_RUN_SIZE = 16;
+
+	CompactPhase compact_phase = COMPACT_IDLE;
+	/// The `Entities` in `compact` order, while the pass is in progress.
+	LocalVector<EntityID> compact_order;
+	/// The merge output, swapped with `compact_order` at each merge step.
+	LocalVector<EntityID> compact_scratch;
+	/// The position the current phase continues from.
+	uint32_t compact_cursor = 0;
+	/// The size of the sorted runs being merged.
+	uint32_t compact_width = 0;
+	/// The next element of each of the two runs being merged.
+	uint32_t compact_merge_a = 0;
+	uint32_t compact_merge_b = 0;
+	/// The data before this position is in its final order.
+	uint32_t compact_placed = 0;
 
 public:
 	void insert(EntityID p_entity, const T &p_data) {
+		const uint32_t existing = entity_to_data.get(p_entity);
+		if (existing != UINT32_MAX) {
+			// Already stored, just update the data.
+			data[existing] = p_data;
+			return;
+		}
+
 		const uint32_t index = data.size();
 		insert_entity(p_entity, index);
 
 		// Store the data
 		data.push_back(p_data);
 		data_to_entity.push_back(p_entity);
+		track_order(index);
+	}
+
+	/// Inserts `p_count` elements, reserving the memory once.
+	/// `p_data` has `p_count` elements, or just one used for all the
+	/// `Entities` when `p_data_stride` is `0`.
+	void insert_batch(const EntityID *p_entities, uint32_t p_count, const T *p_data, uint32_t p_data_stride) {
+		data.reserve(data.size() + p_count);
+		data_to_entity.reserve(data_to_entity.size() + p_count);
+
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			const T &d = p_data[i * p_data_stride];
+			const uint32_t index = entity_to_data.get(p_entities[i]);
+			if (index != UINT32_MAX) {
+				// Already stored, just update the data.
+				data[index] = d;
+			} else {
+				const uint32_t new_index = data.size();
+				insert_entity(p_entities[i], new_index);
+				data.push_back(d);
+				data_to_entity.push_back(p_entities[i]);
+				track_order(new_index);
+			}
+		}
 	}
 
 	bool has(EntityID p_entity) const {
-		return p_entity < entity_to_data.size() && entity_to_data[p_entity] != UINT32_MAX;
+		return entity_to_data.has(p_entity);
 	}
 
 	const T &get(EntityID p_entity) const {
 #ifdef DEBUG_ENABLED
 		CRASH_COND_MSG(has(p_entity) == false, "This entity doesn't have anything stored into this storage.");
 #endif
-		return data[entity_to_data[p_entity]];
+		return data[entity_to_data.get_unchecked(p_entity)];
 	}
 
 	T &get(EntityID p_entity) {
 #ifdef DEBUG_ENABLED
 		CRASH_COND_MSG(has(p_entity) == false, "This entity doesn't have anything stored into this storage.");
 #endif
-		return data[entity_to_data[p_entity]];
+		return data[entity_to_data.get_unchecked(p_entity)];
 	}
 
 	void remove(EntityID p_entity) {
 		ERR_FAIL_COND_MSG(has(p_entity) == false, "This entity doesn't have anything stored into this storage.");
 
 		const uint32_t last = data.size() - 1;
+		const uint32_t index = entity_to_data.get_unchecked(p_entity);
 
-		if (entity_to_data[p_entity] != last) {
-			// This entity is the last one, so swap the alst with the current one
-			// to remove.
+		// The slot to fill with the last element.
+		uint32_t hole = index;
+		if (index < compact_placed) {
+			// The compaction in progress already placed this entity: shift
+			// the placed ones after it, so they stay in order.
+			for (uint32_t i = index; i + 1 < compact_placed; i += 1) {
+				data[i] = data[i + 1];
+				data_to_entity[i] = data_to_entity[i + 1];
+				entity_to_data.update(data_to_entity[i], i);
+			}
+			compact_placed -= 1;
+			hole = compact_placed;
+		}
+
+		if (hole != last) {
+			// This entity is not the last one, so swap the last with the
+			// current one to remove.
 
 			// Copy the last array element on the data element to remove.
-			data[entity_to_data[p_entity]] = data[last];
+			data[hole] = data[last];
 
 			// Make sure the entity for the last array element, points to the right slot.
-			entity_to_data[data_to_entity[last]] = entity_to_data[p_entity];
+			entity_to_data.update(data_to_entity[last], hole);
 
 			// Now updated the data to entity by simply coping what's in the last.
-			data_to_entity[entity_to_data[p_entity]] = data_to_entity[last];
+			data_to_entity[hole] = data_to_entity[last];
+
+			// The order is lost, the compaction in progress keeps going.
+			is_sorted = false;
+			if (compact_phase == COMPACT_COPY && hole < compact_cursor && last >= compact_cursor) {
+				// The copy already passed this slot, copy the moved entity now.
+				compact_order.push_back(data_to_entity[hole]);
+			} else if (compact_phase == COMPACT_CHECK) {
+				// Check the moved entity too.
+				compact_cursor = MAX(MIN(compact_cursor, hole), uint32_t(1));
+			}
 		}
 
 		data.remove_at(last);
 		data_to_entity.remove_at(last);
-		entity_to_data[p_entity] = UINT32_MAX;
+		entity_to_data.unset(p_entity);
 	}
 
 	const LocalVector<EntityID> &get_entities() const {
 		return data_to_entity;
 	}
 
+	/// Returns the position of the `Entity` data, or `UINT32_MAX`.
+	uint32_t get_index(EntityID p_entity) const {
+		return entity_to_data.get(p_entity);
+	}
+
+	/// Swaps the data stored at these two positions, keeping the `Entities`
+	/// mapping updated.
+	void swap(uint32_t p_index_a, uint32_t p_index_b) {
+		swap_data(p_index_a, p_index_b);
+		is_sorted = false;
+		cancel_compact();
+	}
+
+	T *get_data_ptr() {
+		return data.ptr();
+	}
+
+	const T *get_data_ptr() const {
+		return data.ptr();
+	}
+
 	/// Clear the storage.
 	void clear() {
 		data.clear();
 		data_to_entity.clear();
 		entity_to_data.clear();
+		is_sorted = true;
+		cancel_compact();
 	}
 
 	/// Reset the storage unallocating the memory.
@@ -80,6 +205,10 @@ public:
 		data.reset();
 		data_to_entity.reset();
 		entity_to_data.reset();
+		reserved = 0;
+		peak_size = 0;
+		is_sorted = true;
+		cancel_compact();
 	}
 
 	/// Preallocate a given size, avoid useless allocations.
@@ -91,25 +220,298 @@ public:
 		data.reserve(p_reserve);
 		data_to_entity.reserve(p_reserve);
 		entity_to_data.reserve(p_reserve);
+		reserved = p_reserve;
+	}
+
+	void add_memory_stats(StorageMemoryStats &r_stats) const {
+		r_stats.add_vector(data, MAX(reserved, peak_size));
+		r_stats.add_vector(data_to_entity, MAX(reserved, peak_size));
+		r_stats.add_vector(compact_order);
+		r_stats.add_vector(compact_scratch);
+		entity_to_data.add_memory_stats(r_stats);
+	}
+
+	/// Sets the order used by `compact`, by default the data is sorted by
+	/// `EntityID`. The `Entities` that have the same key are sorted by
+	/// `EntityID`.
+	/// Note: changing the data doesn't invalidate the order, so the storage
+	/// is sorted again only after an `Entity` is inserted or removed.
+	void set_sort_key(SortKey p_sort_key) {
+		sort_key = p_sort_key;
+		is_sorted = data.size() == 0;
+		cancel_compact();
+	}
+
+	/// Returns `true` if the data is in the `compact` order.
+	bool is_compact_sorted() const {
+		return is_sorted;
+	}
+
+	/// Sorts the data and releases the over-reserved memory, doing at most
+	/// `r_budget` units of work (about one element compared or moved each):
+	/// the pass continues on the next call, so it's possible to spread it
+	/// across many frames. The order is computed by a merge sort, done in
+	/// slices too.
+	/// The work done is subtracted from `r_budget`; returns `false` only when
+	/// out of budget, `true` once the pass is done.
+	///
+	/// Note: the memory is released at the end, in a single step not bounded
+	/// by the budget. Inserting or removing an `Entity` while the pass is in
+	/// progress doesn't restart it; removing an `Entity` the pass already
+	/// placed shifts the placed ones after it. When the `Entities` inserted
+	/// during the pass are out of order, the pass returns `true` with
+	/// `is_compact_sorted() == false`: the next call sorts them.
+	bool compact(uint32_t &r_budget) {
+		if (is_sorted) {
+			if (peak_size > MAX(reserved, data.size() * 2)) {
+				if (r_budget == 0) {
+					return false;
+				}
+				r_budget -= MIN(r_budget, data.size());
+				shrink();
+			}
+			return true;
+		}
+
+		switch (compact_phase) {
+			case COMPACT_IDLE:
+				compact_order.clear();
+				compact_cursor = 0;
+				compact_phase = COMPACT_COPY;
+				[[fallthrough]];
+			case COMPACT_COPY:
+				if (compact_copy(r_budget) == false) {
+					return false;
+				}
+				compact_cursor = 0;
+				compact_phase = COMPACT_SORT_RUNS;
+				[[fallthrough]];
+			case COMPACT_SORT_RUNS:
+				if (compact_sort_runs(r_budget) == false) {
+					return false;
+				}
+				compact_scratch.resize(compact_order.size());
+				compact_width = COMPACT_RUN_SIZE;
+				compact_cursor = 0;
+				compact_merge_a = 0;
+				compact_merge_b = MIN(compact_width, compact_order.size());
+				compact_phase = COMPACT_MERGE;
+				[[fallthrough]];
+			case COMPACT_MERGE:
+				if (compact_merge(r_budget) == false) {
+					return false;
+				}
+				compact_cursor = 0;
+				compact_placed = 0;
+				compact_phase = COMPACT_MOVE;
+				[[fallthrough]];
+			case COMPACT_MOVE:
+				if (compact_move(r_budget) == false) {
+					return false;
+				}
+				compact_cursor = MAX(compact_placed, uint32_t(1));
+				compact_phase = COMPACT_CHECK;
+				[[fallthrough]];
+			case COMPACT_CHECK:
+				if (compact_check(r_budget) == false) {
+					return false;
+				}
+		}
 
-		entity_to_data.resize(p_reserve);
-		for (uint32_t i = 0; i < p_reserve; i += 1) {
-			entity_to_data[i] = UINT32_MAX;
+		const bool sorted = is_sorted;
+		cancel_compact();
+		if (sorted == false) {
+			// The `Entities` inserted meanwhile are out of order: the pass is
+			// done anyway, so the caller moves on and the next call starts a
+			// new pass.
+			return true;
 		}
+		return compact(r_budget);
 	}
 
 protected:
 	void insert_entity(EntityID p_entity, uint32_t p_index) {
-		if (entity_to_data.size() <= p_entity) {
-			const uint32_t start = entity_to_data.size();
-			// Resize the vector so to fit this new entity.
-			entity_to_data.resize(p_entity + 1);
-			for (uint32_t i = start; i < entity_to_data.size(); i += 1) {
-				entity_to_data[i] = UINT32_MAX;
+		// Store the data-index
+		entity_to_data.set(p_entity, p_index);
+	}
+
+	/// Must be called after the data is pushed at `p_index`.
+	void track_order(uint32_t p_index) {
+		if (is_sorted && p_index > 0 && is_before(p_index, p_index - 1)) {
+			is_sorted = false;
+		}
+		peak_size = MAX(peak_size, data.size());
+	}
+
+	/// Returns `true` if the data at `p_a` goes before the data at `p_b`.
+	bool is_before(uint32_t p_a, uint32_t p_b) const {
+		if (sort_key != nullptr) {
+			if (sort_key(data[p_a], data[p_b])) {
+				return true;
+			}
+			if (sort_key(data[p_b], data[p_a])) {
+				return false;
 			}
 		}
+		return uint32_t(data_to_entity[p_a]) < uint32_t(data_to_entity[p_b]);
+	}
 
-		// Store the data-index
-		entity_to_data[p_entity] = p_index;
+	void swap_data(uint32_t p_index_a, uint32_t p_index_b) {
+		SWAP(data[p_index_a], data[p_index_b]);
+		SWAP(data_to_entity[p_index_a], data_to_entity[p_index_b]);
+		entity_to_data.update(data_to_entity[p_index_a], p_index_a);
+		entity_to_data.update(data_to_entity[p_index_b], p_index_b);
+	}
+
+	/// Returns `true` if the data of `p_a` goes before the data of `p_b`.
+	/// The `Entities` removed while the pass is in progress go first: so
+	/// the merge takes them as soon as they are met, and the order of the
+	/// others stays consistent.
+	bool is_entity_before(EntityID p_a, EntityID p_b) const {
+		if (sort_key == nullptr) {
+			// The `EntityID`s never change, even if removed meanwhile.
+			return uint32_t(p_a) < uint32_t(p_b);
+		}
+		const uint32_t index_a = entity_to_data.get(p_a);
+		const uint32_t index_b = entity_to_data.get(p_b);
+		if (index_a == UINT32_MAX) {
+			return true;
+		}
+		return index_b != UINT32_MAX && is_before(index_a, index_b);
+	}
+
+	bool compact_copy(uint32_t &r_budget) {
+		while (compact_cursor < data_to_entity.size()) {
+			if (r_budget == 0) {
+				return false;
+			}
+			r_budget -= 1;
+			compact_order.push_back(data_to_entity[compact_cursor]);
+			compact_cursor += 1;
+		}
+		return true;
+	}
+
+	bool compact_sort_runs(uint32_t &r_budget) {
+		const uint32_t size = compact_order.size();
+		while (compact_cursor < size) {
+			if (r_budget == 0) {
+				return false;
+			}
+			// Insertion sort, the run is short.
+			const uint32_t end = MIN(compact_cursor + COMPACT_RUN_SIZE, size);
+			uint32_t work = 1;
+			for (uint32_t i = compact_cursor + 1; i < end; i += 1) {
+				const EntityID entity = compact_order[i];
+				uint32_t j = i;
+				while (j > compact_cursor) {
+					work += 1;
+					if (is_entity_before(entity, compact_order[j - 1]) == false) {
+						break;
+					}
+					compact_order[j] = compact_order[j - 1];
+					j -= 1;
+				}
+				compact_order[j] = entity;
+			}
+			r_budget -= MIN(r_budget, work);
+			compact_cursor = end;
+		}
+		return true;
+	}
+
+	bool compact_merge(uint32_t &r_budget) {
+		const uint32_t size = compact_order.size();
+		while (compact_width < size) {
+			while (compact_cursor < size) {
+				// Merge the runs `[cursor, middle)` and `[middle, end)`.
+				const uint32_t middle = MIN(compact_cursor + compact_width, size);
+				const uint32_t end = MIN(compact_cursor + compact_width * 2, size);
+				while (compact_merge_a < middle || compact_merge_b < end) {
+					if (r_budget == 0) {
+						return false;
+					}
+					r_budget -= 1;
+					const uint32_t target = compact_merge_a + compact_merge_b - middle;
+					if (compact_merge_b >= end || (compact_merge_a < middle && is_entity_before(compact_order[compact_merge_b], compact_order[compact_merge_a]) == false)) {
+						compact_scratch[target] = compact_order[compact_merge_a];
+						compact_merge_a += 1;
+					} else {
+						compact_scratch[target] = compact_order[compact_merge_b];
+						compact_merge_b += 1;
+					}
+				}
+				compact_cursor = end;
+				compact_merge_a = end;
+				compact_merge_b = MIN(end + compact_width, size);
+			}
+			SWAP(compact_order, compact_scratch);
+			compact_width *= 2;
+			compact_cursor = 0;
+			compact_merge_a = 0;
+			compact_merge_b = MIN(compact_width, size);
+		}
+		return true;
+	}
+
+	bool compact_move(uint32_t &r_budget) {
+		while (compact_cursor < compact_order.size()) {
+			if (r_budget == 0) {
+				return false;
+			}
+			r_budget -= 1;
+			const uint32_t index = entity_to_data.get(compact_order[compact_cursor]);
+			compact_cursor += 1;
+			if (index == UINT32_MAX || index < compact_placed) {
+				// Removed meanwhile, or already placed.
+				continue;
+			}
+			if (index != compact_placed) {
+				swap_data(compact_placed, index);
+			}
+			compact_placed += 1;
+		}
+		return true;
+	}
+
+	bool compact_check(uint32_t &r_budget) {
+		// Only the `Entities` not placed by the pass may be out of order.
+		while (compact_cursor < data.size()) {
+			if (r_budget == 0) {
+				return false;
+			}
+			r_budget -= 1;
+			if (is_before(compact_cursor, compact_cursor - 1)) {
+				// Still `is_sorted == false`.
+				return true;
+			}
+			compact_cursor += 1;
+		}
+		is_sorted = true;
+		return true;
+	}
+
+	void cancel_compact() {
+		compact_phase = COMPACT_IDLE;
+		compact_order.reset();
+		compact_scratch.reset();
+		compact_cursor = 0;
+		compact_placed = 0;
+	}
+
+	/// Reallocates the data to fit the stored elements.
+	void shrink() {
+		const uint32_t size = MAX(reserved, data.size());
+		const LocalVector<T> data_copy = data;
+		const LocalVector<EntityID> entities_copy = data_to_entity;
+		data.reset();
+		data_to_entity.reset();
+		data.reserve(size);
+		data_to_entity.reserve(size);
+		for (uint32_t i = 0; i < data_copy.size(); i += 1) {
+			data.push_back(data_copy[i]);
+			data_to_entity.push_back(entities_copy[i]);
+		}
+		peak_size = data.size();
 	}
 };
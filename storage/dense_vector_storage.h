@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../ecs.h"
+#include "dense_group.h"
 #include "dense_vector.h"
 #include "storage.h"
 
@@ -8,8 +9,10 @@
 /// Has a redirection 2-way table between entities and
 /// components (vice versa), allowing to leave no gaps within the data.
 /// The the entity indices are stored sparsely.
+///
+/// It can be part of a `DenseGroup`, check `World::create_group`.
 template <class T>
-class DenseVectorStorage : public Storage<T> {
+class DenseVectorStorage : public Storage<T>, public DenseGroupStorage {
 protected:
 	DenseVector<T> storage;
 
@@ -24,8 +27,46 @@ public:
 	}
 
 	virtual void insert(EntityID p_entity, const T &p_data) override {
+		if (storage.has(p_entity)) {
+			// Already stored, only the data changes.
+			storage.insert(p_entity, p_data);
+			StorageBase::notify_changed(p_entity);
+			return;
+		}
 		storage.insert(p_entity, p_data);
-		StorageBase::notify_changed(p_entity);
+		if (group) {
+			group->notify_inserted(p_entity);
+		}
+		StorageBase::notify_inserted(p_entity);
+	}
+
+	virtual void insert_batch(const EntityID *p_entities, const T *p_data, uint32_t p_count) override {
+		if (has_any(p_entities, p_count)) {
+			// Some are only overwritten, so notify each one on its own.
+			for (uint32_t i = 0; i < p_count; i += 1) {
+				insert(p_entities[i], p_data[i]);
+			}
+			return;
+		}
+		storage.insert_batch(p_entities, p_count, p_data, 1);
+		notify_group_inserted(p_entities, p_count);
+		StorageBase::notify_inserted(p_entities, p_count);
+	}
+
+	virtual void insert_batch(const EntityID *p_entities, const T &p_data, uint32_t p_count) override {
+		if (has_any(p_entities, p_count)) {
+			for (uint32_t i = 0; i < p_count; i += 1) {
+				insert(p_entities[i], p_data);
+			}
+			return;
+		}
+		storage.insert_batch(p_entities, p_count, &p_data, 0);
+		notify_group_inserted(p_entities, p_count);
+		StorageBase::notify_inserted(p_entities, p_count);
+	}
+
+	virtual bool is_tracking_entities() const override {
+		return true;
 	}
 
 	virtual bool has(EntityID p_entity) const override {
@@ -42,19 +83,95 @@ public:
 	}
 
 	virtual void remove(EntityID p_entity) override {
+		if (group) {
+			// Move it out of the packed range, before removing it.
+			group->notify_removed(p_entity);
+		}
 		storage.remove(p_entity);
 		// Make sure to remove as changed.
-		StorageBase::notify_updated(p_entity);
+		StorageBase::notify_removed(p_entity);
+	}
+
+	virtual void remove_batch(const EntityID *p_entities, uint32_t p_count) override {
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			if (group) {
+				group->notify_removed(p_entities[i]);
+			}
+			storage.remove(p_entities[i]);
+		}
+		StorageBase::notify_removed(p_entities, p_count);
 	}
 
 	virtual void clear() override {
+		StorageBase::notify_clearing();
 		storage.clear();
-		StorageBase::flush_changed();
+		if (group) {
+			group->notify_cleared();
+		}
+		StorageBase::notify_cleared();
 	}
 
 	virtual EntitiesBuffer get_stored_entities() const {
 		return { storage.get_entities().size(), storage.get_entities().ptr() };
 	}
+
+	virtual bool compact(uint32_t &r_budget) override {
+		if (group) {
+			// The `DenseGroup` keeps the grouped storages in its own order.
+			return true;
+		}
+		return storage.compact(r_budget);
+	}
+
+	/// Sets the order used by `compact`, by default the components are sorted
+	/// by `EntityID`.
+	void set_sort_key(typename DenseVector<T>::SortKey p_sort_key) {
+		storage.set_sort_key(p_sort_key);
+	}
+
+	virtual StorageMemoryStats get_memory_stats() const override {
+		StorageMemoryStats stats = StorageBase::get_memory_stats();
+		storage.add_memory_stats(stats);
+		return stats;
+	}
+
+	virtual uint32_t group_get_index(EntityID p_entity) const override {
+		return storage.get_index(p_entity);
+	}
+
+	virtual void group_swap(uint32_t p_index_a, uint32_t p_index_b) override {
+		storage.swap(p_index_a, p_index_b);
+	}
+
+	virtual uint32_t group_get_count() const override {
+		return storage.get_entities().size();
+	}
+
+	virtual const EntityID *group_get_entities() const override {
+		return storage.get_entities().ptr();
+	}
+
+	virtual void *group_get_data() override {
+		return storage.get_data_ptr();
+	}
+
+private:
+	bool has_any(const EntityID *p_entities, uint32_t p_count) const {
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			if (storage.has(p_entities[i])) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void notify_group_inserted(const EntityID *p_entities, uint32_t p_count) {
+		if (group) {
+			for (uint32_t i = 0; i < p_count; i += 1) {
+				group->notify_inserted(p_entities[i]);
+			}
+		}
+	}
 };
 
 template <class T>
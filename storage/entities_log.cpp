@@ -0,0 +1,86 @@
+#include "entities_log.h"
+
+void EntitiesLog::log(EntityID p_entity, uint32_t p_tick) {
+	const uint32_t position = positions.get(p_entity);
+	if (position != UINT32_MAX) {
+		// Already logged, drop the old entry.
+		entities[position] = EntityID();
+		positions.update(p_entity, entities.size());
+	} else {
+		positions.set(p_entity, entities.size());
+	}
+	entities.push_back(p_entity);
+	ticks.push_back(p_tick);
+}
+
+void EntitiesLog::get_window(uint32_t p_since_tick, uint32_t p_until_tick, const EntityID *&r_entities, uint32_t &r_count) const {
+	const uint32_t begin = find_after(p_since_tick);
+	const uint32_t end = find_after(p_until_tick);
+	r_entities = entities.ptr() + begin;
+	r_count = end > begin ? end - begin : 0;
+}
+
+void EntitiesLog::trim(uint32_t p_tick) {
+	const uint32_t count = find_after(p_tick);
+	if (count == 0) {
+		// Nothing to drop.
+		return;
+	}
+
+	for (uint32_t i = 0; i < count; i += 1) {
+		if (entities[i].is_valid()) {
+			positions.unset(entities[i]);
+		}
+	}
+
+	// Move the kept entries to the front.
+	const uint32_t kept = entities.size() - count;
+	for (uint32_t i = 0; i < kept; i += 1) {
+		entities[i] = entities[count + i];
+		ticks[i] = ticks[count + i];
+		if (entities[i].is_valid()) {
+			positions.update(entities[i], i);
+		}
+	}
+	entities.resize(kept);
+	ticks.resize(kept);
+}
+
+void EntitiesLog::clamp_ticks(uint32_t p_oldest_tick) {
+	// The ticks never decrease, so the old entries are at the front and stay
+	// in order once clamped.
+	for (uint32_t i = 0; i < ticks.size(); i += 1) {
+		if (int32_t(ticks[i] - p_oldest_tick) >= 0) {
+			break;
+		}
+		ticks[i] = p_oldest_tick;
+	}
+}
+
+void EntitiesLog::clear() {
+	entities.clear();
+	ticks.clear();
+	positions.clear();
+}
+
+void EntitiesLog::add_memory_stats(StorageMemoryStats &r_stats) const {
+	r_stats.add_vector(entities);
+	r_stats.add_vector(ticks);
+	positions.add_memory_stats(r_stats);
+}
+
+uint32_t EntitiesLog::find_after(uint32_t p_tick) const {
+	// The ticks never decrease, so binary search the first one after
+	// `p_tick`. Wrapping compare, so the ticks can overflow.
+	uint32_t low = 0;
+	uint32_t high = ticks.size();
+	while (low < high) {
+		const uint32_t middle = low + (high - low) / 2;
+		if (int32_t(ticks[middle] - p_tick) > 0) {
+			high = middle;
+		} else {
+			low = middle + 1;
+		}
+	}
+	return low;
+}
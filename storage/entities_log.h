@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../ecs_types.h"
+#include "core/templates/local_vector.h"
+#include "memory_stats.h"
+#include "paged_sparse_index.h"
+
+/// The `Entities` that gained, or lost, the component of a storage, each one
+/// with the change tick at which it happened. The `Added` and `Removed`
+/// filters iterate only the `Entities` logged since their last run, rather
+/// than all the stored `Entities`.
+///
+/// The entries are appended in tick order, so the entries of a tick window
+/// are contiguous. An `Entity` is logged once: logging it again replaces the
+/// old entry with a null `EntityID`, that the filters skip.
+/// The log grows until `trim` drops the old entries, check
+/// `World::trim_entities_logs`.
+class EntitiesLog {
+	LocalVector<EntityID> entities;
+	/// The tick of each entry, never decreasing.
+	LocalVector<uint32_t> ticks;
+	/// `Entity` -> position into `entities`.
+	PagedSparseIndex positions;
+
+public:
+	/// Logs this `Entity` at `p_tick`, that must not be older than the tick of
+	/// the last entry.
+	void log(EntityID p_entity, uint32_t p_tick);
+
+	/// Returns `true` if this `Entity` was logged after `p_since_tick` and not
+	/// after `p_until_tick`.
+	bool is_logged(EntityID p_entity, uint32_t p_since_tick, uint32_t p_until_tick) const {
+		const uint32_t position = positions.get(p_entity);
+		if (position == UINT32_MAX || entities[position].get_raw() != p_entity.get_raw()) {
+			return false;
+		}
+		// Wrapping compare, so the ticks can overflow.
+		return int32_t(ticks[position] - p_since_tick) > 0 && int32_t(p_until_tick - ticks[position]) >= 0;
+	}
+
+	/// Returns the entries logged after `p_since_tick` and not after
+	/// `p_until_tick`, they may contain null `EntityID`s.
+	void get_window(uint32_t p_since_tick, uint32_t p_until_tick, const EntityID *&r_entities, uint32_t &r_count) const;
+
+	/// Drops the entries logged at `p_tick` or before.
+	void trim(uint32_t p_tick);
+
+	/// Moves the entries logged before `p_oldest_tick` to it, so the ticks
+	/// never get too old to be compared. Check `World::check_change_ticks`.
+	void clamp_ticks(uint32_t p_oldest_tick);
+
+	void clear();
+
+	/// Returns the amount of entries, including the null ones.
+	uint32_t size() const {
+		return entities.size();
+	}
+
+	void add_memory_stats(StorageMemoryStats &r_stats) const;
+
+private:
+	/// Returns the position of the first entry logged after `p_tick`.
+	uint32_t find_after(uint32_t p_tick) const;
+};
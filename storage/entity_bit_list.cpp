@@ -0,0 +1,102 @@
+#include "entity_bit_list.h"
+
+void EntityBitList::insert(const EntityID *p_entities, uint32_t p_count) {
+	for (uint32_t i = 0; i < p_count; i += 1) {
+		insert(p_entities[i]);
+	}
+}
+
+void EntityBitList::remove(EntityID p_entity) {
+	if (has(p_entity) == false) {
+		// Nothing to do.
+		return;
+	}
+
+	const uint32_t word = uint32_t(p_entity) >> 6;
+	bits[word] &= ~(uint64_t(1) << (uint32_t(p_entity) & 63));
+	if (bits[word] == 0) {
+		summary[word >> 6] &= ~(uint64_t(1) << (word & 63));
+	}
+
+	// Compare the index, since the generation may be different.
+	for (uint32_t i = 0; i < dense_list.size(); i += 1) {
+		if (uint32_t(dense_list[i]) == uint32_t(p_entity)) {
+			dense_list.remove_at_unordered(i);
+			break;
+		}
+	}
+}
+
+void EntityBitList::unite(const EntityBitList &p_other) {
+	if (p_other.bits.size() > bits.size()) {
+		grow(p_other.bits.size() - 1);
+	}
+
+	// Taken from the dense list rather than from the bits, so the `EntityID`
+	// generation is preserved.
+	for (uint32_t i = 0; i < p_other.dense_list.size(); i += 1) {
+		insert(p_other.dense_list[i]);
+	}
+}
+
+void EntityBitList::intersect(const EntityBitList &p_other) {
+	for (uint32_t s = 0; s < summary.size(); s += 1) {
+		uint64_t summary_word = summary[s];
+		while (summary_word != 0) {
+			const uint32_t word = (s << 6) + __builtin_ctzll(summary_word);
+			summary_word &= summary_word - 1;
+
+			bits[word] &= word < p_other.bits.size() ? p_other.bits[word] : 0;
+			if (bits[word] == 0) {
+				summary[s] &= ~(uint64_t(1) << (word & 63));
+			}
+		}
+	}
+
+	// Compact the dense list, preserving the order.
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < dense_list.size(); i += 1) {
+		if (has(dense_list[i])) {
+			dense_list[count] = dense_list[i];
+			count += 1;
+		}
+	}
+	dense_list.resize(count);
+}
+
+void EntityBitList::reserve(uint32_t p_index_limit) {
+	if (p_index_limit > 0 && ((p_index_limit - 1) >> 6) >= bits.size()) {
+		grow((p_index_limit - 1) >> 6);
+	}
+}
+
+void EntityBitList::clear() {
+	for (uint32_t i = 0; i < dense_list.size(); i += 1) {
+		const uint32_t word = uint32_t(dense_list[i]) >> 6;
+		bits[word] = 0;
+		summary[word >> 6] = 0;
+	}
+	dense_list.clear();
+}
+
+void EntityBitList::reset() {
+	bits.reset();
+	summary.reset();
+	dense_list.reset();
+}
+
+void EntityBitList::grow(uint32_t p_word) {
+	const uint32_t start = bits.size();
+	// Grow geometrically, to avoid reallocate each time a bigger ID is inserted.
+	const uint32_t size = MAX(p_word + 1, start * 2);
+	bits.resize(size);
+	for (uint32_t i = start; i < size; i += 1) {
+		bits[i] = 0;
+	}
+
+	const uint32_t summary_start = summary.size();
+	summary.resize((size + 63) >> 6);
+	for (uint32_t i = summary_start; i < summary.size(); i += 1) {
+		summary[i] = 0;
+	}
+}
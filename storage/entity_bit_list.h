@@ -0,0 +1,90 @@
+#pragma once
+
+#include "../ecs_types.h"
+#include "core/templates/local_vector.h"
+
+/// List of `Entities` backed by a two levels bitset and a dense list.
+///
+/// Compared to the `EntityList`:
+/// - `clear` costs as much as the inserted `Entities`, no matter the IDs.
+/// - `intersect` combines two lists operating on 64 `Entities` at once,
+///   skipping the empty areas thanks to the summary level.
+/// - `remove` is O(n), so use this for lists that are built and cleared at
+///   once (like the ones used by the `Any` and `Join` filters).
+///
+/// The iteration order is the insertion order.
+class EntityBitList {
+	/// One bit per `Entity`.
+	LocalVector<uint64_t> bits;
+	/// One bit per `bits` word, set when the word is not zero.
+	LocalVector<uint64_t> summary;
+	/// The inserted `Entities`, used to iterate and to clear.
+	LocalVector<EntityID> dense_list;
+
+public:
+	_FORCE_INLINE_ bool has(EntityID p_entity) const {
+		const uint32_t word = uint32_t(p_entity) >> 6;
+		return word < bits.size() && (bits[word] & (uint64_t(1) << (uint32_t(p_entity) & 63)));
+	}
+
+	/// Inserts the `Entity`, does nothing if already inserted.
+	_FORCE_INLINE_ void insert(EntityID p_entity) {
+		const uint32_t word = uint32_t(p_entity) >> 6;
+		if (unlikely(word >= bits.size())) {
+			grow(word);
+		}
+		const uint64_t mask = uint64_t(1) << (uint32_t(p_entity) & 63);
+		if ((bits[word] & mask) == 0) {
+			bits[word] |= mask;
+			summary[word >> 6] |= uint64_t(1) << (word & 63);
+			dense_list.push_back(p_entity);
+		}
+	}
+
+	/// Inserts all the given `Entities`: the result is the union of the two.
+	void insert(const EntityID *p_entities, uint32_t p_count);
+
+	/// Removes this `Entity`. This is O(n), see the class description.
+	void remove(EntityID p_entity);
+
+	/// Inserts all the `Entities` of `p_other`: the result is the union of the
+	/// two lists.
+	void unite(const EntityBitList &p_other);
+
+	/// Removes all the `Entities` not in `p_other`: the result is the
+	/// intersection of the two lists.
+	void intersect(const EntityBitList &p_other);
+
+	template <typename F>
+	void for_each(F func) const {
+		for (uint32_t i = 0; i < dense_list.size(); i += 1) {
+			func(dense_list[i]);
+		}
+	}
+
+	bool is_empty() const {
+		return dense_list.size() == 0;
+	}
+
+	uint32_t size() const {
+		return dense_list.size();
+	}
+
+	const EntityID *get_entities_ptr() const {
+		return dense_list.ptr();
+	}
+
+	/// Allocates the bits for the `Entities` with index smaller than
+	/// `p_index_limit`, so inserting them doesn't reallocate.
+	void reserve(uint32_t p_index_limit);
+
+	/// Clear the list, the cost depends on the inserted `Entities`.
+	/// The memory is not deallocated, so next frame it will run faster.
+	void clear();
+
+	/// Release the memory completely.
+	void reset();
+
+private:
+	void grow(uint32_t p_word);
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../ecs_types.h"
+#include "paged_sparse_index.h"
 
 /// Container used to mark the `Entity` as changed.
 /// To mark an `Entity` as changed you can use `notify_updated`.
@@ -11,9 +12,9 @@
 class EntityList {
 	/// Set this to true, disable any kind of modification.
 	bool frozen = false;
-	/// Sparse vector, used to easily know if an entity changed.
+	/// Sparse index, used to easily know if an entity changed.
 	/// points to the dense_list element.
-	LocalVector<uint32_t> entity_to_data;
+	PagedSparseIndex entity_to_data;
 
 	/// Used to iterate fast.
 	LocalVector<EntityID> dense_list;
@@ -59,4 +60,6 @@ public:
 	void reset();
 
 	const EntityID *get_entities_ptr() const;
+
+	void add_memory_stats(StorageMemoryStats &r_stats) const;
 };
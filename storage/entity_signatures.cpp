@@ -0,0 +1,109 @@
+#include "entity_signatures.h"
+
+EntitySignatures::EntitySignatures() {
+	// One pointer for each possible page, so the table is never reallocated.
+	pages_count = (EntityID::INDEX_MASK + 1) >> PAGE_BITS;
+	pages = memnew_arr(std::atomic<std::atomic<uint64_t> *>, pages_count);
+	for (uint32_t i = 0; i < pages_count; i += 1) {
+		pages[i].store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+EntitySignatures::~EntitySignatures() {
+	reset();
+	memdelete_arr(pages);
+}
+
+void EntitySignatures::reserve(EntityID p_entity) {
+	const uint32_t page = p_entity.get_index() >> PAGE_BITS;
+	ERR_FAIL_UNSIGNED_INDEX_MSG(page, pages_count, "The Entity " + itos(p_entity) + " is not valid.");
+	if (pages[page].load(std::memory_order_acquire) != nullptr) {
+		// Nothing to do.
+		return;
+	}
+
+	std::atomic<uint64_t> *new_page = allocate_page();
+	std::atomic<uint64_t> *expected = nullptr;
+	if (pages[page].compare_exchange_strong(expected, new_page, std::memory_order_acq_rel, std::memory_order_acquire) == false) {
+		// Another thread allocated it meanwhile.
+		memdelete_arr(new_page);
+	}
+}
+
+void EntitySignatures::set_component_count(uint32_t p_count) {
+	const uint32_t words = MAX(uint32_t(1), (p_count + 63) / 64);
+	if (words <= words_per_entity) {
+		// Nothing to do.
+		return;
+	}
+
+	const uint32_t old_words = words_per_entity;
+	words_per_entity = words;
+
+	// Copy the masks using the new size.
+	for (uint32_t p = 0; p < pages_count; p += 1) {
+		std::atomic<uint64_t> *old_page = pages[p].load(std::memory_order_relaxed);
+		if (old_page == nullptr) {
+			continue;
+		}
+		std::atomic<uint64_t> *page = allocate_page();
+		for (uint32_t i = 0; i < PAGE_SIZE; i += 1) {
+			for (uint32_t w = 0; w < old_words; w += 1) {
+				page[i * words + w].store(old_page[i * old_words + w].load(std::memory_order_relaxed), std::memory_order_relaxed);
+			}
+		}
+		memdelete_arr(old_page);
+		pages[p].store(page, std::memory_order_release);
+	}
+}
+
+void EntitySignatures::clear(EntityID p_entity) {
+	const uint32_t index = p_entity.get_index();
+	if ((index >> PAGE_BITS) >= pages_count) {
+		return;
+	}
+	std::atomic<uint64_t> *page = pages[index >> PAGE_BITS].load(std::memory_order_acquire);
+	if (page == nullptr) {
+		return;
+	}
+	std::atomic<uint64_t> *mask = page + (index & PAGE_MASK) * words_per_entity;
+	for (uint32_t w = 0; w < words_per_entity; w += 1) {
+		mask[w].store(0, std::memory_order_relaxed);
+	}
+}
+
+void EntitySignatures::remove_component(uint32_t p_component_id) {
+	if (p_component_id >= get_component_capacity()) {
+		// Nothing to do.
+		return;
+	}
+	const uint64_t keep = ~(uint64_t(1) << (p_component_id & 63));
+	const uint32_t w = p_component_id >> 6;
+	for (uint32_t p = 0; p < pages_count; p += 1) {
+		std::atomic<uint64_t> *page = pages[p].load(std::memory_order_acquire);
+		if (page == nullptr) {
+			continue;
+		}
+		for (uint32_t i = 0; i < PAGE_SIZE; i += 1) {
+			page[i * words_per_entity + w].fetch_and(keep, std::memory_order_relaxed);
+		}
+	}
+}
+
+void EntitySignatures::reset() {
+	for (uint32_t p = 0; p < pages_count; p += 1) {
+		std::atomic<uint64_t> *page = pages[p].load(std::memory_order_relaxed);
+		if (page != nullptr) {
+			memdelete_arr(page);
+			pages[p].store(nullptr, std::memory_order_relaxed);
+		}
+	}
+}
+
+std::atomic<uint64_t> *EntitySignatures::allocate_page() const {
+	std::atomic<uint64_t> *page = memnew_arr(std::atomic<uint64_t>, PAGE_SIZE * words_per_entity);
+	for (uint32_t i = 0; i < PAGE_SIZE * words_per_entity; i += 1) {
+		page[i].store(0, std::memory_order_relaxed);
+	}
+	return page;
+}
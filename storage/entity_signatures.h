@@ -0,0 +1,120 @@
+#pragma once
+
+#include "../ecs_types.h"
+#include "core/os/memory.h"
+#include <atomic>
+
+/// Stores which components each `Entity` has, using a bitmask per `Entity`.
+/// The `World` uses it to visit only the storages of an `Entity`, when the
+/// `Entity` is destroyed.
+///
+/// The storages update it when a component is inserted or removed; since the
+/// storages of different components can be used by different threads at the
+/// same time, the bits are set atomically.
+/// The memory is divided in pages, allocated when an `Entity` is created:
+/// the page table is never reallocated, and a missing page is published with
+/// a compare and swap, so it's safe to read and write it from multiple
+/// threads.
+class EntitySignatures {
+public:
+	static constexpr uint32_t PAGE_BITS = 12;
+	static constexpr uint32_t PAGE_SIZE = uint32_t(1) << PAGE_BITS;
+	static constexpr uint32_t PAGE_MASK = PAGE_SIZE - 1;
+
+private:
+	/// The number of 64 bits words used by each `Entity`.
+	uint32_t words_per_entity = 1;
+	/// The page table, one pointer for each possible page.
+	std::atomic<std::atomic<uint64_t> *> *pages = nullptr;
+	uint32_t pages_count = 0;
+
+public:
+	EntitySignatures();
+	EntitySignatures(const EntitySignatures &) = delete;
+	EntitySignatures &operator=(const EntitySignatures &) = delete;
+	~EntitySignatures();
+
+	/// Makes sure the memory for this `Entity` is allocated.
+	/// Thread safe: when two threads allocate the same page, only one is kept.
+	void reserve(EntityID p_entity);
+
+	/// Makes sure each mask can store `p_count` components.
+	/// Not thread safe: the `World` calls this when a storage is created.
+	void set_component_count(uint32_t p_count);
+
+	uint32_t get_component_capacity() const {
+		return words_per_entity * 64;
+	}
+
+	_FORCE_INLINE_ void insert(EntityID p_entity, uint32_t p_component_id) {
+		std::atomic<uint64_t> *word = get_word(p_entity, p_component_id);
+		if (unlikely(word == nullptr)) {
+			// This `Entity` was not created by the `World`, `reserve` is thread
+			// safe.
+			reserve(p_entity);
+			word = get_word(p_entity, p_component_id);
+		}
+		word->fetch_or(uint64_t(1) << (p_component_id & 63), std::memory_order_relaxed);
+	}
+
+	_FORCE_INLINE_ void remove(EntityID p_entity, uint32_t p_component_id) {
+		std::atomic<uint64_t> *word = get_word(p_entity, p_component_id);
+		if (word != nullptr) {
+			word->fetch_and(~(uint64_t(1) << (p_component_id & 63)), std::memory_order_relaxed);
+		}
+	}
+
+	_FORCE_INLINE_ bool has(EntityID p_entity, uint32_t p_component_id) const {
+		const std::atomic<uint64_t> *word = get_word(p_entity, p_component_id);
+		return word != nullptr && (word->load(std::memory_order_relaxed) & (uint64_t(1) << (p_component_id & 63)));
+	}
+
+	/// Calls `func` with the ID of each component of this `Entity`.
+	/// It's safe to remove the components while iterating.
+	template <typename F>
+	void for_each(EntityID p_entity, F func) const {
+		const uint32_t index = p_entity.get_index();
+		if ((index >> PAGE_BITS) >= pages_count) {
+			return;
+		}
+		const std::atomic<uint64_t> *page = pages[index >> PAGE_BITS].load(std::memory_order_acquire);
+		if (page == nullptr) {
+			return;
+		}
+		const std::atomic<uint64_t> *mask = page + (index & PAGE_MASK) * words_per_entity;
+		for (uint32_t w = 0; w < words_per_entity; w += 1) {
+			uint64_t bits = mask[w].load(std::memory_order_relaxed);
+			while (bits != 0) {
+				func((w << 6) + __builtin_ctzll(bits));
+				bits &= bits - 1;
+			}
+		}
+	}
+
+	/// Removes all the components of this `Entity`.
+	void clear(EntityID p_entity);
+
+	/// Removes this component from all the `Entities`.
+	void remove_component(uint32_t p_component_id);
+
+	/// Releases all the memory.
+	void reset();
+
+private:
+	_FORCE_INLINE_ std::atomic<uint64_t> *get_word(EntityID p_entity, uint32_t p_component_id) const {
+		const uint32_t index = p_entity.get_index();
+#ifdef DEBUG_ENABLED
+		CRASH_COND_MSG(p_component_id >= get_component_capacity(), "The component " + itos(p_component_id) + " doesn't fit the signature, this is a bug.");
+#endif
+		if (unlikely((index >> PAGE_BITS) >= pages_count)) {
+			return nullptr;
+		}
+		std::atomic<uint64_t> *page = pages[index >> PAGE_BITS].load(std::memory_order_acquire);
+		if (unlikely(page == nullptr)) {
+			return nullptr;
+		}
+		return page + (index & PAGE_MASK) * words_per_entity + (p_component_id >> 6);
+	}
+
+	std::atomic<uint64_t> *allocate_page() const;
+};
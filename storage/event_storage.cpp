@@ -0,0 +1,12 @@
+#include "event_storage.h"
+
+#include "core/templates/safe_refcount.h"
+
+static SafeNumeric<uint32_t> events_thread_slots_count;
+
+uint32_t godex::get_events_thread_slot() {
+	// The slot is assigned once per thread, the threads beyond the available
+	// slots share the last one.
+	thread_local const uint32_t slot = MIN(events_thread_slots_count.postincrement(), EVENTS_THREAD_SLOTS - 1);
+	return slot;
+}
@@ -1,57 +1,192 @@
 #pragma once
 
+#include "../ecs_types.h"
+#include "core/os/spin_lock.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
 #include "core/variant/dictionary.h"
+#include "core/variant/variant.h"
 
+namespace godex {
+/// The amount of threads that can emit the events without locking. The other
+/// threads share the last buffer, which is guarded by a lock.
+constexpr uint32_t EVENTS_THREAD_SLOTS = 32;
+
+/// Returns the slot of the calling thread, assigned the first time this is
+/// called from that thread.
+uint32_t get_events_thread_slot();
+} // namespace godex
+
+/// Each emitter has its own `EmitterId`, assigned when the emitter is added:
+/// the name lookup is done only once, then the events are stored and fetched
+/// using the `EmitterId`.
+///
+/// Each emitter is double buffered: the emitted events are appended to the
+/// pending buffer, while the receivers read the readable buffer, so the
+/// emitters and the receivers can run in parallel. The buffers are swapped by
+/// `swap_events`, that the `Pipeline` calls at the end of each stage emitting
+/// this event.
+/// Each receiver has its own cursor, so a readable event survives until every
+/// registered receiver has read it, even if the receiver runs at a different
+/// rate than the emitter (like a physics sub step). The inactive receivers,
+/// and those idle for more than `MAX_IDLE_SWAPS` swaps, don't keep the events.
+///
+/// Each thread appends to its own pending buffer, so many systems can emit the
+/// same event in parallel. The buffers are merged, in thread slot order, by
+/// `swap_events`.
 class EventStorageBase {
 public:
+	/// A receiver that doesn't read the events for this many swaps, like the
+	/// receiver of a system that is never dispatched, stops keeping them: it
+	/// loses the oldest events.
+	static constexpr uint32_t MAX_IDLE_SWAPS = 64;
+
 	virtual ~EventStorageBase() {
 	}
 
-	virtual void add_event_emitter(const String &p_emitter) {
+	/// Adds the emitter and returns its `EmitterId`.
+	virtual godex::EmitterId add_event_emitter(const String &p_emitter) {
 		CRASH_NOW_MSG("Override this function.");
+		return godex::EMITTER_NONE;
 	}
 
-	virtual bool has_emitter(const String &p_emitter) {
+	/// Returns the `EmitterId` of this emitter, or `EMITTER_NONE` if the emitter
+	/// doesn't exist.
+	virtual godex::EmitterId get_emitter_id(const String &p_emitter) const {
 		CRASH_NOW_MSG("Override this function.");
-		return false;
+		return godex::EMITTER_NONE;
+	}
+
+	bool has_emitter(const String &p_emitter) const {
+		return get_emitter_id(p_emitter) != godex::EMITTER_NONE;
 	}
 
-	virtual void add_event_dynamic(const String &p_emitter, const Dictionary &p_data) {
+	virtual void add_event_dynamic(godex::EmitterId p_emitter, const Dictionary &p_data) {
 		CRASH_NOW_MSG("Override this function.");
 	}
 
-	virtual const void *get_events_ptr(const String &p_emitter) const {
+	virtual const void *get_events_ptr(godex::EmitterId p_emitter) const {
 		CRASH_NOW_MSG("Override this function.");
 		return nullptr;
 	}
 
-	virtual Array get_events_array(const String &p_emitter) const {
+	/// Returns the readable events, starting from `p_from`.
+	virtual Array get_events_array(godex::EmitterId p_emitter, uint32_t p_from = 0) const {
 		CRASH_NOW_MSG("Override this function.");
 		return Array();
 	}
 
+	/// Returns the readable events, starting from `p_from`, as one column per
+	/// event property: `property name -> column`.
+	/// The `int` and `bool` properties are stored into a `PackedInt64Array`,
+	/// the `float` ones into a `PackedFloat32Array`, the `Vector3` ones into a
+	/// `PackedVector3Array`, and the others into an `Array`.
+	virtual Dictionary get_events_columns(godex::EmitterId p_emitter, uint32_t p_from = 0) const {
+		CRASH_NOW_MSG("Override this function.");
+		return Dictionary();
+	}
+
+	/// Registers a receiver for this emitter, and returns its index: the
+	/// receiver reads only the events emitted after this call.
+	virtual uint32_t add_event_receiver(godex::EmitterId p_emitter) {
+		CRASH_NOW_MSG("Override this function.");
+		return UINT32_MAX;
+	}
+
+	virtual void remove_event_receiver(godex::EmitterId p_emitter, uint32_t p_receiver) {
+		CRASH_NOW_MSG("Override this function.");
+	}
+
+	/// An inactive receiver doesn't keep the events: once active again, it
+	/// reads only the events emitted from now on.
+	virtual void set_event_receiver_active(godex::EmitterId p_emitter, uint32_t p_receiver, bool p_active) {
+		CRASH_NOW_MSG("Override this function.");
+	}
+
+	/// Returns the index, into the readable events, of the first event this
+	/// receiver didn't read yet, and marks all the readable events as read.
+	virtual uint32_t receive_events(godex::EmitterId p_emitter, uint32_t p_receiver) {
+		CRASH_NOW_MSG("Override this function.");
+		return 0;
+	}
+
+	/// Drops the readable events read by all the receivers, then makes the
+	/// pending events readable.
+	virtual void swap_events() {
+		CRASH_NOW_MSG("Override this function.");
+	}
+
+	/// Drops all the events, both pending and readable.
 	virtual void flush_events() {
 		CRASH_NOW_MSG("Override this function.");
 	}
+
+	void add_event_dynamic(const String &p_emitter, const Dictionary &p_data) {
+		const godex::EmitterId id = get_emitter_id(p_emitter);
+		ERR_FAIL_COND_MSG(id == godex::EMITTER_NONE, String("The emitter `") + p_emitter + "` doesn't exists. No systems are fetching from this emitter.");
+		add_event_dynamic(id, p_data);
+	}
+
+	const void *get_events_ptr(const String &p_emitter) const {
+		return get_events_ptr(get_emitter_id(p_emitter));
+	}
+
+	Array get_events_array(const String &p_emitter, uint32_t p_from = 0) const {
+		return get_events_array(get_emitter_id(p_emitter), p_from);
+	}
 };
 
 template <class E>
 class EventStorage : public EventStorageBase {
-	OAHashMap<String, LocalVector<E>> events_map;
+	struct Emitter {
+		/// The events the receivers can read.
+		LocalVector<E> events;
+		/// The events emitted since the last swap, one buffer per thread slot.
+		LocalVector<E> pending[godex::EVENTS_THREAD_SLOTS];
+		/// Guards the last pending buffer, shared by the threads that don't
+		/// have their own.
+		SpinLock shared_pending_lock;
+		/// The sequence number of the first readable event.
+		uint64_t first_sequence = 0;
+		/// The sequence number of the next event each receiver reads;
+		/// `UINT64_MAX` when the receiver is removed.
+		LocalVector<uint64_t> cursors;
+		/// The swaps done since each receiver read the events the last time.
+		LocalVector<uint32_t> idle_swaps;
+		/// The inactive receivers don't keep the events.
+		LocalVector<bool> active;
+	};
+
+	/// The emitters, indexed by `EmitterId`.
+	LocalVector<Emitter *> emitters;
+	OAHashMap<String, godex::EmitterId> emitter_ids;
 
 public:
-	virtual void add_event_emitter(const String &p_emitter) override {
-		ERR_FAIL_COND_MSG(events_map.has(p_emitter), String("The emitter `") + p_emitter + "` for the event `" + E::get_class_static() + "` exists.");
-		events_map.insert(p_emitter, LocalVector<E>());
+	using EventStorageBase::add_event_dynamic;
+	using EventStorageBase::get_events_array;
+	using EventStorageBase::get_events_ptr;
+
+	virtual ~EventStorage() {
+		for (uint32_t i = 0; i < emitters.size(); i += 1) {
+			memdelete(emitters[i]);
+		}
 	}
 
-	virtual bool has_emitter(const String &p_emitter) override {
-		return events_map.has(p_emitter);
+	virtual godex::EmitterId add_event_emitter(const String &p_emitter) override {
+		const godex::EmitterId *existing = emitter_ids.lookup_ptr(p_emitter);
+		ERR_FAIL_COND_V_MSG(existing != nullptr, *existing, String("The emitter `") + p_emitter + "` for the event `" + E::get_class_static() + "` exists.");
+		const godex::EmitterId id = emitters.size();
+		emitters.push_back(memnew(Emitter));
+		emitter_ids.insert(p_emitter, id);
+		return id;
 	}
 
-	virtual void add_event_dynamic(const String &p_emitter, const Dictionary &p_data) override {
+	virtual godex::EmitterId get_emitter_id(const String &p_emitter) const override {
+		const godex::EmitterId *id = emitter_ids.lookup_ptr(p_emitter);
+		return id == nullptr ? godex::EMITTER_NONE : *id;
+	}
+
+	virtual void add_event_dynamic(godex::EmitterId p_emitter, const Dictionary &p_data) override {
 		E insert_data;
 
 		// Set the custom data if any.
@@ -62,18 +197,18 @@ public:
 		add_event(p_emitter, insert_data);
 	}
 
-	virtual const void *get_events_ptr(const String &p_emitter) const override {
+	virtual const void *get_events_ptr(godex::EmitterId p_emitter) const override {
 		return (const void *)get_events(p_emitter);
 	}
 
-	virtual Array get_events_array(const String &p_emitter) const override {
+	virtual Array get_events_array(godex::EmitterId p_emitter, uint32_t p_from = 0) const override {
 		const LocalVector<PropertyInfo> *props = E::get_static_properties();
 
 		Array ret;
 		const LocalVector<E> *events = get_events(p_emitter);
-		if (events) {
-			ret.resize(events->size());
-			for (uint32_t i = 0; i < events->size(); i += 1) {
+		if (events && p_from < events->size()) {
+			ret.resize(events->size() - p_from);
+			for (uint32_t i = p_from; i < events->size(); i += 1) {
 				Dictionary dic;
 
 				for (uint32_t p = 0; p < props->size(); p += 1) {
@@ -82,26 +217,215 @@ public:
 					dic[(*props)[p].name] = v;
 				}
 
-				ret[i] = dic;
+				ret[i - p_from] = dic;
 			}
 		}
 		return ret;
 	}
 
+	virtual Dictionary get_events_columns(godex::EmitterId p_emitter, uint32_t p_from = 0) const override {
+		const LocalVector<PropertyInfo> *props = E::get_static_properties();
+
+		const LocalVector<E> *events = get_events(p_emitter);
+		const uint32_t count = (events && p_from < events->size()) ? events->size() - p_from : 0;
+		const E *first = count > 0 ? events->ptr() + p_from : nullptr;
+
+		Dictionary ret;
+		Variant v;
+		for (uint32_t p = 0; p < props->size(); p += 1) {
+			switch ((*props)[p].type) {
+				case Variant::BOOL:
+				case Variant::INT: {
+					PackedInt64Array column;
+					column.resize(count);
+					int64_t *w = column.ptrw();
+					for (uint32_t i = 0; i < count; i += 1) {
+						E::get_by_index((void *)(first + i), p, v);
+						w[i] = v;
+					}
+					ret[(*props)[p].name] = column;
+				} break;
+				case Variant::FLOAT: {
+					PackedFloat32Array column;
+					column.resize(count);
+					float *w = column.ptrw();
+					for (uint32_t i = 0; i < count; i += 1) {
+						E::get_by_index((void *)(first + i), p, v);
+						w[i] = v;
+					}
+					ret[(*props)[p].name] = column;
+				} break;
+				case Variant::VECTOR3: {
+					PackedVector3Array column;
+					column.resize(count);
+					Vector3 *w = column.ptrw();
+					for (uint32_t i = 0; i < count; i += 1) {
+						E::get_by_index((void *)(first + i), p, v);
+						w[i] = v;
+					}
+					ret[(*props)[p].name] = column;
+				} break;
+				default: {
+					Array column;
+					column.resize(count);
+					for (uint32_t i = 0; i < count; i += 1) {
+						E::get_by_index((void *)(first + i), p, v);
+						column[i] = v;
+					}
+					ret[(*props)[p].name] = column;
+				}
+			}
+		}
+		return ret;
+	}
+
+	virtual uint32_t add_event_receiver(godex::EmitterId p_emitter) override {
+		ERR_FAIL_UNSIGNED_INDEX_V_MSG(p_emitter, emitters.size(), UINT32_MAX, "The emitter " + itos(p_emitter) + " for the event `" + E::get_class_static() + "` doesn't exists.");
+		Emitter &emitter = *emitters[p_emitter];
+		const uint64_t cursor = emitter.first_sequence + emitter.events.size();
+
+		// Reuse a removed receiver, if any.
+		for (uint32_t i = 0; i < emitter.cursors.size(); i += 1) {
+			if (emitter.cursors[i] == UINT64_MAX) {
+				emitter.cursors[i] = cursor;
+				emitter.idle_swaps[i] = 0;
+				emitter.active[i] = true;
+				return i;
+			}
+		}
+		emitter.cursors.push_back(cursor);
+		emitter.idle_swaps.push_back(0);
+		emitter.active.push_back(true);
+		return emitter.cursors.size() - 1;
+	}
+
+	virtual void remove_event_receiver(godex::EmitterId p_emitter, uint32_t p_receiver) override {
+		ERR_FAIL_UNSIGNED_INDEX_MSG(p_emitter, emitters.size(), "The emitter " + itos(p_emitter) + " for the event `" + E::get_class_static() + "` doesn't exists.");
+		ERR_FAIL_UNSIGNED_INDEX_MSG(p_receiver, emitters[p_emitter]->cursors.size(), "The receiver " + itos(p_receiver) + " doesn't exists.");
+		emitters[p_emitter]->cursors[p_receiver] = UINT64_MAX;
+	}
+
+	virtual void set_event_receiver_active(godex::EmitterId p_emitter, uint32_t p_receiver, bool p_active) override {
+		ERR_FAIL_UNSIGNED_INDEX_MSG(p_emitter, emitters.size(), "The emitter " + itos(p_emitter) + " for the event `" + E::get_class_static() + "` doesn't exists.");
+		ERR_FAIL_UNSIGNED_INDEX_MSG(p_receiver, emitters[p_emitter]->cursors.size(), "The receiver " + itos(p_receiver) + " doesn't exists.");
+		Emitter &emitter = *emitters[p_emitter];
+		if (p_active && emitter.active[p_receiver] == false) {
+			// Skip the events emitted while not active.
+			emitter.cursors[p_receiver] = emitter.first_sequence + emitter.events.size();
+			emitter.idle_swaps[p_receiver] = 0;
+		}
+		emitter.active[p_receiver] = p_active;
+	}
+
+	virtual uint32_t receive_events(godex::EmitterId p_emitter, uint32_t p_receiver) override {
+#ifdef DEBUG_ENABLED
+		CRASH_BAD_UNSIGNED_INDEX(p_emitter, emitters.size());
+		CRASH_BAD_UNSIGNED_INDEX(p_receiver, emitters[p_emitter]->cursors.size());
+#endif
+		Emitter &emitter = *emitters[p_emitter];
+		// When idle for too long, the events it didn't read may be gone.
+		const uint64_t cursor = MAX(emitter.cursors[p_receiver], emitter.first_sequence);
+		const uint32_t from = cursor - emitter.first_sequence;
+		emitter.cursors[p_receiver] = emitter.first_sequence + emitter.events.size();
+		emitter.idle_swaps[p_receiver] = 0;
+		return from;
+	}
+
+	virtual void swap_events() override {
+		for (uint32_t i = 0; i < emitters.size(); i += 1) {
+			Emitter &emitter = *emitters[i];
+
+			// Drop the events read by all the receivers: the inactive and the
+			// idle receivers don't keep them.
+			uint64_t read = emitter.first_sequence + emitter.events.size();
+			for (uint32_t r = 0; r < emitter.cursors.size(); r += 1) {
+				if (emitter.cursors[r] == UINT64_MAX || emitter.active[r] == false) {
+					continue;
+				}
+				if (emitter.idle_swaps[r] < MAX_IDLE_SWAPS) {
+					emitter.idle_swaps[r] += 1;
+					read = MIN(read, emitter.cursors[r]);
+				}
+			}
+			read = MAX(read, emitter.first_sequence);
+			const uint32_t read_count = read - emitter.first_sequence;
+			if (read_count == emitter.events.size()) {
+				emitter.events.clear();
+			} else if (read_count > 0) {
+				for (uint32_t e = read_count; e < emitter.events.size(); e += 1) {
+					emitter.events[e - read_count] = emitter.events[e];
+				}
+				emitter.events.resize(emitter.events.size() - read_count);
+			}
+			emitter.first_sequence = read;
+
+			// The pending events are now readable.
+			for (uint32_t t = 0; t < godex::EVENTS_THREAD_SLOTS; t += 1) {
+				LocalVector<E> &pending = emitter.pending[t];
+				if (pending.size() == 0) {
+					continue;
+				}
+				if (emitter.events.size() == 0) {
+					SWAP(emitter.events, pending);
+				} else {
+					for (uint32_t e = 0; e < pending.size(); e += 1) {
+						emitter.events.push_back(pending[e]);
+					}
+					pending.clear();
+				}
+			}
+		}
+	}
+
 	virtual void flush_events() override {
-		for (typename OAHashMap<String, LocalVector<E>>::Iterator it = events_map.iter(); it.valid; it = events_map.next_iter(it)) {
-			it.value->clear();
+		for (uint32_t i = 0; i < emitters.size(); i += 1) {
+			Emitter &emitter = *emitters[i];
+			emitter.first_sequence += emitter.events.size();
+			emitter.events.clear();
+			for (uint32_t t = 0; t < godex::EVENTS_THREAD_SLOTS; t += 1) {
+				emitter.pending[t].clear();
+			}
+			// All the receivers read everything.
+			for (uint32_t r = 0; r < emitter.cursors.size(); r += 1) {
+				if (emitter.cursors[r] != UINT64_MAX) {
+					emitter.cursors[r] = emitter.first_sequence;
+				}
+			}
 		}
 	}
 
 public:
-	void add_event(const String &p_emitter, E p_event) {
-		LocalVector<E> *emitter = events_map.lookup_ptr(p_emitter);
-		ERR_FAIL_COND_MSG(emitter == nullptr, String("The emitter `") + p_emitter + "` for the event `" + E::get_class_static() + "` doesn't exists. No systems are fetching from this emitter.");
-		emitter->push_back(p_event);
+	/// Adds the event to the pending buffer of the calling thread: it's
+	/// readable after the next `swap_events`.
+	/// This is thread safe, as long as no emitters are added meanwhile.
+	void add_event(godex::EmitterId p_emitter, const E &p_event) {
+		ERR_FAIL_UNSIGNED_INDEX_MSG(p_emitter, emitters.size(), "The emitter " + itos(p_emitter) + " for the event `" + E::get_class_static() + "` doesn't exists.");
+		Emitter *emitter = emitters[p_emitter];
+		const uint32_t slot = godex::get_events_thread_slot();
+		if (likely(slot < (godex::EVENTS_THREAD_SLOTS - 1))) {
+			emitter->pending[slot].push_back(p_event);
+		} else {
+			emitter->shared_pending_lock.lock();
+			emitter->pending[godex::EVENTS_THREAD_SLOTS - 1].push_back(p_event);
+			emitter->shared_pending_lock.unlock();
+		}
+	}
+
+	void add_event(const String &p_emitter, const E &p_event) {
+		const godex::EmitterId id = get_emitter_id(p_emitter);
+		ERR_FAIL_COND_MSG(id == godex::EMITTER_NONE, String("The emitter `") + p_emitter + "` for the event `" + E::get_class_static() + "` doesn't exists. No systems are fetching from this emitter.");
+		add_event(id, p_event);
+	}
+
+	/// Returns the readable events, or `nullptr` if the emitter doesn't exist.
+	const LocalVector<E> *get_events(godex::EmitterId p_emitter) const {
+		if (p_emitter < emitters.size()) {
+			return &emitters[p_emitter]->events;
+		}
+		return nullptr;
 	}
 
 	const LocalVector<E> *get_events(const String &p_emitter) const {
-		return events_map.lookup_ptr(p_emitter);
+		return get_events(get_emitter_id(p_emitter));
 	}
 };
@@ -160,6 +160,14 @@ public:
 		return { storage.get_entities().size(), storage.get_entities().ptr() };
 	}
 
+	virtual StorageMemoryStats get_memory_stats() const override {
+		StorageMemoryStats stats = StorageBase::get_memory_stats();
+		storage.add_memory_stats(stats);
+		hierarchy_changed.add_memory_stats(stats);
+		stats.add_vector(sub_storages);
+		return stats;
+	}
+
 	/// For each child, slow version.
 	template <typename F>
 	void for_each_child(EntityID p_entity, F func) const {
@@ -300,25 +308,36 @@ public:
 		return true;
 	}
 
+	virtual bool is_tracking_entities() const override {
+		return true;
+	}
+
 	virtual bool has(EntityID p_entity) const override {
 		return internal_storage.has(p_entity);
 	}
 
 	virtual void remove(EntityID p_index) override {
 		internal_storage.remove(p_index);
-		StorageBase::notify_updated(p_index);
+		StorageBase::notify_removed(p_index);
 	}
 
 	virtual void clear() override {
+		StorageBase::notify_clearing();
 		internal_storage.clear();
-		StorageBase::flush_changed();
+		StorageBase::notify_cleared();
 	}
 
 	virtual void insert(EntityID p_entity, const T &p_data) override {
+		const bool overwrite = internal_storage.has(p_entity);
 		LocalGlobal<T> d;
 		d.local = p_data;
 		internal_storage.insert(p_entity, d);
-		StorageBase::notify_changed(p_entity);
+		if (overwrite) {
+			// Already stored, only the data changes.
+			StorageBase::notify_changed(p_entity);
+		} else {
+			StorageBase::notify_inserted(p_entity);
+		}
 		propagate_change(
 				p_entity,
 				internal_storage.get(p_entity));
@@ -334,12 +353,26 @@ public:
 		StorageBase::notify_changed(p_entity);
 		LocalGlobal<T> &data = internal_storage.get(p_entity);
 		if (data.has_relationship) {
-			relationship_dirty_list.insert(p_entity);
+			// While the changes are deferred many threads fetch at once, so
+			// only the data of this `Entity` is written here: the dirty list
+			// is filled by `notify_deferred_changed`.
+			if (StorageBase::is_changes_deferred() == false) {
+				relationship_dirty_list.insert(p_entity);
+			}
 			data.global_changed = p_mode == Space::GLOBAL;
 		}
 		return data.is_root || p_mode == Space::LOCAL ? &data.local : &data.global;
 	}
 
+	virtual void notify_deferred_changed(const EntityID *p_entities, uint32_t p_count) override {
+		StorageBase::notify_deferred_changed(p_entities, p_count);
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			if (internal_storage.get(p_entities[i]).has_relationship) {
+				relationship_dirty_list.insert(p_entities[i]);
+			}
+		}
+	}
+
 	virtual const T *get(EntityID p_entity, Space p_mode = Space::LOCAL) const override {
 		const LocalGlobal<T> &data = internal_storage.get(p_entity);
 		return p_mode == Space::LOCAL || data.is_root ? &data.local : &data.global;
@@ -349,6 +382,13 @@ public:
 		return { internal_storage.get_entities().size(), internal_storage.get_entities().ptr() };
 	}
 
+	virtual StorageMemoryStats get_memory_stats() const override {
+		StorageMemoryStats stats = StorageBase::get_memory_stats();
+		internal_storage.add_memory_stats(stats);
+		relationship_dirty_list.add_memory_stats(stats);
+		return stats;
+	}
+
 	void propagate_change(EntityID p_entity) {
 		if (has(p_entity) == false) {
 			relationship_dirty_list.remove(p_entity);
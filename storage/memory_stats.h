@@ -0,0 +1,56 @@
+#pragma once
+
+#include "core/templates/local_vector.h"
+#include "core/typedefs.h"
+#include "core/variant/dictionary.h"
+
+/// Memory statistics of a storage, see `StorageBase::get_memory_stats`.
+///
+/// The `LocalVector` doesn't expose its capacity, so the reserved memory of
+/// the vectors is estimated using the growth policy: the size rounded to the
+/// next power of two. The pages and chunks are accounted exactly.
+struct StorageMemoryStats {
+	/// Bytes holding live data.
+	uint64_t bytes_used = 0;
+	/// Bytes allocated, including `bytes_used`.
+	uint64_t bytes_reserved = 0;
+	/// Amount of stored components.
+	uint32_t live_count = 0;
+
+	/// Returns the fraction of the reserved memory not holding live data,
+	/// from `0` (compact) to `1` (empty).
+	double get_fragmentation() const {
+		if (bytes_reserved == 0) {
+			return 0.0;
+		}
+		return 1.0 - (double(MIN(bytes_used, bytes_reserved)) / double(bytes_reserved));
+	}
+
+	/// Accounts `p_used` elements of `p_element_size` bytes, on a buffer of
+	/// `p_reserved` elements.
+	void add(uint64_t p_used, uint64_t p_reserved, uint64_t p_element_size) {
+		bytes_used += p_used * p_element_size;
+		bytes_reserved += MAX(p_used, p_reserved) * p_element_size;
+	}
+
+	template <class T>
+	void add_vector(const LocalVector<T> &p_vector, uint32_t p_reserved = 0) {
+		const uint32_t size = p_vector.size();
+		add(size, MAX(p_reserved, size == 0 ? 0 : next_power_of_2(size)), sizeof(T));
+	}
+
+	void merge(const StorageMemoryStats &p_other) {
+		bytes_used += p_other.bytes_used;
+		bytes_reserved += p_other.bytes_reserved;
+		live_count += p_other.live_count;
+	}
+
+	Dictionary to_dictionary() const {
+		Dictionary d;
+		d["bytes_used"] = bytes_used;
+		d["bytes_reserved"] = bytes_reserved;
+		d["live_count"] = live_count;
+		d["fragmentation"] = get_fragmentation();
+		return d;
+	}
+};
@@ -0,0 +1,127 @@
+#include "paged_sparse_index.h"
+
+PagedSparseIndex::PagedSparseIndex(const PagedSparseIndex &p_other) {
+	*this = p_other;
+}
+
+PagedSparseIndex &PagedSparseIndex::operator=(const PagedSparseIndex &p_other) {
+	if (this == &p_other) {
+		return *this;
+	}
+
+	reset();
+
+	pages.resize(p_other.pages.size());
+	pages_count.resize(p_other.pages_count.size());
+	for (uint32_t i = 0; i < p_other.pages.size(); i += 1) {
+		pages_count[i] = p_other.pages_count[i];
+		if (p_other.pages[i] == nullptr) {
+			pages[i] = nullptr;
+		} else {
+			pages[i] = static_cast<uint32_t *>(memalloc(PAGE_SIZE * sizeof(uint32_t)));
+			memcpy(pages[i], p_other.pages[i], PAGE_SIZE * sizeof(uint32_t));
+		}
+	}
+	allocated_pages = p_other.allocated_pages;
+
+	return *this;
+}
+
+PagedSparseIndex::~PagedSparseIndex() {
+	reset();
+}
+
+void PagedSparseIndex::unset(EntityID p_entity) {
+	const uint32_t page = uint32_t(p_entity) >> PAGE_SHIFT;
+	if (page >= pages.size() || pages[page] == nullptr) {
+		// Nothing to do.
+		return;
+	}
+
+	uint32_t &slot = pages[page][uint32_t(p_entity) & PAGE_MASK];
+	if (slot == UINT32_MAX) {
+		// Nothing to do.
+		return;
+	}
+
+	slot = UINT32_MAX;
+	pages_count[page] -= 1;
+	if (pages_count[page] == 0) {
+		// This page is empty, release it.
+		free_page(page);
+	}
+}
+
+void PagedSparseIndex::add_memory_stats(StorageMemoryStats &r_stats) const {
+	uint64_t set_count = 0;
+	for (uint32_t i = 0; i < pages_count.size(); i += 1) {
+		set_count += pages_count[i];
+	}
+	r_stats.add(set_count, uint64_t(allocated_pages) * PAGE_SIZE, sizeof(uint32_t));
+	r_stats.add_vector(pages);
+	r_stats.add_vector(pages_count);
+}
+
+void PagedSparseIndex::reserve(uint32_t p_size) {
+	const uint32_t pages_needed = (p_size + PAGE_MASK) >> PAGE_SHIFT;
+	pages.reserve(pages_needed);
+	pages_count.reserve(pages_needed);
+}
+
+void PagedSparseIndex::clear() {
+	for (uint32_t i = 0; i < pages.size(); i += 1) {
+		if (pages[i] == nullptr) {
+			continue;
+		}
+		if (pages_count[i] == 0) {
+			// Kept by the previous `clear` but not used since: `unset` never
+			// frees it, so release it now.
+			free_page(i);
+			continue;
+		}
+		// Keep the page, so the next insertions don't allocate.
+		uint32_t *page = pages[i];
+		for (uint32_t slot = 0; slot < PAGE_SIZE; slot += 1) {
+			page[slot] = UINT32_MAX;
+		}
+		pages_count[i] = 0;
+	}
+}
+
+void PagedSparseIndex::reset() {
+	for (uint32_t i = 0; i < pages.size(); i += 1) {
+		if (pages[i] != nullptr) {
+			free_page(i);
+		}
+	}
+	pages.reset();
+	pages_count.reset();
+}
+
+void PagedSparseIndex::allocate_page(uint32_t p_page) {
+	if (p_page >= pages.size()) {
+		const uint32_t start = pages.size();
+		pages.resize(p_page + 1);
+		pages_count.resize(p_page + 1);
+		for (uint32_t i = start; i < pages.size(); i += 1) {
+			pages[i] = nullptr;
+			pages_count[i] = 0;
+		}
+	}
+
+	uint32_t *page = static_cast<uint32_t *>(memalloc(PAGE_SIZE * sizeof(uint32_t)));
+	for (uint32_t i = 0; i < PAGE_SIZE; i += 1) {
+		page[i] = UINT32_MAX;
+	}
+
+	pages[p_page] = page;
+	pages_count[p_page] = 0;
+	allocated_pages += 1;
+}
+
+void PagedSparseIndex::free_page(uint32_t p_page) {
+	memfree(pages[p_page]);
+	pages[p_page] = nullptr;
+	pages_count[p_page] = 0;
+	allocated_pages -= 1;
+}
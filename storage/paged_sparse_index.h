@@ -0,0 +1,129 @@
+#pragma once
+
+#include "../ecs_types.h"
+#include "core/os/memory.h"
+#include "core/templates/local_vector.h"
+#include "memory_stats.h"
+
+/// Sparse map `EntityID` -> `uint32_t`, used by the storages to point to the
+/// dense data.
+///
+/// The index is split in fixed size pages, that are allocated only when an
+/// `Entity` that falls into that page is set. The empty pages are not
+/// allocated at all (the page table stores a `nullptr`), and a page is freed
+/// as soon as `unset` removes its last valid index. `clear` keeps the pages
+/// in use, and frees the ones not used since the previous `clear`; `reset`
+/// frees them all.
+/// In this way the memory used depends on the amount of stored `Entities`
+/// rather than on the biggest `EntityID` ever created.
+class PagedSparseIndex {
+public:
+	static constexpr uint32_t PAGE_SHIFT = 10;
+	static constexpr uint32_t PAGE_SIZE = 1 << PAGE_SHIFT;
+	static constexpr uint32_t PAGE_MASK = PAGE_SIZE - 1;
+
+private:
+	/// The page table, each page is `PAGE_SIZE` long or `nullptr` when empty.
+	LocalVector<uint32_t *> pages;
+	/// Count of valid indices stored on each page, used to free the pages.
+	LocalVector<uint32_t> pages_count;
+	/// Count of allocated pages.
+	uint32_t allocated_pages = 0;
+
+public:
+	PagedSparseIndex() = default;
+	PagedSparseIndex(const PagedSparseIndex &p_other);
+	PagedSparseIndex &operator=(const PagedSparseIndex &p_other);
+	~PagedSparseIndex();
+
+	/// Returns the index stored for this `Entity` or `UINT32_MAX`.
+	_FORCE_INLINE_ uint32_t get(EntityID p_entity) const {
+		const uint32_t page = uint32_t(p_entity) >> PAGE_SHIFT;
+		if (page >= pages.size() || pages[page] == nullptr) {
+			return UINT32_MAX;
+		}
+		return pages[page][uint32_t(p_entity) & PAGE_MASK];
+	}
+
+	_FORCE_INLINE_ bool has(EntityID p_entity) const {
+		return get(p_entity) != UINT32_MAX;
+	}
+
+	/// Returns the index without any check. The `Entity` must be set.
+	_FORCE_INLINE_ uint32_t get_unchecked(EntityID p_entity) const {
+		return pages[uint32_t(p_entity) >> PAGE_SHIFT][uint32_t(p_entity) & PAGE_MASK];
+	}
+
+	/// Set the index for this `Entity`, allocates the page if needed.
+	_FORCE_INLINE_ void set(EntityID p_entity, uint32_t p_index) {
+		const uint32_t page = uint32_t(p_entity) >> PAGE_SHIFT;
+		if (unlikely(page >= pages.size() || pages[page] == nullptr)) {
+			allocate_page(page);
+		}
+		uint32_t &slot = pages[page][uint32_t(p_entity) & PAGE_MASK];
+		if (slot == UINT32_MAX) {
+			pages_count[page] += 1;
+		}
+		slot = p_index;
+	}
+
+	/// Updates the index of an `Entity` already set.
+	_FORCE_INLINE_ void update(EntityID p_entity, uint32_t p_index) {
+#ifdef DEBUG_ENABLED
+		CRASH_COND_MSG(has(p_entity) == false, "The entity " + itos(p_entity) + " is not set.");
+#endif
+		pages[uint32_t(p_entity) >> PAGE_SHIFT][uint32_t(p_entity) & PAGE_MASK] = p_index;
+	}
+
+	/// Unset the index for this `Entity`, frees the page once empty.
+	void unset(EntityID p_entity);
+
+	/// Calls `p_func` with each set index, by reference so it can update
+	/// it. The index must not become `UINT32_MAX`.
+	template <class F>
+	void update_all(F p_func) {
+		for (uint32_t i = 0; i < pages.size(); i += 1) {
+			if (pages[i] == nullptr || pages_count[i] == 0) {
+				continue;
+			}
+			uint32_t *page = pages[i];
+			for (uint32_t slot = 0; slot < PAGE_SIZE; slot += 1) {
+				if (page[slot] != UINT32_MAX) {
+					p_func(page[slot]);
+				}
+			}
+		}
+	}
+
+	/// Pre-allocate the page table to fit this amount of `Entities`.
+	/// The pages are still allocated lazily.
+	void reserve(uint32_t p_size);
+
+	/// Unsets all the indices, but keeps the pages allocated: the storages
+	/// cleared each frame don't allocate them again. The pages still empty
+	/// since the previous `clear` are freed, so the memory doesn't grow with
+	/// the `EntityID`s used once.
+	void clear();
+
+	/// Frees all the memory.
+	void reset();
+
+	/// Returns the amount of allocated pages.
+	uint32_t get_allocated_pages() const {
+		return allocated_pages;
+	}
+
+	/// Returns the amount of memory, in bytes, used by this index.
+	uint64_t get_memory_usage() const {
+		return uint64_t(allocated_pages) * PAGE_SIZE * sizeof(uint32_t) +
+			   uint64_t(pages.size()) * (sizeof(uint32_t *) + sizeof(uint32_t));
+	}
+
+	/// Accounts the memory of this index: the unset slots of the allocated
+	/// pages are reserved but not used.
+	void add_memory_stats(StorageMemoryStats &r_stats) const;
+
+private:
+	void allocate_page(uint32_t p_page);
+	void free_page(uint32_t p_page);
+};
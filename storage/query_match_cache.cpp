@@ -0,0 +1,61 @@
+#include "query_match_cache.h"
+
+QueryMatchCache::QueryMatchCache(uint64_t p_key, const LocalVector<godex::component_id> &p_components) :
+		key(p_key),
+		components(p_components) {
+}
+
+void QueryMatchCache::notify_dirty(EntityID p_entity) {
+	lock.lock();
+	// When not valid all the candidates are tested anyway.
+	if (valid) {
+		dirty.insert(p_entity);
+		check_dirty_limit();
+	}
+	lock.unlock();
+}
+
+void QueryMatchCache::notify_dirty(const EntityID *p_entities, uint32_t p_count) {
+	lock.lock();
+	if (valid) {
+		dirty.insert(p_entities, p_count);
+		check_dirty_limit();
+	}
+	lock.unlock();
+}
+
+void QueryMatchCache::invalidate() {
+	lock.lock();
+	valid = false;
+	dirty.clear();
+	lock.unlock();
+}
+
+void QueryMatchCache::check_dirty_limit() {
+	if (dirty.size() > MAX(candidate_count, matches.size())) {
+		// Cheaper to test all the candidates on the next `update`.
+		valid = false;
+		dirty.clear();
+	}
+}
+
+void QueryMatchCache::insert_match(EntityID p_entity) {
+	match_index.set(p_entity, matches.size());
+	matches.push_back(p_entity);
+}
+
+void QueryMatchCache::remove_match(EntityID p_entity) {
+	const uint32_t index = match_index.get_unchecked(p_entity);
+	const uint32_t last = matches.size() - 1;
+	if (index != last) {
+		matches[index] = matches[last];
+		match_index.update(matches[index], index);
+	}
+	matches.resize(last);
+	match_index.unset(p_entity);
+}
+
+void QueryMatchCache::clear_matches() {
+	matches.clear();
+	match_index.clear();
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "../ecs_types.h"
+#include "core/os/spin_lock.h"
+#include "core/templates/local_vector.h"
+#include "entity_bit_list.h"
+#include "paged_sparse_index.h"
+
+/// The `Entities` that satisfy a cached `Query`, check `Query::set_cached`.
+///
+/// The storages of the components used by the `Query` notify the cache each
+/// time an `Entity` gains or loses a component, and the `Entity` is marked
+/// dirty: `update` tests only the dirty `Entities`. So the `Query` iterates
+/// only the matching `Entities`, and the filters are tested only when the
+/// components of an `Entity` change.
+///
+/// Owned by the `World`, check `World::get_query_cache`.
+/// The storages of different components can be used by different threads at
+/// the same time, so the dirty list is guarded by a lock.
+/// An `Entity` is marked dirty once until the next `update`, and once the
+/// dirty `Entities` are more than the candidates the cache is invalidated:
+/// testing all the candidates is cheaper.
+class QueryMatchCache {
+	/// Identifies the `Query` that uses this cache.
+	uint64_t key = 0;
+	/// The components used by the `Query`, including the filtered ones.
+	LocalVector<godex::component_id> components;
+
+	SpinLock lock;
+	/// `false` until the first `update` and after `invalidate`: the next
+	/// `update` tests all the candidates.
+	bool valid = false;
+	/// The `Entities` that gained or lost a component since the last `update`.
+	EntityBitList dirty;
+	/// The amount of candidates given to the last `update`.
+	uint32_t candidate_count = 0;
+
+	LocalVector<EntityID> matches;
+	/// `Entity` -> position into `matches`.
+	PagedSparseIndex match_index;
+
+public:
+	QueryMatchCache(uint64_t p_key, const LocalVector<godex::component_id> &p_components);
+
+	uint64_t get_key() const {
+		return key;
+	}
+
+	const LocalVector<godex::component_id> &get_components() const {
+		return components;
+	}
+
+	bool uses_component(godex::component_id p_component) const {
+		return components.find(p_component) != -1;
+	}
+
+	/// Marks this `Entity` as dirty, called by the storages when a component
+	/// is inserted or removed.
+	void notify_dirty(EntityID p_entity);
+	void notify_dirty(const EntityID *p_entities, uint32_t p_count);
+
+	/// Drops the matches: the next `update` tests all the candidates. Called
+	/// when a storage is cleared, created or destroyed.
+	void invalidate();
+
+	bool is_valid() const {
+		return valid;
+	}
+
+	/// Returns the amount of `Entities` to test on the next `update`.
+	uint32_t get_dirty_count() const {
+		return dirty.size();
+	}
+
+	/// Brings the matches up to date, and copies them into `r_matches`.
+	/// `p_is_match` returns `true` when the `Entity` satisfies the `Query`.
+	/// The `p_candidates` are tested only when the cache is not valid: they
+	/// must contain all the matching `Entities`.
+	/// The cache is shared by all the `Query`s of the same type, so another
+	/// `Query` may update it while `r_matches` is iterated.
+	template <class F>
+	void update(const EntityID *p_candidates, uint32_t p_count, F p_is_match, LocalVector<EntityID> &r_matches) {
+		lock.lock();
+		if (valid == false) {
+			clear_matches();
+			for (uint32_t i = 0; i < p_count; i += 1) {
+				if (p_is_match(p_candidates[i])) {
+					insert_match(p_candidates[i]);
+				}
+			}
+			valid = true;
+		} else {
+			dirty.for_each([&](EntityID p_entity) {
+				const bool is_match = p_is_match(p_entity);
+				if (is_match != match_index.has(p_entity)) {
+					if (is_match) {
+						insert_match(p_entity);
+					} else {
+						remove_match(p_entity);
+					}
+				}
+			});
+		}
+		dirty.clear();
+		candidate_count = p_count;
+		r_matches.resize(matches.size());
+		for (uint32_t i = 0; i < matches.size(); i += 1) {
+			r_matches[i] = matches[i];
+		}
+		lock.unlock();
+	}
+
+	/// The matching `Entities`, in no particular order. Not guarded by the
+	/// lock, use the copy made by `update` instead.
+	const LocalVector<EntityID> &get_matches() const {
+		return matches;
+	}
+
+private:
+	/// Invalidates the cache when the dirty `Entities` are too many, the
+	/// lock must be held.
+	void check_dirty_limit();
+
+	void insert_match(EntityID p_entity);
+	void remove_match(EntityID p_entity);
+	void clear_matches();
+};
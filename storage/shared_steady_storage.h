@@ -1,25 +1,76 @@
 #pragma once
 
+#include "core/templates/hashfuncs.h"
+#include "core/templates/oa_hash_map.h"
 #include "core/templates/paged_allocator.h"
 #include "dense_vector.h"
 #include "storage.h"
 
+/// Returns `true` when the component has the function `uint32_t hash() const`.
+template <typename T, typename = void>
+struct godex_shared_has_hash : std::false_type {};
+
+template <typename T>
+struct godex_shared_has_hash<T, std::void_t<decltype(std::declval<const T &>().hash())>> : std::true_type {};
+
+/// Returns `true` when the component has the `operator==`.
+template <typename T, typename = void>
+struct godex_shared_has_equal : std::false_type {};
+
+template <typename T>
+struct godex_shared_has_equal<T, std::void_t<decltype(std::declval<const T &>() == std::declval<const T &>())>> : std::true_type {};
+
 /// The `SharedSteadyStorage` is the perfect choice when you want to share the
 /// same component between entities, and that components memory never changes.
 ///
 /// When dealing with physics engines or audio engines, etc... it's usually
 /// needed to have objects that are shared between some other objects: in
 /// all those cases, it's possible to use this storage.
+///
+/// The storage counts the `Entities` referencing each shared component.
+/// Use `create_or_get_shared_component` to reuse the shared component that
+/// has the same data, rather than creating a duplicate: these are released
+/// once the last `Entity` referencing them is removed. This can be disabled
+/// using the config `auto_release`.
+/// The ones made by `create_shared_component` are owned by the caller, that
+/// may keep the SID around (like the `SharedComponentResource` does), so they
+/// are released only by `free_shared_component`.
 template <class T>
 class SharedSteadyStorage : public SharedStorage<T> {
+	struct Shared {
+		/// `nullptr` when freed.
+		T *data = nullptr;
+		/// Amount of `Entities` using it.
+		uint32_t references = 0;
+		/// Set when created by `create_or_get_shared_component`.
+		bool hashed = false;
+		uint32_t hash = 0;
+		/// The next shared component having the same hash.
+		godex::SID next = godex::SID_NONE;
+	};
+
 	PagedAllocator<T, false> allocator;
-	LocalVector<T *> allocated_pointers;
+	/// The SIDs are never reused, so an `Entity` that still points to a freed
+	/// shared component can't point to a new one.
+	LocalVector<Shared> shared;
 	DenseVector<godex::SID> storage;
+	/// Hash -> first shared component with that hash.
+	OAHashMap<uint32_t, godex::SID> hashed;
+	bool auto_release = true;
+	uint32_t allocator_page_size = 200;
+
+	uint32_t alive_count = 0;
+	/// The most shared components alive at once, since the last `clear`.
+	uint32_t peak_alive_count = 0;
+	uint32_t deduplicated_count = 0;
+	uint32_t released_count = 0;
 
 public:
 	virtual void configure(const Dictionary &p_config) override {
 		clear();
-		allocator.configure(p_config.get("page_size", 200));
+		allocator_page_size = p_config.get("page_size", 200);
+		allocator.configure(allocator_page_size);
+		auto_release = p_config.get("auto_release", true);
 	}
 
 	virtual String get_type_name() const override {
@@ -33,31 +84,94 @@ public:
 	virtual godex::SID create_shared_component(const T &p_data) override {
 		T *d = allocator.alloc();
 		*d = p_data;
-		godex::SID id = allocated_pointers.size();
-		allocated_pointers.push_back(d);
+		godex::SID id = shared.size();
+		Shared s;
+		s.data = d;
+		shared.push_back(s);
+		alive_count += 1;
+		peak_alive_count = MAX(peak_alive_count, alive_count);
+		return id;
+	}
+
+	/// Returns the shared component that has the same data, if any, otherwise
+	/// creates it.
+	/// The component must have the functions `uint32_t hash() const` and
+	/// `operator==`, or be trivially copyable (compared byte per byte).
+	godex::SID create_or_get_shared_component(const T &p_data) {
+		const uint32_t hash = hash_component(p_data);
+
+		godex::SID *head = hashed.lookup_ptr(hash);
+		if (head != nullptr) {
+			for (godex::SID id = *head; id != godex::SID_NONE; id = shared[id].next) {
+				if (is_equal(*shared[id].data, p_data)) {
+					deduplicated_count += 1;
+					return id;
+				}
+			}
+		}
+
+		const godex::SID id = create_shared_component(p_data);
+		shared[id].hashed = true;
+		shared[id].hash = hash;
+		shared[id].next = head != nullptr ? *head : godex::SID_NONE;
+		hashed.set(hash, id);
 		return id;
 	}
 
 	virtual void free_shared_component(godex::SID p_id) override {
-		if (p_id < allocated_pointers.size()) {
-			if (allocated_pointers[p_id] != nullptr) {
-				allocator.free(allocated_pointers[p_id]);
-				allocated_pointers[p_id] = nullptr;
+		if (p_id < shared.size()) {
+			if (shared[p_id].data != nullptr) {
+				if (shared[p_id].hashed) {
+					unlink_hash(p_id);
+				}
+				allocator.free(shared[p_id].data);
+				shared[p_id].data = nullptr;
+				shared[p_id].references = 0;
+				alive_count -= 1;
 			}
 		}
 	}
 
 	virtual bool has_shared_component(godex::SID p_id) const override {
-		if (p_id < allocated_pointers.size()) {
-			return allocated_pointers[p_id] != nullptr;
+		if (p_id < shared.size()) {
+			return shared[p_id].data != nullptr;
 		}
 		return false;
 	}
 
+	virtual uint32_t get_reference_count(godex::SID p_id) const override {
+		ERR_FAIL_COND_V_MSG(has_shared_component(p_id) == false, 0, "The SID " + itos(p_id) + " is not valid.");
+		return shared[p_id].references;
+	}
+
+	virtual SharedStorageStats get_shared_stats() const override {
+		SharedStorageStats stats;
+		stats.shared_count = alive_count;
+		stats.deduplicated_count = deduplicated_count;
+		stats.released_count = released_count;
+
+		uint32_t referenced_count = 0;
+		for (uint32_t i = 0; i < shared.size(); i += 1) {
+			if (shared[i].data != nullptr && shared[i].references > 0) {
+				stats.reference_count += shared[i].references;
+				referenced_count += 1;
+			}
+		}
+		stats.memory_saved = uint64_t(stats.reference_count - referenced_count) * sizeof(T);
+		return stats;
+	}
+
 	virtual void insert(EntityID p_entity, godex::SID p_id) override {
-		if (p_id < allocated_pointers.size()) {
-			if (allocated_pointers[p_id] != nullptr) {
-				storage.insert(p_entity, p_id);
+		if (p_id < shared.size()) {
+			if (shared[p_id].data != nullptr) {
+				const godex::SID previous = storage.has(p_entity) ? storage.get(p_entity) : godex::SID_NONE;
+				if (previous != p_id) {
+					storage.insert(p_entity, p_id);
+					shared[p_id].references += 1;
+					if (previous != godex::SID_NONE) {
+						release_reference(previous);
+					}
+				}
 				StorageBase::notify_changed(p_entity);
 				return;
 			}
@@ -66,9 +180,9 @@ public:
 	}
 
 	virtual T *get_shared_component(godex::SID p_id) override {
-		if (p_id < allocated_pointers.size()) {
-			if (allocated_pointers[p_id] != nullptr) {
-				return allocated_pointers[p_id];
+		if (p_id < shared.size()) {
+			if (shared[p_id].data != nullptr) {
+				return shared[p_id].data;
 			}
 		}
 		CRASH_NOW_MSG("This Entity doesn't have anything stored, before get the data you have to use `has()`.");
@@ -76,9 +190,9 @@ public:
 	}
 
 	virtual const T *get_shared_component(godex::SID p_id) const override {
-		if (p_id < allocated_pointers.size()) {
-			if (allocated_pointers[p_id] != nullptr) {
-				return allocated_pointers[p_id];
+		if (p_id < shared.size()) {
+			if (shared[p_id].data != nullptr) {
+				return shared[p_id].data;
 			}
 		}
 		CRASH_NOW_MSG("This Entity doesn't have anything stored, before get the data you have to use `has()`.");
@@ -89,8 +203,8 @@ public:
 		bool h = storage.has(p_entity);
 		if (h) {
 			const godex::SID id = storage.get(p_entity);
-			if (id < allocated_pointers.size()) {
-				h = allocated_pointers[id] != nullptr;
+			if (id < shared.size()) {
+				h = shared[id].data != nullptr;
 			} else {
 				// Doesn't have.
 				h = false;
@@ -109,19 +223,90 @@ public:
 	}
 
 	virtual void remove(EntityID p_entity) override {
+		ERR_FAIL_COND_MSG(storage.has(p_entity) == false, "No entity: " + itos(p_entity) + " in this storage.");
+		const godex::SID id = storage.get(p_entity);
 		storage.remove(p_entity);
+		release_reference(id);
 		// Make sure to remove as changed.
 		StorageBase::notify_updated(p_entity);
 	}
 
 	virtual void clear() override {
 		allocator.reset();
-		allocated_pointers.reset();
+		shared.reset();
+		hashed.clear();
 		storage.clear();
+		alive_count = 0;
+		peak_alive_count = 0;
 		StorageBase::flush_changed();
 	}
 
 	virtual EntitiesBuffer get_stored_entities() const {
 		return { storage.get_entities().size(), storage.get_entities().ptr() };
 	}
+
+	virtual StorageMemoryStats get_memory_stats() const override {
+		StorageMemoryStats stats = StorageBase::get_memory_stats();
+		// The allocator keeps its pages until the storage is cleared, so the
+		// reserved memory depends on the peak of shared components alive.
+		const uint64_t page_size = next_power_of_2(MAX(allocator_page_size, uint32_t(1)));
+		const uint64_t pages = (uint64_t(peak_alive_count) + page_size - 1) / page_size;
+		stats.add(alive_count, pages * page_size, sizeof(T));
+		stats.add_vector(shared);
+		stats.add(hashed.get_num_elements(), hashed.get_capacity(), sizeof(uint32_t) + sizeof(godex::SID) + sizeof(uint32_t));
+		storage.add_memory_stats(stats);
+		return stats;
+	}
+
+private:
+	void release_reference(godex::SID p_id) {
+		if (shared[p_id].data == nullptr) {
+			// Already freed, nothing to do.
+			return;
+		}
+		shared[p_id].references -= 1;
+		if (shared[p_id].references == 0 && auto_release && shared[p_id].hashed) {
+			free_shared_component(p_id);
+			released_count += 1;
+		}
+	}
+
+	void unlink_hash(godex::SID p_id) {
+		godex::SID *head = hashed.lookup_ptr(shared[p_id].hash);
+		ERR_FAIL_COND_MSG(head == nullptr, "The shared component " + itos(p_id) + " is not hashed, this is a bug.");
+		if (*head == p_id) {
+			if (shared[p_id].next == godex::SID_NONE) {
+				hashed.remove(shared[p_id].hash);
+			} else {
+				*head = shared[p_id].next;
+			}
+		} else {
+			for (godex::SID id = *head; id != godex::SID_NONE; id = shared[id].next) {
+				if (shared[id].next == p_id) {
+					shared[id].next = shared[p_id].next;
+					break;
+				}
+			}
+		}
+		shared[p_id].hashed = false;
+		shared[p_id].next = godex::SID_NONE;
+	}
+
+	static uint32_t hash_component(const T &p_data) {
+		if constexpr (godex_shared_has_hash<T>::value) {
+			return p_data.hash();
+		} else {
+			static_assert(std::is_trivially_copyable<T>::value, "To deduplicate this component, implement `uint32_t hash() const` and `operator==`.");
+			return hash_djb2_buffer(reinterpret_cast<const uint8_t *>(&p_data), sizeof(T));
+		}
+	}
+
+	static bool is_equal(const T &p_a, const T &p_b) {
+		if constexpr (godex_shared_has_equal<T>::value) {
+			return p_a == p_b;
+		} else {
+			static_assert(std::is_trivially_copyable<T>::value, "To deduplicate this component, implement `uint32_t hash() const` and `operator==`.");
+			return memcmp(&p_a, &p_b, sizeof(T)) == 0;
+		}
+	}
 };
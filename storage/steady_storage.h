@@ -1,7 +1,9 @@
 #pragma once
 
-#include "core/templates/paged_allocator.h"
-#include "dense_vector.h"
+#include "../ecs.h"
+#include "core/os/memory.h"
+#include "core/templates/local_vector.h"
+#include "paged_sparse_index.h"
 #include "storage.h"
 
 /// Storage that is a lot useful when it's necessary to store big components:
@@ -16,15 +18,46 @@
 ///
 /// Note: The allocated memory is contiguous, but fragmented. Internally the
 /// storage creates some pages within the components are stored contiguosly.
+/// Each page tracks which slots are used, so it's possible to iterate the
+/// components page by page, in memory order, using `for_each`.
+/// The stored `Entities` list is sorted in memory order at the end of each
+/// stage that writes this storage, so the `Query` streams through the pages.
 template <class T>
 class SteadyStorage : public Storage<T> {
-	PagedAllocator<T, false> allocator;
-	DenseVector<T *> storage;
+	struct Page {
+		/// `page_size` slots, constructed only when used.
+		T *data = nullptr;
+		/// One bit per slot, set when used.
+		uint64_t *used = nullptr;
+		/// The `Entity` of each slot.
+		EntityID *entities = nullptr;
+		/// The position of each slot into the `entities` list.
+		uint32_t *positions = nullptr;
+	};
+
+	uint32_t page_shift = 0;
+	uint32_t page_mask = 0;
+	/// The pages never move once allocated, only the page table does.
+	LocalVector<Page> pages;
+	LocalVector<uint32_t> free_slots;
+	/// Points each `Entity` to its slot.
+	PagedSparseIndex entity_to_slot;
+	/// The stored `Entities`, in memory order when `is_sorted` is `true`.
+	LocalVector<EntityID> entities;
+	bool is_sorted = true;
 
 public:
+	SteadyStorage() {
+		set_page_size(200);
+	}
+
+	virtual ~SteadyStorage() {
+		reset();
+	}
+
 	virtual void configure(const Dictionary &p_config) override {
-		clear();
-		allocator.configure(p_config.get("page_size", 200));
+		reset();
+		set_page_size(p_config.get("page_size", 200));
 	}
 
 	virtual String get_type_name() const override {
@@ -35,42 +68,257 @@ public:
 		return true;
 	}
 
+	virtual bool notify_release_write() const override {
+		return true;
+	}
+
+	virtual void on_system_release() override {
+		sort_entities();
+	}
+
 	virtual void insert(EntityID p_entity, const T &p_data) override {
-		T *d = allocator.alloc();
-		*d = p_data;
-		storage.insert(p_entity, d);
-		StorageBase::notify_changed(p_entity);
+		uint32_t slot = entity_to_slot.get(p_entity);
+		if (slot != UINT32_MAX) {
+			// Already stored, just update the data.
+			*get_slot(slot) = p_data;
+			StorageBase::notify_changed(p_entity);
+			return;
+		}
+
+		slot = alloc_slot();
+		// Construct it in place first, since the component may store
+		// pointers to itself.
+		memnew_placement(get_slot(slot), T);
+		*get_slot(slot) = p_data;
+
+		Page &page = pages[slot >> page_shift];
+		const uint32_t offset = slot & page_mask;
+		page.used[offset >> 6] |= uint64_t(1) << (offset & 63);
+		page.entities[offset] = p_entity;
+		page.positions[offset] = entities.size();
+		entity_to_slot.set(p_entity, slot);
+
+		if (entities.size() > 0 && entity_to_slot.get_unchecked(entities[entities.size() - 1]) > slot) {
+			is_sorted = false;
+		}
+		entities.push_back(p_entity);
+		StorageBase::notify_inserted(p_entity);
+	}
+
+	virtual bool is_tracking_entities() const override {
+		return true;
 	}
 
 	virtual bool has(EntityID p_entity) const override {
-		return storage.has(p_entity);
+		return entity_to_slot.has(p_entity);
 	}
 
 	virtual T *get(EntityID p_entity, Space p_mode = Space::LOCAL) override {
 		StorageBase::notify_changed(p_entity);
-		return storage.get(p_entity);
+		return get_slot(get_entity_slot(p_entity));
 	}
 
 	virtual const T *get(EntityID p_entity, Space p_mode = Space::LOCAL) const override {
-		return storage.get(p_entity);
+		return get_slot(get_entity_slot(p_entity));
 	}
 
 	virtual void remove(EntityID p_entity) override {
-		ERR_FAIL_COND_MSG(storage.has(p_entity) == false, "No entity: " + itos(p_entity) + " in this storage.");
-		T *d = storage.get(p_entity);
-		storage.remove(p_entity);
-		allocator.free(d);
+		ERR_FAIL_COND_MSG(has(p_entity) == false, "No entity: " + itos(p_entity) + " in this storage.");
+		const uint32_t slot = entity_to_slot.get_unchecked(p_entity);
+		Page &page = pages[slot >> page_shift];
+		const uint32_t offset = slot & page_mask;
+
+		// Remove it from the `Entities` list, moving the last one in its place.
+		const uint32_t position = page.positions[offset];
+		const uint32_t last = entities.size() - 1;
+		if (position != last) {
+			const uint32_t last_slot = entity_to_slot.get_unchecked(entities[last]);
+			entities[position] = entities[last];
+			pages[last_slot >> page_shift].positions[last_slot & page_mask] = position;
+			is_sorted = false;
+		}
+		entities.remove_at(last);
+
+		get_slot(slot)->~T();
+		page.used[offset >> 6] &= ~(uint64_t(1) << (offset & 63));
+		entity_to_slot.unset(p_entity);
+		free_slots.push_back(slot);
+
 		// Make sure to remove as changed.
-		StorageBase::notify_updated(p_entity);
+		StorageBase::notify_removed(p_entity);
 	}
 
 	virtual void clear() override {
-		allocator.reset();
-		storage.clear();
-		StorageBase::flush_changed();
+		StorageBase::notify_clearing();
+		destroy_components();
+		// Keep the pages, all the slots are free now.
+		free_slots.clear();
+		for (int64_t slot = int64_t(pages.size() << page_shift) - 1; slot >= 0; slot -= 1) {
+			free_slots.push_back(slot);
+		}
+		StorageBase::notify_cleared();
 	}
 
 	virtual EntitiesBuffer get_stored_entities() const {
-		return { storage.get_entities().size(), storage.get_entities().ptr() };
+		return { entities.size(), entities.ptr() };
+	}
+
+	virtual StorageMemoryStats get_memory_stats() const override {
+		StorageMemoryStats stats = StorageBase::get_memory_stats();
+		// Each slot stores the component, its `Entity` and its position; the
+		// free slots of the pages are reserved but not used.
+		const uint64_t words = (get_page_size() + 63) >> 6;
+		stats.add(entities.size(), uint64_t(pages.size()) << page_shift, sizeof(T) + sizeof(EntityID) + sizeof(uint32_t));
+		stats.add(words * pages.size(), words * pages.size(), sizeof(uint64_t));
+		stats.add_vector(pages);
+		stats.add_vector(free_slots);
+		stats.add_vector(entities);
+		entity_to_slot.add_memory_stats(stats);
+		return stats;
+	}
+
+	/// Calls `p_func(EntityID, T *)` for each stored component, walking the
+	/// pages in memory order.
+	template <typename F>
+	void for_each(F p_func) {
+		for_each_slot([&](uint32_t p_slot, EntityID p_entity) {
+			StorageBase::notify_changed(p_entity);
+			p_func(p_entity, get_slot(p_slot));
+		});
+	}
+
+	/// Calls `p_func(EntityID, const T *)` for each stored component, walking
+	/// the pages in memory order.
+	template <typename F>
+	void for_each(F p_func) const {
+		for_each_slot([&](uint32_t p_slot, EntityID p_entity) {
+			p_func(p_entity, get_slot(p_slot));
+		});
+	}
+
+	/// Sorts the stored `Entities` list in memory order, so who iterates it
+	/// reads the pages linearly.
+	/// This is called automatically at the end of each stage that writes this
+	/// storage.
+	void sort_entities() {
+		if (is_sorted) {
+			// Nothing to do.
+			return;
+		}
+
+		uint32_t position = 0;
+		for_each_slot([&](uint32_t p_slot, EntityID p_entity) {
+			entities[position] = p_entity;
+			pages[p_slot >> page_shift].positions[p_slot & page_mask] = position;
+			position += 1;
+		});
+		is_sorted = true;
+	}
+
+	/// Returns the amount of slots in each page.
+	uint32_t get_page_size() const {
+		return page_mask + 1;
+	}
+
+	/// Returns the amount of allocated pages.
+	uint32_t get_page_count() const {
+		return pages.size();
+	}
+
+private:
+	_FORCE_INLINE_ uint32_t get_entity_slot(EntityID p_entity) const {
+#ifdef DEBUG_ENABLED
+		CRASH_COND_MSG(has(p_entity) == false, "This entity doesn't have anything stored into this storage.");
+#endif
+		return entity_to_slot.get_unchecked(p_entity);
+	}
+
+	_FORCE_INLINE_ T *get_slot(uint32_t p_slot) const {
+		return pages[p_slot >> page_shift].data + (p_slot & page_mask);
+	}
+
+	/// Calls `p_func(slot, EntityID)` for each used slot, in memory order.
+	template <typename F>
+	void for_each_slot(F p_func) const {
+		const uint32_t words = (get_page_size() + 63) >> 6;
+		for (uint32_t p = 0; p < pages.size(); p += 1) {
+			const Page &page = pages[p];
+			for (uint32_t w = 0; w < words; w += 1) {
+				uint64_t bits = page.used[w];
+				while (bits != 0) {
+					const uint32_t offset = (w << 6) + __builtin_ctzll(bits);
+					bits &= bits - 1;
+					p_func((p << page_shift) + offset, page.entities[offset]);
+				}
+			}
+		}
+	}
+
+	void set_page_size(uint32_t p_page_size) {
+		CRASH_COND_MSG(pages.size() != 0, "The page size can't change while the pages are allocated.");
+		// Power of two, so the slot is split using the bits.
+		const uint32_t size = next_power_of_2(MAX(p_page_size, uint32_t(1)));
+		page_shift = __builtin_ctz(size);
+		page_mask = size - 1;
+	}
+
+	uint32_t alloc_slot() {
+		if (unlikely(free_slots.size() == 0)) {
+			const uint32_t size = get_page_size();
+			const uint32_t words = (size + 63) >> 6;
+
+			Page page;
+			page.data = static_cast<T *>(StorageBase::alloc_memory(sizeof(T) * size));
+			page.used = static_cast<uint64_t *>(StorageBase::alloc_memory(sizeof(uint64_t) * words));
+			for (uint32_t w = 0; w < words; w += 1) {
+				page.used[w] = 0;
+			}
+			page.entities = static_cast<EntityID *>(StorageBase::alloc_memory(sizeof(EntityID) * size));
+			page.positions = static_cast<uint32_t *>(StorageBase::alloc_memory(sizeof(uint32_t) * size));
+			pages.push_back(page);
+
+			// Push the slots in reverse, so they are used in memory order.
+			const uint32_t first = (pages.size() - 1) << page_shift;
+			for (uint32_t i = size; i > 0; i -= 1) {
+				free_slots.push_back(first + i - 1);
+			}
+		}
+
+		const uint32_t slot = free_slots[free_slots.size() - 1];
+		free_slots.remove_at(free_slots.size() - 1);
+		return slot;
+	}
+
+	/// Destroys all the components, the pages are kept.
+	void destroy_components() {
+		const uint32_t words = (get_page_size() + 63) >> 6;
+		for_each_slot([&](uint32_t p_slot, EntityID p_entity) {
+			get_slot(p_slot)->~T();
+		});
+		for (uint32_t p = 0; p < pages.size(); p += 1) {
+			for (uint32_t w = 0; w < words; w += 1) {
+				pages[p].used[w] = 0;
+			}
+		}
+		entities.clear();
+		entity_to_slot.clear();
+		is_sorted = true;
+	}
+
+	/// Destroys all the components and frees the pages.
+	void reset() {
+		destroy_components();
+		const uint32_t size = get_page_size();
+		const uint32_t words = (size + 63) >> 6;
+		for (uint32_t p = 0; p < pages.size(); p += 1) {
+			StorageBase::free_memory(pages[p].data, sizeof(T) * size);
+			StorageBase::free_memory(pages[p].used, sizeof(uint64_t) * words);
+			StorageBase::free_memory(pages[p].entities, sizeof(EntityID) * size);
+			StorageBase::free_memory(pages[p].positions, sizeof(uint32_t) * size);
+		}
+		pages.reset();
+		free_slots.reset();
+		entities.reset();
+		entity_to_slot.reset();
 	}
 };
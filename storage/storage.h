@@ -1,6 +1,12 @@
 #pragma once
 
+#include "../memory/world_allocator.h"
+#include "core/templates/safe_refcount.h"
+#include "entities_log.h"
 #include "entity_list.h"
+#include "entity_signatures.h"
+#include "paged_sparse_index.h"
+#include "query_match_cache.h"
 
 /// Some stroages support `Entity` nesting, you can get local or global space
 /// data, by specifying one or the other.
@@ -19,7 +25,34 @@ struct EntitiesBuffer {
 
 /// Never override this directly. Always override the `Storage`.
 class StorageBase {
-	LocalVector<EntityList *> changed_listeners;
+	friend class World;
+
+	/// The change tick of the `World`, used to mark the changed components.
+	const SafeNumeric<uint32_t> *world_change_tick = nullptr;
+	/// The tick at which the component of each `Entity` changed last.
+	PagedSparseIndex changed_ticks;
+	/// The components of each `Entity`, set by the `World` when this storage
+	/// returns `true` from `is_tracking_entities`.
+	EntitySignatures *entity_signatures = nullptr;
+	/// The component ID of this storage, used with the `entity_signatures`.
+	uint32_t signature_component_id = UINT32_MAX;
+	/// The allocator of the `World`, set before `configure` is called.
+	WorldAllocator *allocator = nullptr;
+	/// When `true`, `notify_changed` doesn't mark the changes: check
+	/// `set_changes_deferred`.
+	bool changes_deferred = false;
+	/// The caches of the cached `Query`s using this storage, set by the
+	/// `World` when this storage tracks its `Entities`.
+	LocalVector<QueryMatchCache *> match_caches;
+	/// Incremented each time an `Entity` is inserted or removed. The `World`
+	/// seeds it with an unique serial in the high bits, so two storages never
+	/// have the same version.
+	uint64_t entities_version = 0;
+	/// When `true` the inserted and removed `Entities` are logged, set by the
+	/// `World` when a `Query` uses the `Added` or `Removed` filter.
+	bool entities_log_enabled = false;
+	EntitiesLog added_log;
+	EntitiesLog removed_log;
 
 public:
 	/// This function is called each time this storage is initialized.
@@ -41,6 +74,14 @@ public:
 		return false;
 	}
 
+	/// A storage return true when it calls `notify_inserted`, `notify_removed`,
+	/// `notify_clearing` and `notify_cleared` each time its `Entities` change:
+	/// in this case the `World` knows which storages have the `Entity`,
+	/// without calling `has` on all the storages.
+	virtual bool is_tracking_entities() const {
+		return false;
+	}
+
 	virtual bool has(EntityID p_entity) const {
 		CRASH_NOW_MSG("Override this function.");
 		return false;
@@ -65,6 +106,14 @@ public:
 		CRASH_NOW_MSG("Override this function.");
 	}
 
+	/// Immediately removes the `Component` from all these `Entities`.
+	/// Override this to remove them all at once.
+	virtual void remove_batch(const EntityID *p_entities, uint32_t p_count) {
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			remove(p_entities[i]);
+		}
+	}
+
 	virtual void clear() {
 		CRASH_NOW_MSG("Override this function.");
 	}
@@ -82,35 +131,275 @@ public:
 	/// returns `true`.
 	virtual void on_system_release() {}
 
+	/// Compacts the storage: sorts the data in `Entity` order and releases the
+	/// over-reserved memory, doing at most `r_budget` units of work.
+	/// The work done is subtracted from `r_budget`; returns `false` when out of
+	/// budget, so the next call continues the pass, `true` once the pass is
+	/// done. The `Entities` inserted while the pass is in progress may be left
+	/// out of order, for the next pass to sort.
+	/// Called by `World::compact_storages`, never while the systems run.
+	virtual bool compact(uint32_t &r_budget) {
+		return true;
+	}
+
+	/// Returns the memory used by this storage. The storages override this to
+	/// account their data, on top of the change ticks accounted here.
+	virtual StorageMemoryStats get_memory_stats() const {
+		StorageMemoryStats stats;
+		changed_ticks.add_memory_stats(stats);
+		added_log.add_memory_stats(stats);
+		removed_log.add_memory_stats(stats);
+		stats.live_count = get_stored_entities().count;
+		return stats;
+	}
+
 public:
-	void add_change_listener(EntityList *p_changed_listener) {
-		if (changed_listeners.find(p_changed_listener) == -1) {
-			changed_listeners.push_back(p_changed_listener);
-		}
+	/// Returns the tick used to mark the changed components.
+	uint32_t get_change_tick() const {
+		return world_change_tick ? world_change_tick->get() : 1;
+	}
+
+	/// Allocates the memory from the `World` allocator, or from the system
+	/// when the storage is not owned by a `World`.
+	/// The storages use this for their pages and arenas.
+	void *alloc_memory(uint64_t p_size) {
+		return allocator ? allocator->alloc(p_size) : memalloc(p_size);
 	}
 
-	void remove_change_listener(EntityList *p_changed_listener) {
-		const int64_t index = changed_listeners.find(p_changed_listener);
-		if (index != -1) {
-			changed_listeners.remove_at_unordered(index);
+	/// Releases the memory taken with `alloc_memory`, `p_size` must be the
+	/// same.
+	void free_memory(void *p_memory, uint64_t p_size) {
+		if (allocator) {
+			allocator->free(p_memory, p_size);
+		} else {
+			memfree(p_memory);
 		}
 	}
 
+	/// Marks the component of this `Entity` as changed at the current tick.
 	void notify_changed(EntityID p_entity) {
-		for (uint32_t i = 0; i < changed_listeners.size(); i += 1) {
-			changed_listeners[i]->insert(p_entity);
+		if (unlikely(changes_deferred)) {
+			return;
+		}
+		changed_ticks.set(p_entity, get_change_tick());
+	}
+
+	/// Same as `notify_changed`, but for many `Entities` at once.
+	void notify_changed(const EntityID *p_entities, uint32_t p_count) {
+		if (unlikely(changes_deferred)) {
+			return;
+		}
+		const uint32_t tick = get_change_tick();
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			changed_ticks.set(p_entities[i], tick);
 		}
 	}
 
+	/// The change ticks can't be written by many threads at once, so while
+	/// the components are fetched in parallel the changes are deferred: the
+	/// caller marks them, using `notify_changed`, once the threads are done.
+	/// Used by `Query::par_for_each`.
+	void set_changes_deferred(bool p_deferred) {
+		changes_deferred = p_deferred;
+	}
+
+	bool is_changes_deferred() const {
+		return changes_deferred;
+	}
+
+	/// Marks the changes of these `Entities`, fetched mutably while the
+	/// changes were deferred. The storages that track more than the change
+	/// ticks, in the fetch, override this to catch up.
+	virtual void notify_deferred_changed(const EntityID *p_entities, uint32_t p_count) {
+		notify_changed(p_entities, p_count);
+	}
+
+	/// Forgets the change of this `Entity`, used when the component is removed.
 	void notify_updated(EntityID p_entity) {
-		for (uint32_t i = 0; i < changed_listeners.size(); i += 1) {
-			changed_listeners[i]->remove(p_entity);
+		changed_ticks.unset(p_entity);
+	}
+
+	/// Returns `true` if the component of this `Entity` changed after
+	/// `p_since_tick` and not after `p_until_tick`.
+	bool is_changed(EntityID p_entity, uint32_t p_since_tick, uint32_t p_until_tick) const {
+		const uint32_t tick = changed_ticks.get(p_entity);
+		if (tick == UINT32_MAX) {
+			return false;
 		}
+		// Wrapping compare, so the ticks can overflow.
+		return int32_t(tick - p_since_tick) > 0 && int32_t(p_until_tick - tick) >= 0;
+	}
+
+	/// Moves the change ticks and the log ticks older than `p_oldest_tick`
+	/// to it, so they never get too old to be compared.
+	/// Called by `World::check_change_ticks`.
+	void clamp_change_ticks(uint32_t p_oldest_tick) {
+		changed_ticks.update_all([p_oldest_tick](uint32_t &r_tick) {
+			// Wrapping compare, so the ticks can overflow.
+			if (int32_t(r_tick - p_oldest_tick) < 0) {
+				r_tick = p_oldest_tick;
+			}
+		});
+		added_log.clamp_ticks(p_oldest_tick);
+		removed_log.clamp_ticks(p_oldest_tick);
 	}
 
+	/// Forgets all the changes, used when the storage is cleared.
 	void flush_changed() {
-		for (uint32_t i = 0; i < changed_listeners.size(); i += 1) {
-			changed_listeners[i]->clear();
+		changed_ticks.clear();
+	}
+
+	/// Returns a number that changes each time an `Entity` is inserted or
+	/// removed, or `0` when this storage doesn't track its `Entities`.
+	/// The `Any` and `Join` filters use it to know when their `Entities`
+	/// change.
+	uint64_t get_entities_version() const {
+		return is_tracking_entities() ? entities_version : 0;
+	}
+
+	bool is_entities_log_enabled() const {
+		return entities_log_enabled;
+	}
+
+	/// Returns `true` if the component was inserted to this `Entity` after
+	/// `p_since_tick` and not after `p_until_tick`.
+	bool is_added(EntityID p_entity, uint32_t p_since_tick, uint32_t p_until_tick) const {
+		return added_log.is_logged(p_entity, p_since_tick, p_until_tick);
+	}
+
+	/// Returns `true` if the component was removed from this `Entity` after
+	/// `p_since_tick` and not after `p_until_tick`.
+	bool is_removed(EntityID p_entity, uint32_t p_since_tick, uint32_t p_until_tick) const {
+		return removed_log.is_logged(p_entity, p_since_tick, p_until_tick);
+	}
+
+	/// Returns the `Entities` that got the component after `p_since_tick` and
+	/// not after `p_until_tick`. They may contain null `EntityID`s, and the
+	/// `Entities` that lost the component afterwards.
+	EntitiesBuffer get_added_entities(uint32_t p_since_tick, uint32_t p_until_tick) const {
+		EntitiesBuffer buffer;
+		added_log.get_window(p_since_tick, p_until_tick, buffer.entities, buffer.count);
+		return buffer;
+	}
+
+	/// Returns the `Entities` that lost the component after `p_since_tick`
+	/// and not after `p_until_tick`. They may contain null `EntityID`s, and
+	/// the `Entities` that got the component back afterwards.
+	EntitiesBuffer get_removed_entities(uint32_t p_since_tick, uint32_t p_until_tick) const {
+		EntitiesBuffer buffer;
+		removed_log.get_window(p_since_tick, p_until_tick, buffer.entities, buffer.count);
+		return buffer;
+	}
+
+	/// Drops the log entries done at `p_tick` or before.
+	void trim_entities_log(uint32_t p_tick) {
+		added_log.trim(p_tick);
+		removed_log.trim(p_tick);
+	}
+
+	/// Must be called when the component is inserted, marks it as changed.
+	void notify_inserted(EntityID p_entity) {
+		entities_version += 1;
+		notify_changed(p_entity);
+		if (entities_log_enabled) {
+			added_log.log(p_entity, get_change_tick());
+		}
+		if (entity_signatures) {
+			entity_signatures->insert(p_entity, signature_component_id);
+		}
+		for (uint32_t i = 0; i < match_caches.size(); i += 1) {
+			match_caches[i]->notify_dirty(p_entity);
+		}
+	}
+
+	/// Must be called when the component is removed.
+	void notify_removed(EntityID p_entity) {
+		entities_version += 1;
+		notify_updated(p_entity);
+		if (entities_log_enabled) {
+			removed_log.log(p_entity, get_change_tick());
+		}
+		if (entity_signatures) {
+			entity_signatures->remove(p_entity, signature_component_id);
+		}
+		for (uint32_t i = 0; i < match_caches.size(); i += 1) {
+			match_caches[i]->notify_dirty(p_entity);
+		}
+	}
+
+	/// Same as `notify_inserted`, but for many `Entities` at once.
+	void notify_inserted(const EntityID *p_entities, uint32_t p_count) {
+		entities_version += 1;
+		const uint32_t tick = get_change_tick();
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			changed_ticks.set(p_entities[i], tick);
+		}
+		if (entities_log_enabled) {
+			for (uint32_t i = 0; i < p_count; i += 1) {
+				added_log.log(p_entities[i], tick);
+			}
+		}
+		if (entity_signatures) {
+			for (uint32_t i = 0; i < p_count; i += 1) {
+				entity_signatures->insert(p_entities[i], signature_component_id);
+			}
+		}
+		for (uint32_t i = 0; i < match_caches.size(); i += 1) {
+			match_caches[i]->notify_dirty(p_entities, p_count);
+		}
+	}
+
+	/// Same as `notify_removed`, but for many `Entities` at once.
+	void notify_removed(const EntityID *p_entities, uint32_t p_count) {
+		entities_version += 1;
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			changed_ticks.unset(p_entities[i]);
+		}
+		if (entities_log_enabled) {
+			const uint32_t tick = get_change_tick();
+			for (uint32_t i = 0; i < p_count; i += 1) {
+				removed_log.log(p_entities[i], tick);
+			}
+		}
+		if (entity_signatures) {
+			for (uint32_t i = 0; i < p_count; i += 1) {
+				entity_signatures->remove(p_entities[i], signature_component_id);
+			}
+		}
+		for (uint32_t i = 0; i < match_caches.size(); i += 1) {
+			match_caches[i]->notify_dirty(p_entities, p_count);
+		}
+	}
+
+	/// Must be called before the storage is cleared, while the `Entities` are
+	/// still stored: logs their removal, and removes the component from
+	/// their signatures.
+	void notify_clearing() {
+		if (entities_log_enabled == false && entity_signatures == nullptr) {
+			return;
+		}
+		const EntitiesBuffer entities = get_stored_entities();
+		if (entities_log_enabled) {
+			const uint32_t tick = get_change_tick();
+			for (uint32_t i = 0; i < entities.count; i += 1) {
+				removed_log.log(entities.entities[i], tick);
+			}
+		}
+		if (entity_signatures) {
+			// Only the stored `Entities` have the bit set, no need to scan
+			// all the signatures.
+			for (uint32_t i = 0; i < entities.count; i += 1) {
+				entity_signatures->remove(entities.entities[i], signature_component_id);
+			}
+		}
+	}
+
+	/// Must be called when the storage is cleared.
+	void notify_cleared() {
+		entities_version += 1;
+		flush_changed();
+		for (uint32_t i = 0; i < match_caches.size(); i += 1) {
+			match_caches[i]->invalidate();
 		}
 	}
 
@@ -212,6 +501,22 @@ public:
 		CRASH_NOW_MSG("Override this function.");
 	}
 
+	/// Inserts `p_count` components: `p_data[i]` is assigned to `p_entities[i]`.
+	/// Override this to insert them all at once.
+	virtual void insert_batch(const EntityID *p_entities, const T *p_data, uint32_t p_count) {
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			insert(p_entities[i], p_data[i]);
+		}
+	}
+
+	/// Inserts the same component to all these `Entities`.
+	/// Override this to insert them all at once.
+	virtual void insert_batch(const EntityID *p_entities, const T &p_data, uint32_t p_count) {
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			insert(p_entities[i], p_data);
+		}
+	}
+
 	virtual T *get(EntityID p_entity, Space p_mode = Space::LOCAL) {
 		CRASH_NOW_MSG("Override this function.");
 		return nullptr;
@@ -228,10 +533,51 @@ public:
 	}
 };
 
+/// The concrete storage type of the component `C`, available when the
+/// component is declared using the `COMPONENT` macro: since the storage class
+/// is known at compile time, the caller can avoid the virtual calls.
+/// When the storage is not known at compile time, `type` is `void`.
+template <typename C, typename = void>
+struct godex_component_storage {
+	typedef void type;
+};
+
+template <typename C>
+struct godex_component_storage<C, std::void_t<decltype(std::remove_const_t<C>::create_storage())>> {
+	typedef std::remove_pointer_t<decltype(std::remove_const_t<C>::create_storage())> type;
+};
+
+/// Statistics of a shared storage.
+struct SharedStorageStats {
+	/// Amount of shared components alive.
+	uint32_t shared_count = 0;
+	/// Amount of `Entities` that reference a shared component.
+	uint32_t reference_count = 0;
+	/// Amount of `create_or_get_shared_component` calls that returned an
+	/// already existing shared component.
+	uint32_t deduplicated_count = 0;
+	/// Amount of shared components released automatically, once the last
+	/// `Entity` referencing them was removed.
+	uint32_t released_count = 0;
+	/// Bytes saved by sharing the components, compared to store a copy for
+	/// each `Entity`.
+	uint64_t memory_saved = 0;
+};
+
 class SharedStorageBase {
 public:
 	virtual ~SharedStorageBase() {}
 
+	virtual SharedStorageStats get_shared_stats() const {
+		return SharedStorageStats();
+	}
+
+	/// Returns the amount of `Entities` referencing this shared component.
+	virtual uint32_t get_reference_count(godex::SID p_id) const {
+		CRASH_NOW_MSG("Please override this function.");
+		return 0;
+	}
+
 	virtual godex::SID create_shared_component_dynamic(const Dictionary &p_data) {
 		CRASH_NOW_MSG("Please override this function.");
 		return UINT32_MAX;
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "../ecs.h"
+#include "storage.h"
+
+/// Tag storage.
+/// Storage for components without data, used to mark the `Entities`: it
+/// doesn't store any component, but just a bit per `Entity` and the list of
+/// the tagged `Entities`.
+///
+/// The `has` (and so the `Not` filter) is a single bit test, while the
+/// `Entities` list is used to iterate the tagged `Entities`.
+///
+/// ```
+/// struct Disabled {
+/// 	COMPONENT_TAG(Disabled)
+/// };
+/// ```
+template <class T>
+class TagStorage : public Storage<T> {
+	static_assert(std::is_empty<T>::value, "The components stored by the `TagStorage` can't have data, use `COMPONENT` instead.");
+
+	/// One bit per `Entity`, set when tagged.
+	LocalVector<uint64_t> bits;
+	/// The tagged `Entities`.
+	EntityList entities;
+	/// Since the tag has no data, all the `Entities` share this instance.
+	T tag;
+
+public:
+	virtual String get_type_name() const override {
+		return "TagStorage[" + String(typeid(T).name()) + "]";
+	}
+
+	virtual void insert(EntityID p_entity, const T &p_data) override {
+		if (has(p_entity)) {
+			// Already tagged, nothing is added.
+			StorageBase::notify_changed(p_entity);
+			return;
+		}
+		const uint32_t word = uint32_t(p_entity) >> 6;
+		if (unlikely(word >= bits.size())) {
+			const uint32_t start = bits.size();
+			bits.resize(MAX(word + 1, start * 2));
+			for (uint32_t i = start; i < bits.size(); i += 1) {
+				bits[i] = 0;
+			}
+		}
+		bits[word] |= uint64_t(1) << (uint32_t(p_entity) & 63);
+		entities.insert(p_entity);
+		StorageBase::notify_inserted(p_entity);
+	}
+
+	virtual bool is_tracking_entities() const override {
+		return true;
+	}
+
+	virtual bool has(EntityID p_entity) const override {
+		const uint32_t word = uint32_t(p_entity) >> 6;
+		return word < bits.size() && (bits[word] & (uint64_t(1) << (uint32_t(p_entity) & 63)));
+	}
+
+	virtual T *get(EntityID p_entity, Space p_mode = Space::LOCAL) override {
+		StorageBase::notify_changed(p_entity);
+		return &tag;
+	}
+
+	virtual const T *get(EntityID p_entity, Space p_mode = Space::LOCAL) const override {
+		return &tag;
+	}
+
+	virtual void remove(EntityID p_entity) override {
+		ERR_FAIL_COND_MSG(has(p_entity) == false, "No entity: " + itos(p_entity) + " in this storage.");
+		bits[uint32_t(p_entity) >> 6] &= ~(uint64_t(1) << (uint32_t(p_entity) & 63));
+		entities.remove(p_entity);
+		// Make sure to remove as changed.
+		StorageBase::notify_removed(p_entity);
+	}
+
+	virtual void clear() override {
+		StorageBase::notify_clearing();
+		// Clear only the words of the tagged `Entities`.
+		const EntityID *ptr = entities.get_entities_ptr();
+		for (uint32_t i = 0; i < entities.size(); i += 1) {
+			bits[uint32_t(ptr[i]) >> 6] = 0;
+		}
+		entities.clear();
+		StorageBase::notify_cleared();
+	}
+
+	virtual EntitiesBuffer get_stored_entities() const override {
+		return { entities.size(), entities.get_entities_ptr() };
+	}
+
+	virtual StorageMemoryStats get_memory_stats() const override {
+		StorageMemoryStats stats = StorageBase::get_memory_stats();
+		stats.add_vector(bits);
+		entities.add_memory_stats(stats);
+		return stats;
+	}
+};
@@ -24,6 +24,10 @@ struct SystemExeInfo {
 	RBSet<uint32_t> mutable_components_storage;
 	RBSet<uint32_t> mutable_databags;
 	RBSet<uint32_t> immutable_databags;
+	/// The keys of the `QueryMatchCache`s updated, check `CachedQuery`.
+	RBSet<uint64_t> mutable_query_caches;
+	/// The emitted events. The emitters of the same event don't conflict with
+	/// each other, nor with the receivers.
 	RBSet<uint32_t> events_emitters;
 	OAHashMap<uint32_t, RBSet<String>> events_receivers;
 
@@ -38,6 +42,7 @@ struct SystemExeInfo {
 		mutable_components_storage.clear();
 		mutable_databags.clear();
 		immutable_databags.clear();
+		mutable_query_caches.clear();
 		events_emitters.clear();
 		events_receivers.clear();
 
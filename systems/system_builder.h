@@ -51,6 +51,18 @@ struct InfoConstructor<Query<Qcs...> &, Cs...> : InfoConstructor<Cs...> {
 	}
 };
 
+/// Fetches the argument `CachedQuery`.
+/// ```
+/// void test_func(CachedQuery<const Component> &query){}
+/// ```
+template <class... Qcs, class... Cs>
+struct InfoConstructor<CachedQuery<Qcs...> &, Cs...> : InfoConstructor<Cs...> {
+	InfoConstructor(SystemExeInfo &r_info) :
+			InfoConstructor<Cs...>(r_info) {
+		CachedQuery<Qcs...>::get_components(r_info);
+	}
+};
+
 /// Fetches the `Databag`.
 /// The `Databag` can be taken as mutable or immutable pointer.
 /// ```
@@ -170,7 +182,8 @@ template <class E, typename EmitterName>
 struct DataFetcher<EventsReceiver<E, EmitterName> &> {
 	EventsReceiver<E, EmitterName> inner;
 
-	DataFetcher(World *p_world) {}
+	DataFetcher(World *p_world) :
+			inner(p_world) {}
 
 	void initiate_process(World *p_world) {
 		inner.initiate_process(p_world);
@@ -178,7 +191,9 @@ struct DataFetcher<EventsReceiver<E, EmitterName> &> {
 
 	void conclude_process(World *p_world) {}
 
-	void set_active(bool p_active) {}
+	void set_active(bool p_active) {
+		inner.set_active(p_active);
+	}
 };
 
 /// Query
@@ -202,6 +217,27 @@ struct DataFetcher<Query<Cs...> &> {
 	}
 };
 
+/// CachedQuery
+template <class... Cs>
+struct DataFetcher<CachedQuery<Cs...> &> {
+	CachedQuery<Cs...> inner;
+
+	DataFetcher(World *p_world) :
+			inner(p_world) {}
+
+	void initiate_process(World *p_world) {
+		inner.initiate_process(p_world);
+	}
+
+	void conclude_process(World *p_world) {
+		inner.conclude_process(p_world);
+	}
+
+	void set_active(bool p_active) {
+		inner.set_world_notification_active(p_active);
+	}
+};
+
 /// Databag
 template <class D>
 struct DataFetcher<D *> {
@@ -3,6 +3,7 @@
 
 #include "tests/test_macros.h"
 
+#include "../storage/entity_bit_list.h"
 #include "../storage/storage.h"
 #include "core/os/os.h"
 
@@ -157,6 +158,97 @@ TEST_CASE("[Modules][ECS] Test ECS EntityList.") {
 		CHECK(changed.is_empty());
 	}
 }
+
+TEST_CASE("[Modules][ECS] Test ECS EntityBitList.") {
+	EntityBitList list;
+
+	list.insert(3);
+	list.insert(3);
+	list.insert(64);
+	list.insert(5000);
+	CHECK(list.size() == 3);
+	CHECK(list.has(3));
+	CHECK(list.has(64));
+	CHECK(list.has(5000));
+	CHECK(list.has(4) == false);
+	CHECK(list.has(90000000) == false);
+
+	// The insertion order is preserved.
+	CHECK(list.get_entities_ptr()[0] == EntityID(3));
+	CHECK(list.get_entities_ptr()[1] == EntityID(64));
+	CHECK(list.get_entities_ptr()[2] == EntityID(5000));
+
+	list.remove(64);
+	list.remove(65);
+	CHECK(list.size() == 2);
+	CHECK(list.has(64) == false);
+	CHECK(list.has(3));
+	CHECK(list.has(5000));
+
+	list.clear();
+	CHECK(list.is_empty());
+	CHECK(list.has(3) == false);
+	CHECK(list.has(5000) == false);
+
+	// Bulk insert.
+	const EntityID entities[] = { 1, 2, 2, 1000000 };
+	list.insert(entities, 4);
+	CHECK(list.size() == 3);
+	CHECK(list.has(1));
+	CHECK(list.has(2));
+	CHECK(list.has(1000000));
+}
+
+TEST_CASE("[Modules][ECS] Test ECS EntityBitList union and intersection.") {
+	EntityBitList a;
+	EntityBitList b;
+
+	for (uint32_t i = 0; i < 1000; i += 2) {
+		a.insert(i);
+	}
+	for (uint32_t i = 0; i < 1000; i += 3) {
+		b.insert(i);
+	}
+	b.insert(200000);
+
+	{
+		EntityBitList u = a;
+		u.unite(b);
+		for (uint32_t i = 0; i < 1000; i += 1) {
+			CHECK(u.has(i) == (i % 2 == 0 || i % 3 == 0));
+		}
+		CHECK(u.has(200000));
+		// 500 multiples of 2 + 334 multiples of 3 - 167 multiples of 6 + 1.
+		CHECK(u.size() == 668);
+
+		uint32_t count = 0;
+		u.for_each([&](EntityID p_entity) {
+			CHECK(u.has(p_entity));
+			count += 1;
+		});
+		CHECK(count == 668);
+	}
+
+	{
+		EntityBitList n = a;
+		n.intersect(b);
+		for (uint32_t i = 0; i < 1000; i += 1) {
+			CHECK(n.has(i) == (i % 6 == 0));
+		}
+		CHECK(n.has(200000) == false);
+		CHECK(n.size() == 167);
+
+		// Intersect with an empty list.
+		n.intersect(EntityBitList());
+		CHECK(n.is_empty());
+		CHECK(n.has(0) == false);
+
+		// The list is still usable.
+		n.insert(6);
+		CHECK(n.has(6));
+		CHECK(n.size() == 1);
+	}
+}
 } // namespace godex_entity_list_tests
 
 #endif
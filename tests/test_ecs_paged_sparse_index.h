@@ -0,0 +1,166 @@
+#ifndef TEST_ECS_PAGED_SPARSE_INDEX_H
+#define TEST_ECS_PAGED_SPARSE_INDEX_H
+
+#include "tests/test_macros.h"
+
+#include "../storage/dense_vector.h"
+#include "../storage/entity_list.h"
+#include "../storage/paged_sparse_index.h"
+#include "core/os/os.h"
+
+namespace godex_paged_sparse_index_tests {
+
+TEST_CASE("[Modules][ECS] Test PagedSparseIndex.") {
+	PagedSparseIndex index;
+
+	CHECK(index.has(0) == false);
+	CHECK(index.get(0) == UINT32_MAX);
+	CHECK(index.get_allocated_pages() == 0);
+
+	index.set(1, 10);
+	index.set(2, 20);
+	CHECK(index.get(1) == 10);
+	CHECK(index.get(2) == 20);
+	// Both in the same page.
+	CHECK(index.get_allocated_pages() == 1);
+
+	// High ID, only one more page is allocated.
+	index.set(50000000, 30);
+	CHECK(index.get(50000000) == 30);
+	CHECK(index.has(50000001) == false);
+	CHECK(index.get_allocated_pages() == 2);
+
+	index.update(50000000, 40);
+	CHECK(index.get(50000000) == 40);
+
+	// Copy is deep.
+	{
+		PagedSparseIndex copy = index;
+		CHECK(copy.get(1) == 10);
+		CHECK(copy.get(50000000) == 40);
+		copy.unset(1);
+		CHECK(copy.has(1) == false);
+		CHECK(index.has(1));
+	}
+
+	// The page is released once empty.
+	index.unset(50000000);
+	CHECK(index.has(50000000) == false);
+	CHECK(index.get_allocated_pages() == 1);
+
+	index.unset(1);
+	CHECK(index.get_allocated_pages() == 1);
+	index.unset(2);
+	CHECK(index.get_allocated_pages() == 0);
+
+	// Unset something not set does nothing.
+	index.unset(2);
+	index.unset(90000000);
+	CHECK(index.get_allocated_pages() == 0);
+
+	index.set(3, 0);
+	index.set(9000, 1);
+	index.clear();
+	CHECK(index.has(3) == false);
+	CHECK(index.has(9000) == false);
+	// The pages are kept, so setting the indices again doesn't allocate.
+	CHECK(index.get_allocated_pages() == 2);
+	index.set(3, 2);
+	CHECK(index.get(3) == 2);
+	CHECK(index.get_allocated_pages() == 2);
+
+	// The page not used since the previous `clear` is freed.
+	index.clear();
+	CHECK(index.has(3) == false);
+	CHECK(index.get_allocated_pages() == 1);
+	index.clear();
+	CHECK(index.get_allocated_pages() == 0);
+
+	// The `EntityID`s used once don't keep the memory.
+	for (uint32_t f = 0; f < 100; f += 1) {
+		index.set(f * PagedSparseIndex::PAGE_SIZE, f);
+		index.clear();
+		CHECK(index.get_allocated_pages() <= 2);
+	}
+
+	index.set(3, 2);
+	index.reset();
+	CHECK(index.has(3) == false);
+	CHECK(index.get_allocated_pages() == 0);
+}
+
+TEST_CASE("[Modules][ECS] Test DenseVector and EntityList with sparse high IDs.") {
+	DenseVector<int> storage;
+	EntityList list;
+
+	// 50 entities spread across a huge ID range.
+	for (uint32_t i = 0; i < 50; i += 1) {
+		const EntityID entity = 10000000 + i * 100000;
+		storage.insert(entity, i);
+		list.insert(entity);
+	}
+
+	for (uint32_t i = 0; i < 50; i += 1) {
+		const EntityID entity = 10000000 + i * 100000;
+		CHECK(storage.has(entity));
+		CHECK(storage.get(entity) == int(i));
+		CHECK(list.has(entity));
+	}
+	CHECK(storage.has(0) == false);
+	CHECK(list.has(0) == false);
+	CHECK(list.size() == 50);
+
+	// Remove half of them, the others must still be valid.
+	for (uint32_t i = 0; i < 50; i += 2) {
+		const EntityID entity = 10000000 + i * 100000;
+		storage.remove(entity);
+		list.remove(entity);
+	}
+
+	for (uint32_t i = 0; i < 50; i += 1) {
+		const EntityID entity = 10000000 + i * 100000;
+		CHECK(storage.has(entity) == (i % 2 == 1));
+		CHECK(list.has(entity) == (i % 2 == 1));
+		if (i % 2 == 1) {
+			CHECK(storage.get(entity) == int(i));
+		}
+	}
+	CHECK(storage.get_entities().size() == 25);
+	CHECK(list.size() == 25);
+
+	list.clear();
+	CHECK(list.is_empty());
+	for (uint32_t i = 0; i < 50; i += 1) {
+		CHECK(list.has(10000000 + i * 100000) == false);
+	}
+}
+
+TEST_CASE("[Modules][ECS][Benchmark] Benchmark sparse high ID workload." * doctest::skip()) {
+	// Run it with: `--test --no-skip --test-case="*Benchmark sparse high ID*"`
+	const uint32_t frames = 1000;
+	const uint32_t entities = 50;
+	const uint32_t stride = 1000;
+
+	DenseVector<int> storage;
+	EntityList changed;
+
+	const uint64_t start = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t f = 0; f < frames; f += 1) {
+		// IDs only grow, like on a long running session.
+		const uint32_t base = f * entities * stride;
+		for (uint32_t i = 0; i < entities; i += 1) {
+			storage.insert(base + i * stride, i);
+			changed.insert(base + i * stride);
+		}
+		for (uint32_t i = 0; i < entities; i += 1) {
+			storage.remove(base + i * stride);
+		}
+		changed.clear();
+	}
+	const uint64_t end = OS::get_singleton()->get_ticks_usec();
+
+	print_line("Sparse high ID workload, " + itos(frames) + " frames: " + itos(end - start) + "us");
+}
+} // namespace godex_paged_sparse_index_tests
+
+#endif // TEST_ECS_PAGED_SPARSE_INDEX_H
@@ -121,4 +121,49 @@ TEST_CASE("[Modules][ECS] Test `PipelineCommands`.") {
 	CHECK(Math::is_equal_approx(storage->get(entity_3)->origin.x, real_t(600.0)));
 }
 } // namespace godex_tests_pipeline
+
+namespace godex_tests_pipeline {
+
+void test_world_destroyed_system(Query<TransformComponent> &p_query) {
+	for (auto [transform] : p_query) {
+		transform->origin.x += 1.0;
+	}
+}
+
+TEST_CASE("[Modules][ECS] Test destroy the `World` before the `Pipeline`.") {
+	Pipeline pipeline;
+
+	{
+		godex::system_id system_id = ECS::register_system(test_world_destroyed_system, "test_world_destroyed_system").get_id();
+
+		PipelineBuilder pipeline_builder;
+		pipeline_builder.add_system(system_id);
+		pipeline_builder.build(pipeline);
+	}
+
+	World *world = memnew(World);
+	world->create_entity().with(TransformComponent());
+
+	const Token token = pipeline.prepare_world(world);
+	pipeline.set_active(token, true);
+	pipeline.dispatch(token);
+
+	// The `World` releases itself from the pipeline.
+	memdelete(world);
+	CHECK(pipeline.get_token(world).is_valid() == false);
+
+	// The pipeline can still prepare a new `World`.
+	World world_2;
+	const EntityID entity = world_2
+									.create_entity()
+									.with(TransformComponent());
+	const Token token_2 = pipeline.prepare_world(&world_2);
+	CHECK(token_2.is_valid());
+	pipeline.set_active(token_2, true);
+	pipeline.dispatch(token_2);
+
+	Storage<TransformComponent> *storage = world_2.get_storage<TransformComponent>();
+	CHECK(Math::is_equal_approx(storage->get(entity)->origin.x, real_t(1.0)));
+}
+} // namespace godex_tests_pipeline
 #endif // TEST_ECS_PIPELINE_H
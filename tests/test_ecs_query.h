@@ -10,6 +10,8 @@
 #include "../storage/batch_storage.h"
 #include "../storage/dense_vector_storage.h"
 #include "../world/world.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
 
 struct TagQueryTestComponent {
 	COMPONENT(TagQueryTestComponent, DenseVectorStorage)
@@ -28,6 +30,24 @@ struct TagC {
 	COMPONENT(TagC, DenseVectorStorage)
 };
 
+struct QueryBenchmarkA {
+	COMPONENT(QueryBenchmarkA, DenseVectorStorage)
+
+	float value = 0.0;
+};
+
+struct QueryBenchmarkB {
+	COMPONENT(QueryBenchmarkB, DenseVectorStorage)
+
+	float value = 1.0;
+};
+
+struct QueryBenchmarkC {
+	COMPONENT(QueryBenchmarkC, DenseVectorStorage)
+
+	float value = 2.0;
+};
+
 struct TestFixedSizeEvent {
 	COMPONENT_BATCH(TestFixedSizeEvent, DenseVector, 2)
 	static void _bind_methods() {}
@@ -1228,6 +1248,38 @@ TEST_CASE("[Modules][ECS] Test DynamicQuery changed.") {
 	}
 }
 
+TEST_CASE("[Modules][ECS] Test the change ticks clamp.") {
+	World world;
+
+	EntityID entity_1 = world.create_entity().with(TagA());
+	EntityID entity_2 = world.create_entity().with(TagA());
+
+	Query<EntityID, Changed<const TagA>> query(&world);
+
+	world.get_storage<TagA>()->notify_changed(entity_1);
+	const uint32_t oldest_tick = world.advance_change_tick() + 1;
+	world.advance_change_tick();
+	world.get_storage<TagA>()->notify_changed(entity_2);
+
+	// The tick didn't advance enough, nothing is clamped.
+	world.check_change_ticks();
+
+	// The change of `entity_1` and the `Query` tick are older, so clamped:
+	// only the newer change is taken.
+	world.clamp_change_ticks(oldest_tick);
+
+	query.initiate_process(&world);
+	CHECK(query.has(entity_1) == false);
+	CHECK(query.has(entity_2));
+	query.conclude_process(&world);
+
+	// The next run doesn't take them again.
+	query.initiate_process(&world);
+	CHECK(query.has(entity_1) == false);
+	CHECK(query.has(entity_2) == false);
+	query.conclude_process(&world);
+}
+
 TEST_CASE("[Modules][ECS] Test static query check query type fetch.") {
 	World world;
 
@@ -2233,6 +2285,587 @@ TEST_CASE("[Modules][ECS] Test static query Join filter.") {
 		}
 	}
 }
+
+TEST_CASE("[Modules][ECS] Test static query Any and Join union cache.") {
+	World world;
+
+	const EntityID entity_1 = world.create_entity().with(TagA());
+	const EntityID entity_2 = world.create_entity().with(TagB());
+
+	QueryStorage<0, Any<const TagA, const TagB>> any(&world);
+	QueryStorage<0, Join<const TagA, const TagB>> join(&world);
+
+	any.initiate_process(&world);
+	join.initiate_process(&world);
+	CHECK(any.entities.size() == 2);
+	CHECK(join.entities.size() == 2);
+	const uint64_t any_version = any.entities_version;
+	const uint64_t join_version = join.entities_version;
+	CHECK(any_version != UINT64_MAX);
+	any.conclude_process(&world);
+	join.conclude_process(&world);
+
+	// Nothing changed, so the union is reused.
+	any.initiate_process(&world);
+	join.initiate_process(&world);
+	CHECK(any.entities_version == any_version);
+	CHECK(join.entities_version == join_version);
+	CHECK(any.entities.size() == 2);
+	any.conclude_process(&world);
+	join.conclude_process(&world);
+
+	// A new `Entity` changes the version, so the union is rebuilt.
+	const EntityID entity_3 = world.create_entity().with(TagB());
+	any.initiate_process(&world);
+	join.initiate_process(&world);
+	CHECK(any.entities_version != any_version);
+	CHECK(join.entities_version != join_version);
+	CHECK(any.entities.size() == 3);
+	CHECK(join.entities.size() == 3);
+	CHECK(any.filter_satisfied(entity_3));
+	any.conclude_process(&world);
+	join.conclude_process(&world);
+
+	// The same for the removed components.
+	world.get_storage<TagA>()->remove(entity_1);
+	any.initiate_process(&world);
+	CHECK(any.entities.size() == 2);
+	CHECK(any.filter_satisfied(entity_1) == false);
+	CHECK(any.filter_satisfied(entity_2));
+	any.conclude_process(&world);
+}
+
+TEST_CASE("[Modules][ECS] Test query devirtualized storage.") {
+	ECS::register_component<QueryBenchmarkA>();
+	ECS::register_component<QueryBenchmarkB>();
+
+	CHECK((std::is_same<godex_component_storage<QueryBenchmarkA>::type, DenseVectorStorage<QueryBenchmarkA>>::value));
+	CHECK((std::is_same<godex_component_storage<const QueryBenchmarkA>::type, DenseVectorStorage<QueryBenchmarkA>>::value));
+	// The storage of `TestEvent` is not known at compile time.
+	CHECK((std::is_void<godex_component_storage<TestEvent>::type>::value));
+
+	World world;
+
+	for (uint32_t i = 0; i < 100; i += 1) {
+		QueryBenchmarkA a;
+		a.value = i;
+		if (i % 2 == 0) {
+			world.create_entity().with(a).with(QueryBenchmarkB());
+		} else {
+			world.create_entity().with(a);
+		}
+	}
+
+	QueryStorage<0, QueryBenchmarkA, const QueryBenchmarkB> storage(&world);
+	storage.initiate_process(&world);
+	CHECK(storage.is_static_storage);
+	CHECK((storage.QueryStorage<1, const QueryBenchmarkB>::is_static_storage));
+	storage.conclude_process(&world);
+
+	Query<EntityID, QueryBenchmarkA, const QueryBenchmarkB> query(&world);
+	query.initiate_process(&world);
+
+	uint32_t count = 0;
+	for (auto [entity, a, b] : query) {
+		CHECK(entity % 2 == 0);
+		CHECK(a->value == entity);
+		CHECK(b->value == 1.0);
+		count += 1;
+	}
+	CHECK(count == 50);
+
+	query.conclude_process(&world);
+}
+
+TEST_CASE("[Modules][ECS][Benchmark] Benchmark query devirtualized fetch." * doctest::skip()) {
+	// Run it with: `--test --no-skip --test-case="*Benchmark query devirtualized*"`
+	if (QueryBenchmarkA::get_component_id() == UINT32_MAX) {
+		ECS::register_component<QueryBenchmarkA>();
+		ECS::register_component<QueryBenchmarkB>();
+	}
+	ECS::register_component<QueryBenchmarkC>();
+
+	const uint32_t entities = 1000000;
+	const uint32_t frames = 10;
+
+	World world;
+	for (uint32_t i = 0; i < entities; i += 1) {
+		world.create_entity()
+				.with(QueryBenchmarkA())
+				.with(QueryBenchmarkB())
+				.with(QueryBenchmarkC());
+	}
+
+	// Before: the entities are fetched through the virtual `has` and `get`.
+	{
+		Storage<QueryBenchmarkA> *storage_a = world.get_storage<QueryBenchmarkA>();
+		const Storage<QueryBenchmarkB> *storage_b = world.get_storage<QueryBenchmarkB>();
+		const Storage<QueryBenchmarkC> *storage_c = world.get_storage<QueryBenchmarkC>();
+
+		const uint64_t start = OS::get_singleton()->get_ticks_usec();
+		for (uint32_t f = 0; f < frames; f += 1) {
+			const EntitiesBuffer buffer = storage_a->get_stored_entities();
+			for (uint32_t i = 0; i < buffer.count; i += 1) {
+				const EntityID entity = buffer.entities[i];
+				if (storage_a->has(entity) && storage_b->has(entity) && storage_c->has(entity)) {
+					storage_a->get(entity)->value += storage_b->get(entity)->value * storage_c->get(entity)->value;
+				}
+			}
+		}
+		const uint64_t end = OS::get_singleton()->get_ticks_usec();
+		print_line("Virtual fetch, " + itos(entities) + " entities, " + itos(frames) + " frames: " + itos(end - start) + "us");
+	}
+
+	// After: the `Query` calls the `DenseVectorStorage` directly.
+	{
+		Query<QueryBenchmarkA, const QueryBenchmarkB, const QueryBenchmarkC> query(&world);
+
+		const uint64_t start = OS::get_singleton()->get_ticks_usec();
+		for (uint32_t f = 0; f < frames; f += 1) {
+			query.initiate_process(&world);
+			for (auto [a, b, c] : query) {
+				a->value += b->value * c->value;
+			}
+			query.conclude_process(&world);
+		}
+		const uint64_t end = OS::get_singleton()->get_ticks_usec();
+		print_line("Devirtualized Query, " + itos(entities) + " entities, " + itos(frames) + " frames: " + itos(end - start) + "us");
+	}
+}
+
+TEST_CASE("[Modules][ECS] Test static query par_for_each.") {
+	ECS::register_component<QueryBenchmarkA>();
+	ECS::register_component<QueryBenchmarkB>();
+
+	for (uint32_t grouped = 0; grouped < 2; grouped += 1) {
+		World world;
+		if (grouped == 1) {
+			// The `Query` iterates the packed range of the group.
+			world.create_group<QueryBenchmarkA, QueryBenchmarkB>();
+		}
+
+		for (uint32_t i = 0; i < 10000; i += 1) {
+			QueryBenchmarkA a;
+			a.value = i;
+			if (i % 3 == 0) {
+				world.create_entity().with(a).with(QueryBenchmarkB());
+			} else {
+				world.create_entity().with(a);
+			}
+		}
+
+		world.advance_change_tick();
+		const uint32_t tick = world.get_change_tick();
+
+		Query<EntityID, QueryBenchmarkA, const QueryBenchmarkB> query(&world);
+		query.initiate_process(&world);
+		CHECK(query.is_packed() == (grouped == 1));
+
+		// Called by many threads at once, so it only counts.
+		SafeNumeric<uint32_t> count;
+		SafeNumeric<uint32_t> wrong_entities;
+		query.par_for_each([&](QueryResultTuple<EntityID, QueryBenchmarkA, const QueryBenchmarkB> p_result) {
+			auto [entity, a, b] = p_result;
+			if (entity % 3 != 0) {
+				wrong_entities.increment();
+			}
+			a->value += b->value;
+			count.increment();
+		},
+				64);
+		query.conclude_process(&world);
+
+		CHECK(count.get() == 3334);
+		CHECK(wrong_entities.get() == 0);
+
+		// The fetched components are changed, once the tasks are done.
+		const Storage<QueryBenchmarkA> *storage = world.get_storage<QueryBenchmarkA>();
+		for (uint32_t i = 0; i < 10000; i += 1) {
+			if (i % 3 == 0) {
+				CHECK(storage->get(i)->value == i + 1);
+				CHECK(storage->is_changed(i, tick - 1, tick));
+			} else {
+				CHECK(storage->get(i)->value == i);
+				CHECK(storage->is_changed(i, tick - 1, tick) == false);
+			}
+		}
+		CHECK(storage->is_changes_deferred() == false);
+	}
+
+	// The `Create` filter inserts while fetching, so it's rejected.
+	static_assert(query_is_par_compatible<Maybe<const QueryBenchmarkB>>::value);
+	static_assert(query_is_par_compatible<Create<QueryBenchmarkA>>::value == false);
+	static_assert(query_is_par_compatible<Maybe<Create<QueryBenchmarkA>>>::value == false);
+}
+
+TEST_CASE("[Modules][ECS] Test static query par_for_each with a hierarchical storage.") {
+	World world;
+
+	// Pairs of `Entities`, the second is child of the first:
+	// Entity 0           1 Local | 1 Global
+	//  |- Entity 1       1 Local | 2 Global
+	for (uint32_t i = 0; i < 1000; i += 2) {
+		const EntityID parent = world
+										.create_entity()
+										.with(TransformComponent(Transform3D(Basis(), Vector3(1, 0, 0))));
+		world
+				.create_entity()
+				.with(Child(parent))
+				.with(TransformComponent(Transform3D(Basis(), Vector3(1, 0, 0))));
+	}
+
+	Query<TransformComponent> query(&world);
+	query.initiate_process(&world);
+	query.par_for_each([](QueryResultTuple<TransformComponent> p_result) {
+		auto [transform] = p_result;
+		transform->origin.x += 1.0;
+	},
+			16);
+	query.conclude_process(&world);
+
+	// The parented `Entities` are flushed, as the system does once released.
+	HierarchicalStorage<TransformComponent> *storage = static_cast<HierarchicalStorage<TransformComponent> *>(world.get_storage<TransformComponent>());
+	CHECK(storage->is_changes_deferred() == false);
+	storage->flush_changes();
+
+	for (uint32_t i = 0; i < 1000; i += 2) {
+		const TransformComponent *parent = const_cast<const HierarchicalStorage<TransformComponent> *>(storage)->get(i, Space::GLOBAL);
+		const TransformComponent *child = const_cast<const HierarchicalStorage<TransformComponent> *>(storage)->get(i + 1, Space::GLOBAL);
+		CHECK(Math::is_equal_approx(parent->origin.x, real_t(2.0)));
+		CHECK(Math::is_equal_approx(child->origin.x, real_t(4.0)));
+	}
+}
+
+TEST_CASE("[Modules][ECS] Test static query for_each_chunk.") {
+	ECS::register_component<QueryBenchmarkA>();
+	ECS::register_component<QueryBenchmarkB>();
+
+	for (uint32_t grouped = 0; grouped < 2; grouped += 1) {
+		World world;
+		if (grouped == 1) {
+			// The chunks point to the packed range of the group.
+			world.create_group<QueryBenchmarkA, QueryBenchmarkB>();
+		}
+
+		for (uint32_t i = 0; i < 1000; i += 1) {
+			QueryBenchmarkA a;
+			a.value = i;
+			if (i % 3 == 0) {
+				world.create_entity().with(a).with(QueryBenchmarkB());
+			} else {
+				world.create_entity().with(a);
+			}
+		}
+
+		world.advance_change_tick();
+		const uint32_t tick = world.get_change_tick();
+
+		Query<EntityID, QueryBenchmarkA, const QueryBenchmarkB> query(&world);
+		query.initiate_process(&world);
+		CHECK(query.is_packed() == (grouped == 1));
+
+		uint32_t count = 0;
+		uint32_t chunks = 0;
+		uint32_t wrong_entities = 0;
+		query.for_each_chunk([&](ChunkView<EntityID, QueryBenchmarkA, const QueryBenchmarkB> &p_chunk) {
+			CHECK(p_chunk.is_gathered() == (grouped == 0));
+			const EntityID *entities = p_chunk.get<0>();
+			QueryBenchmarkA *a = p_chunk.get<1>();
+			const QueryBenchmarkB *b = p_chunk.get<2>();
+			for (uint32_t i = 0; i < p_chunk.get_count(); i += 1) {
+				if (entities[i] % 3 != 0 || a[i].value != float(uint32_t(entities[i]))) {
+					wrong_entities += 1;
+				}
+				a[i].value += b[i].value;
+			}
+			count += p_chunk.get_count();
+			chunks += 1;
+		},
+				100);
+		query.conclude_process(&world);
+
+		CHECK(count == 334);
+		CHECK(wrong_entities == 0);
+		if (grouped == 0) {
+			// Gathered in chunks of 100 `Entities`.
+			CHECK(chunks == 4);
+		}
+
+		// The gathered components are written back, and marked as changed.
+		const Storage<QueryBenchmarkA> *storage = world.get_storage<QueryBenchmarkA>();
+		for (uint32_t i = 0; i < 1000; i += 1) {
+			if (i % 3 == 0) {
+				CHECK(storage->get(i)->value == i + 1);
+				CHECK(storage->is_changed(i, tick - 1, tick));
+			} else {
+				CHECK(storage->get(i)->value == i);
+				CHECK(storage->is_changed(i, tick - 1, tick) == false);
+			}
+		}
+
+		// A single `DenseVectorStorage` is a single chunk, taken directly
+		// from the storage memory.
+		world.advance_change_tick();
+		const uint32_t single_tick = world.get_change_tick();
+		Query<EntityID, QueryBenchmarkA> single_query(&world);
+		single_query.initiate_process(&world);
+		count = 0;
+		chunks = 0;
+		wrong_entities = 0;
+		single_query.for_each_chunk([&](ChunkView<EntityID, QueryBenchmarkA> &p_chunk) {
+			CHECK(p_chunk.is_gathered() == false);
+			const EntityID *entities = p_chunk.get<0>();
+			QueryBenchmarkA *a = p_chunk.get<1>();
+			for (uint32_t i = 0; i < p_chunk.get_count(); i += 1) {
+				const uint32_t expected = uint32_t(entities[i]) + (entities[i] % 3 == 0 ? 1 : 0);
+				if (a[i].value != float(expected)) {
+					wrong_entities += 1;
+				}
+			}
+			count += p_chunk.get_count();
+			chunks += 1;
+		},
+				100);
+		single_query.conclude_process(&world);
+
+		CHECK(count == 1000);
+		CHECK(chunks == 1);
+		CHECK(wrong_entities == 0);
+		CHECK(storage->is_changed(0, single_tick - 1, single_tick));
+	}
+}
+
+TEST_CASE("[Modules][ECS] Test cached query.") {
+	World world;
+
+	// Only the `Entities` without `TagC` match.
+	for (uint32_t i = 0; i < 100; i += 1) {
+		if (i % 10 == 0) {
+			world.create_entity().with(TagA()).with(TagB());
+		} else {
+			world.create_entity().with(TagA()).with(TagB()).with(TagC());
+		}
+	}
+
+	CachedQuery<EntityID, TagA, Not<TagC>, const TagB> query(&world);
+
+	{
+		query.initiate_process(&world);
+		CHECK(query.is_cached());
+		uint32_t count = 0;
+		for (auto [entity, a, b] : query) {
+			CHECK(entity % 10 == 0);
+			count += 1;
+		}
+		CHECK(count == 10);
+		query.conclude_process(&world);
+	}
+
+	// The storages notify the cache, so only these `Entities` are tested.
+	world.get_storage<TagC>()->remove(5);
+	world.get_storage<TagA>()->remove(10);
+	world.destroy_entity(20);
+	const godex::component_id ids[] = { TagA::get_component_id(), TagB::get_component_id(), TagC::get_component_id() };
+	LocalVector<godex::component_id> components;
+	for (uint32_t i = 0; i < 3; i += 1) {
+		components.push_back(ids[i]);
+	}
+	// The destroyed `Entity` lost two components, but it's marked once.
+	QueryMatchCache *cache = world.get_query_cache(typeid(Query<EntityID, TagA, Not<TagC>, const TagB>).hash_code(), components);
+	CHECK(cache->get_dirty_count() == 3);
+
+	{
+		query.initiate_process(&world);
+		LocalVector<EntityID> fetched;
+		for (auto [entity, a, b] : query) {
+			fetched.push_back(entity);
+		}
+		CHECK(fetched.size() == 9);
+		CHECK(fetched.find(5) != -1);
+		CHECK(fetched.find(10) == -1);
+		CHECK(fetched.find(20) == -1);
+		CHECK(query.count() == 9);
+		query.conclude_process(&world);
+	}
+
+	// Clearing a storage invalidates the cache, that is rebuilt.
+	world.get_storage<TagC>()->clear();
+	{
+		query.initiate_process(&world);
+		CHECK(query.count() == 98);
+		query.conclude_process(&world);
+	}
+
+	// The `Changed` filter depends on the change ticks, so it's never cached.
+	{
+		Query<TagA, Changed<TagB>> changed_query(&world);
+		changed_query.set_cached(true);
+		changed_query.initiate_process(&world);
+		CHECK(changed_query.is_cached() == false);
+		changed_query.conclude_process(&world);
+	}
+
+	// More dirty `Entities` than candidates invalidate the cache, rather than
+	// growing the dirty list.
+	for (uint32_t i = 0; i < 200; i += 1) {
+		world.create_entity().with(TagA()).with(TagB());
+	}
+	CHECK(cache->is_valid() == false);
+	CHECK(cache->get_dirty_count() == 0);
+	{
+		query.initiate_process(&world);
+		CHECK(query.count() == 298);
+		query.conclude_process(&world);
+	}
+}
+
+TEST_CASE("[Modules][ECS] Test static query Added and Removed filters.") {
+	World world;
+
+	for (uint32_t i = 0; i < 10; i += 1) {
+		world.create_entity().with(TagA());
+	}
+
+	Query<EntityID, Added<TagB>, const TagA> added_query(&world);
+	Query<EntityID, Removed<TagB>> removed_query(&world);
+	godex::DynamicQuery dynamic_query;
+	dynamic_query.added_component(TagB::get_component_id(), false);
+	dynamic_query.prepare_world(&world);
+
+	// The storage is created after the `Query`s, it logs anyway.
+	world.create_storage<TagB>();
+	for (uint32_t i = 0; i < 4; i += 1) {
+		world.get_storage<TagB>()->insert(i, TagB());
+	}
+	CHECK(world.get_storage<TagB>()->is_entities_log_enabled());
+
+	{
+		added_query.initiate_process(&world);
+		LocalVector<EntityID> fetched;
+		for (auto [entity, b, a] : added_query) {
+			CHECK(b != nullptr);
+			fetched.push_back(entity);
+		}
+		CHECK(fetched.size() == 4);
+		added_query.conclude_process(&world);
+
+		dynamic_query.initiate_process(&world);
+		CHECK(dynamic_query.count() == 4);
+		dynamic_query.conclude_process(&world);
+	}
+
+	// Already taken, and the `Entities` that got the component and lost it
+	// before the next run are not taken.
+	world.get_storage<TagB>()->insert(5, TagB());
+	world.get_storage<TagB>()->insert(6, TagB());
+	world.get_storage<TagB>()->remove(6);
+	world.get_storage<TagB>()->remove(1);
+	{
+		added_query.initiate_process(&world);
+		LocalVector<EntityID> fetched;
+		for (auto [entity, b, a] : added_query) {
+			fetched.push_back(entity);
+		}
+		CHECK(fetched.size() == 1);
+		CHECK(fetched.find(5) != -1);
+		added_query.conclude_process(&world);
+
+		removed_query.initiate_process(&world);
+		fetched.clear();
+		for (auto [entity, b] : removed_query) {
+			CHECK(b == nullptr);
+			fetched.push_back(entity);
+		}
+		CHECK(fetched.size() == 2);
+		CHECK(fetched.find(1) != -1);
+		CHECK(fetched.find(6) != -1);
+		removed_query.conclude_process(&world);
+	}
+
+	// Inserting a component the `Entity` already has only changes it.
+	{
+		const uint32_t tick = world.get_change_tick();
+		world.get_storage<TagB>()->insert(5, TagB());
+		CHECK(world.get_storage<TagB>()->is_changed(5, tick - 1, tick));
+
+		added_query.initiate_process(&world);
+		CHECK(added_query.count() == 0);
+		added_query.conclude_process(&world);
+
+		removed_query.initiate_process(&world);
+		CHECK(removed_query.count() == 0);
+		removed_query.conclude_process(&world);
+	}
+
+	// Clearing the storage removes all the components.
+	world.get_storage<TagB>()->clear();
+	{
+		removed_query.initiate_process(&world);
+		CHECK(removed_query.count() == 4);
+		removed_query.conclude_process(&world);
+
+		added_query.initiate_process(&world);
+		CHECK(added_query.count() == 0);
+		added_query.conclude_process(&world);
+	}
+
+	// The logs keep the entries until all the active readers took them:
+	// `dynamic_query` didn't run since the first check.
+	world.advance_change_tick();
+	world.get_storage<TagB>()->insert(7, TagB());
+	world.trim_entities_logs();
+	CHECK(world.get_storage<TagB>()->get_added_entities(0, world.get_change_tick()).count == 3);
+
+	// The inactive readers are not waited.
+	dynamic_query.set_active(false);
+	world.trim_entities_logs();
+	CHECK(world.get_storage<TagB>()->get_added_entities(0, world.get_change_tick()).count == 1);
+
+	{
+		SystemExeInfo info;
+		removed_query.get_components(info);
+		CHECK(info.mutable_components.size() == 0);
+		CHECK(info.immutable_components.find(TagB::get_component_id()) != nullptr);
+	}
+}
+
+TEST_CASE("[Modules][ECS][Benchmark] Benchmark query par_for_each scaling." * doctest::skip()) {
+	// Run it with: `--test --no-skip --test-case="*Benchmark query par_for_each*"`
+	if (QueryBenchmarkA::get_component_id() == UINT32_MAX) {
+		ECS::register_component<QueryBenchmarkA>();
+		ECS::register_component<QueryBenchmarkB>();
+		ECS::register_component<QueryBenchmarkC>();
+	}
+
+	const uint32_t entities = 1000000;
+	const uint32_t frames = 10;
+
+	World world;
+	for (uint32_t i = 0; i < entities; i += 1) {
+		world.create_entity()
+				.with(QueryBenchmarkA())
+				.with(QueryBenchmarkB())
+				.with(QueryBenchmarkC());
+	}
+
+	Query<QueryBenchmarkA, const QueryBenchmarkB, const QueryBenchmarkC> query(&world);
+
+	const int threads = WorkerThreadPool::get_singleton()->get_thread_count();
+	for (int t = 1; t <= threads; t += 1) {
+		const uint64_t start = OS::get_singleton()->get_ticks_usec();
+		for (uint32_t f = 0; f < frames; f += 1) {
+			query.initiate_process(&world);
+			query.par_for_each([](QueryResultTuple<QueryBenchmarkA, const QueryBenchmarkB, const QueryBenchmarkC> p_result) {
+				auto [a, b, c] = p_result;
+				a->value += Math::sin(b->value) * Math::cos(c->value);
+			},
+					4096, t);
+			query.conclude_process(&world);
+		}
+		const uint64_t end = OS::get_singleton()->get_ticks_usec();
+		print_line("par_for_each, " + itos(t) + " threads, " + itos(entities) + " entities, " + itos(frames) + " frames: " + itos(end - start) + "us");
+	}
+}
 } // namespace godex_tests
 
 #endif // TEST_ECS_QUERY_H
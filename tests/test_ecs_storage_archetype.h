@@ -0,0 +1,262 @@
+#ifndef TEST_ECS_STORAGE_ARCHETYPE_H
+#define TEST_ECS_STORAGE_ARCHETYPE_H
+
+#include "tests/test_macros.h"
+
+#include "../ecs.h"
+#include "../iterators/query.h"
+#include "../storage/archetype_storage.h"
+#include "../storage/dense_vector_storage.h"
+#include "../world/world.h"
+#include "core/os/os.h"
+
+struct ArchetypePositionTest {
+	COMPONENT(ArchetypePositionTest, ArchetypeStorage)
+
+	float x = 0.0;
+	float y = 0.0;
+	float z = 0.0;
+};
+
+struct ArchetypeVelocityTest {
+	COMPONENT(ArchetypeVelocityTest, ArchetypeStorage)
+
+	float x = 0.0;
+	float y = 0.0;
+	float z = 0.0;
+};
+
+struct ArchetypeTagTest {
+	COMPONENT(ArchetypeTagTest, ArchetypeStorage)
+
+	int value = 0;
+};
+
+struct DensePositionTest {
+	COMPONENT(DensePositionTest, DenseVectorStorage)
+
+	float x = 0.0;
+	float y = 0.0;
+	float z = 0.0;
+};
+
+struct DenseVelocityTest {
+	COMPONENT(DenseVelocityTest, DenseVectorStorage)
+
+	float x = 0.0;
+	float y = 0.0;
+	float z = 0.0;
+};
+
+namespace godex_archetype_storage_tests {
+
+TEST_CASE("[Modules][ECS] Test ArchetypeStorage insert, get and remove.") {
+	ECS::register_component<ArchetypePositionTest>();
+	ECS::register_component<ArchetypeVelocityTest>();
+	ECS::register_component<ArchetypeTagTest>();
+
+	CHECK(godex_is_archetype_component<ArchetypePositionTest>::value);
+	CHECK(godex_is_archetype_component<const ArchetypePositionTest>::value);
+	CHECK(godex_is_archetype_component<DensePositionTest>::value == false);
+	CHECK(godex_is_archetype_component<EntityID>::value == false);
+
+	World world;
+
+	for (uint32_t i = 0; i < 2000; i += 1) {
+		ArchetypePositionTest position;
+		position.x = i;
+		const EntityBuilder &builder = world.create_entity();
+		builder.with(position);
+		if (i % 2 == 0) {
+			ArchetypeVelocityTest velocity;
+			velocity.x = i * 2;
+			builder.with(velocity);
+		}
+		if (i % 3 == 0) {
+			ArchetypeTagTest tag;
+			tag.value = i * 3;
+			builder.with(tag);
+		}
+	}
+
+	Storage<ArchetypePositionTest> *positions = world.get_storage<ArchetypePositionTest>();
+	Storage<ArchetypeVelocityTest> *velocities = world.get_storage<ArchetypeVelocityTest>();
+	Storage<ArchetypeTagTest> *tags = world.get_storage<ArchetypeTagTest>();
+
+	// {Position}, {Position, Velocity}, {Position, Tag}, {Position, Velocity, Tag}
+	// and the intermediate archetypes.
+	CHECK(world.get_archetype_table()->get_archetype_count() >= 4);
+
+	for (uint32_t i = 0; i < 2000; i += 1) {
+		CHECK(positions->has(i));
+		CHECK(positions->get(i)->x == i);
+		CHECK(velocities->has(i) == (i % 2 == 0));
+		CHECK(tags->has(i) == (i % 3 == 0));
+		if (i % 2 == 0) {
+			CHECK(velocities->get(i)->x == i * 2);
+		}
+		if (i % 3 == 0) {
+			CHECK(tags->get(i)->value == int(i * 3));
+		}
+	}
+
+	// Removing a component moves the `Entity` to another archetype, make sure
+	// the data is preserved.
+	for (uint32_t i = 0; i < 2000; i += 4) {
+		velocities->remove(i);
+	}
+
+	for (uint32_t i = 0; i < 2000; i += 1) {
+		CHECK(positions->get(i)->x == i);
+		CHECK(velocities->has(i) == (i % 2 == 0 && i % 4 != 0));
+		if (velocities->has(i)) {
+			CHECK(velocities->get(i)->x == i * 2);
+		}
+		if (i % 3 == 0) {
+			CHECK(tags->get(i)->value == int(i * 3));
+		}
+	}
+
+	// Insert an already existing component just updates the data.
+	{
+		ArchetypePositionTest position;
+		position.x = 99999;
+		positions->insert(1, position);
+		CHECK(positions->get(1)->x == 99999);
+	}
+
+	world.destroy_entity(5);
+	CHECK(positions->has(5) == false);
+	CHECK(velocities->has(5) == false);
+	CHECK(positions->get(7)->x == 7);
+}
+
+TEST_CASE("[Modules][ECS] Test Query iterates the ArchetypeStorage chunks.") {
+	World world;
+
+	for (uint32_t i = 0; i < 5000; i += 1) {
+		ArchetypePositionTest position;
+		position.x = i;
+		const EntityBuilder &builder = world.create_entity();
+		builder.with(position);
+		if (i % 2 == 0) {
+			ArchetypeVelocityTest velocity;
+			velocity.x = 1.0;
+			builder.with(velocity);
+		}
+		if (i % 5 == 0) {
+			builder.with(ArchetypeTagTest());
+		}
+	}
+
+	// This query can be iterated linearly.
+	CHECK(Query<ArchetypePositionTest, const ArchetypeVelocityTest>::ARCHETYPE_MODE);
+	CHECK(Query<EntityID, const ArchetypePositionTest>::ARCHETYPE_MODE);
+	// These queries use the standard path.
+	CHECK(Query<ArchetypePositionTest, DenseVelocityTest>::ARCHETYPE_MODE == false);
+	CHECK(Query<ArchetypePositionTest, Not<ArchetypeTagTest>>::ARCHETYPE_MODE == false);
+	CHECK(Query<EntityID>::ARCHETYPE_MODE == false);
+
+	{
+		Query<EntityID, ArchetypePositionTest, const ArchetypeVelocityTest> query(&world);
+		query.initiate_process(&world);
+
+		uint32_t count = 0;
+		for (auto [entity, position, velocity] : query) {
+			CHECK(entity % 2 == 0);
+			CHECK(position->x == entity);
+			position->x += velocity->x;
+			count += 1;
+		}
+		CHECK(count == 2500);
+		CHECK(query.count() == 2500);
+
+		// The random access still works.
+		CHECK(query.has(2));
+		CHECK(query.has(3) == false);
+		auto [entity, position, velocity] = query[2];
+		CHECK(entity == EntityID(2));
+		CHECK(position->x == 3.0);
+
+		query.conclude_process(&world);
+	}
+
+	{
+		Query<EntityID, const ArchetypePositionTest> query(&world);
+		query.initiate_process(&world);
+
+		uint32_t count = 0;
+		for (auto [entity, position] : query) {
+			if (entity % 2 == 0) {
+				CHECK(position->x == entity + 1);
+			} else {
+				CHECK(position->x == entity);
+			}
+			count += 1;
+		}
+		CHECK(count == 5000);
+
+		query.conclude_process(&world);
+	}
+
+	// Mixing storages falls back to the standard iteration.
+	{
+		Query<EntityID, const ArchetypePositionTest, Not<ArchetypeTagTest>> query(&world);
+		query.initiate_process(&world);
+		CHECK(query.count() == 4000);
+		query.conclude_process(&world);
+	}
+}
+
+TEST_CASE("[Modules][ECS][Benchmark] Benchmark ArchetypeStorage vs DenseVectorStorage query." * doctest::skip()) {
+	// Run it with: `--test --no-skip --test-case="*Benchmark ArchetypeStorage*"`
+	if (ArchetypePositionTest::get_component_id() == UINT32_MAX) {
+		ECS::register_component<ArchetypePositionTest>();
+		ECS::register_component<ArchetypeVelocityTest>();
+	}
+	ECS::register_component<DensePositionTest>();
+	ECS::register_component<DenseVelocityTest>();
+
+	const uint32_t entities = 100000;
+	const uint32_t frames = 100;
+
+	World world;
+	for (uint32_t i = 0; i < entities; i += 1) {
+		world.create_entity()
+				.with(ArchetypePositionTest())
+				.with(ArchetypeVelocityTest())
+				.with(DensePositionTest())
+				.with(DenseVelocityTest());
+	}
+
+	{
+		Query<ArchetypePositionTest, const ArchetypeVelocityTest> query(&world);
+		const uint64_t start = OS::get_singleton()->get_ticks_usec();
+		for (uint32_t f = 0; f < frames; f += 1) {
+			query.initiate_process(&world);
+			for (auto [position, velocity] : query) {
+				position->x += velocity->x;
+			}
+			query.conclude_process(&world);
+		}
+		const uint64_t end = OS::get_singleton()->get_ticks_usec();
+		print_line("ArchetypeStorage, " + itos(frames) + " frames: " + itos(end - start) + "us");
+	}
+
+	{
+		Query<DensePositionTest, const DenseVelocityTest> query(&world);
+		const uint64_t start = OS::get_singleton()->get_ticks_usec();
+		for (uint32_t f = 0; f < frames; f += 1) {
+			query.initiate_process(&world);
+			for (auto [position, velocity] : query) {
+				position->x += velocity->x;
+			}
+			query.conclude_process(&world);
+		}
+		const uint64_t end = OS::get_singleton()->get_ticks_usec();
+		print_line("DenseVectorStorage, " + itos(frames) + " frames: " + itos(end - start) + "us");
+	}
+}
+} // namespace godex_archetype_storage_tests
+
+#endif // TEST_ECS_STORAGE_ARCHETYPE_H
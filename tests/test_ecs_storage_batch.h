@@ -0,0 +1,66 @@
+#ifndef TEST_ECS_STORAGE_BATCH_H
+#define TEST_ECS_STORAGE_BATCH_H
+
+#include "tests/test_macros.h"
+
+#include "../storage/batch_storage.h"
+#include "../storage/dense_vector.h"
+
+namespace godex_storage_batch_tests {
+
+struct BatchTest {
+	int value = 0;
+
+	BatchTest(int p_value) :
+			value(p_value) {}
+};
+
+TEST_CASE("[Modules][ECS] Test dynamic batch storage.") {
+	BatchStorage<DenseVector, -1, BatchTest> storage;
+
+	// Interleave the batches, so they are moved within the arena.
+	for (uint32_t i = 0; i < 50; i += 1) {
+		for (uint32_t e = 0; e < 10; e += 1) {
+			storage.insert(e, BatchTest(e * 1000 + i));
+		}
+	}
+
+	// Remove an `Entity`, the others are not affected.
+	storage.remove(3);
+	CHECK(storage.has(3) == false);
+	CHECK(storage.get_stored_entities().count == 9);
+
+	for (uint32_t e = 0; e < 10; e += 1) {
+		if (e == 3) {
+			continue;
+		}
+		CHECK(storage.has(e));
+		CHECK(storage.get_batch_size(e) == 50);
+		const BatchTest *batch = storage.get(e);
+		for (uint32_t i = 0; i < 50; i += 1) {
+			CHECK(batch[i].value == int(e * 1000 + i));
+		}
+	}
+
+	// The memory is kept after the clear, so filling it again doesn't
+	// allocate.
+	storage.clear();
+	CHECK(storage.get_stored_entities().count == 0);
+	const uint32_t capacity = storage.get_arena_capacity();
+	CHECK(capacity > 0);
+
+	for (uint32_t frame = 0; frame < 10; frame += 1) {
+		for (uint32_t i = 0; i < 50; i += 1) {
+			for (uint32_t e = 0; e < 10; e += 1) {
+				storage.insert(e, BatchTest(i));
+			}
+		}
+		CHECK(storage.get_batch_size(9) == 50);
+		CHECK(storage.get(9)[49].value == 49);
+		storage.clear();
+	}
+	CHECK(storage.get_arena_capacity() == capacity);
+}
+} // namespace godex_storage_batch_tests
+
+#endif // TEST_ECS_STORAGE_BATCH_H
@@ -112,6 +112,176 @@ TEST_CASE("[Modules][ECS] Test dense storage insert and remove.") {
 		}
 	}
 }
+
+TEST_CASE("[Modules][ECS] Test dense storage batch insert and remove.") {
+	DenseVectorStorage<TestInt> storage;
+
+	EntityID entities[100];
+	LocalVector<TestInt> data;
+	for (uint32_t i = 0; i < 100; i += 1) {
+		entities[i] = i;
+		data.push_back(TestInt(i * 2));
+	}
+
+	storage.insert_batch(entities, data.ptr(), 100);
+	CHECK(storage.get_stored_entities().count == 100);
+	for (uint32_t i = 0; i < 100; i += 1) {
+		CHECK(storage.get(i)->number == int(i * 2));
+	}
+
+	// The already stored `Entities` are updated.
+	storage.insert_batch(entities + 50, TestInt(7), 50);
+	CHECK(storage.get_stored_entities().count == 100);
+	CHECK(storage.get(49)->number == 98);
+	CHECK(storage.get(50)->number == 7);
+	CHECK(storage.get(99)->number == 7);
+
+	storage.remove_batch(entities, 50);
+	CHECK(storage.get_stored_entities().count == 50);
+	CHECK(storage.has(0) == false);
+	CHECK(storage.has(49) == false);
+	CHECK(storage.get(50)->number == 7);
+}
+
+bool test_int_descending(const TestInt &p_a, const TestInt &p_b) {
+	return p_a.number > p_b.number;
+}
+
+TEST_CASE("[Modules][ECS] Test dense storage incremental compaction.") {
+	DenseVectorStorage<TestInt> storage;
+
+	// Shuffle the storage, by inserting and removing.
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		storage.insert((i * 7919) % 1000, int((i * 7919) % 1000));
+	}
+	for (uint32_t i = 0; i < 1000; i += 3) {
+		storage.remove(i);
+	}
+
+	// Run the pass in slices.
+	uint32_t slices = 0;
+	bool compact = false;
+	while (compact == false) {
+		uint32_t budget = 100;
+		compact = storage.compact(budget);
+		slices += 1;
+
+		// In between the slices the storage is still valid.
+		for (uint32_t i = 0; i < 1000; i += 1) {
+			CHECK(storage.has(i) == (i % 3 != 0));
+			if (storage.has(i)) {
+				CHECK(storage.get(i)->number == int(i));
+			}
+		}
+		// Inserting doesn't restart the pass.
+		if (slices == 3) {
+			storage.insert(3000, 3000);
+		}
+	}
+	CHECK(slices > 1);
+
+	// The `Entities` are sorted.
+	EntitiesBuffer entities = storage.get_stored_entities();
+	CHECK(entities.count == 667);
+	for (uint32_t i = 1; i < entities.count; i += 1) {
+		CHECK(uint32_t(entities.entities[i - 1]) < uint32_t(entities.entities[i]));
+	}
+
+	// Already compact: nothing to do.
+	uint32_t budget = 100;
+	CHECK(storage.compact(budget));
+	CHECK(budget == 100);
+
+	// Sort by a custom key.
+	storage.set_sort_key(test_int_descending);
+	budget = UINT32_MAX;
+	CHECK(storage.compact(budget));
+	entities = storage.get_stored_entities();
+	for (uint32_t i = 1; i < entities.count; i += 1) {
+		CHECK(storage.get(entities.entities[i - 1])->number > storage.get(entities.entities[i])->number);
+	}
+
+	// The over-reserved memory is released.
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		if (storage.has(i)) {
+			storage.remove(i);
+		}
+	}
+	const uint64_t reserved = storage.get_memory_stats().bytes_reserved;
+	budget = UINT32_MAX;
+	CHECK(storage.compact(budget));
+	CHECK(storage.get_memory_stats().bytes_reserved < reserved);
+	CHECK(storage.get(3000)->number == 3000);
+}
+TEST_CASE("[Modules][ECS] Test dense storage compaction with removes between the slices.") {
+	DenseVectorStorage<TestInt> storage;
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		storage.insert((i * 7919) % 1000, int((i * 7919) % 1000));
+	}
+
+	// Remove some `Entities` after each slice: the pass keeps going.
+	uint32_t slices = 0;
+	uint32_t removed = 0;
+	bool compact = false;
+	while (compact == false) {
+		uint32_t budget = 200;
+		compact = storage.compact(budget);
+		slices += 1;
+		CHECK(slices < 1000);
+		if (compact == false && removed < 1000) {
+			storage.remove(removed);
+			storage.remove(999 - removed);
+			removed += 97;
+		}
+	}
+
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		if (storage.has(i)) {
+			CHECK(storage.get(i)->number == int(i));
+		}
+	}
+
+	// The `Entities` are sorted.
+	const EntitiesBuffer entities = storage.get_stored_entities();
+	CHECK(entities.count < 1000);
+	for (uint32_t i = 1; i < entities.count; i += 1) {
+		CHECK(uint32_t(entities.entities[i - 1]) < uint32_t(entities.entities[i]));
+	}
+}
+
+TEST_CASE("[Modules][ECS] Test dense storage compaction with out of order inserts between the slices.") {
+	DenseVectorStorage<TestInt> storage;
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		storage.insert((i * 7919) % 1000, int((i * 7919) % 1000));
+	}
+
+	// Insert an out of order `Entity` after each slice: the pass still ends,
+	// so the `World` can move to the next storage.
+	uint32_t slices = 0;
+	bool compact = false;
+	while (compact == false) {
+		uint32_t budget = 100;
+		compact = storage.compact(budget);
+		slices += 1;
+		CHECK(slices < 1000);
+		if (compact == false) {
+			storage.insert(10000 - slices, int(10000 - slices));
+		}
+	}
+	CHECK(slices < 1000);
+
+	// The next pass sorts the `Entities` inserted meanwhile.
+	uint32_t budget = UINT32_MAX;
+	CHECK(storage.compact(budget));
+	const EntitiesBuffer entities = storage.get_stored_entities();
+	CHECK(entities.count == 1000 + slices - 1);
+	for (uint32_t i = 1; i < entities.count; i += 1) {
+		CHECK(uint32_t(entities.entities[i - 1]) < uint32_t(entities.entities[i]));
+	}
+	for (uint32_t i = 0; i < entities.count; i += 1) {
+		CHECK(storage.get(entities.entities[i])->number == int(entities.entities[i]));
+	}
+}
 } // namespace godex_storage_dense_vector_tests
 
 #endif
@@ -0,0 +1,225 @@
+#ifndef TEST_ECS_STORAGE_GROUP_H
+#define TEST_ECS_STORAGE_GROUP_H
+
+#include "tests/test_macros.h"
+
+#include "../ecs.h"
+#include "../iterators/query.h"
+#include "../storage/dense_group.h"
+#include "../storage/dense_vector_storage.h"
+#include "../storage/steady_storage.h"
+#include "../world/world.h"
+
+namespace godex_storage_group_tests {
+
+struct GroupPositionTest {
+	COMPONENT_CUSTOM_CONSTRUCTOR(GroupPositionTest, DenseVectorStorage)
+
+	int value = 0;
+
+	GroupPositionTest() = default;
+	GroupPositionTest(int p_value) :
+			value(p_value) {}
+};
+
+struct GroupVelocityTest {
+	COMPONENT_CUSTOM_CONSTRUCTOR(GroupVelocityTest, DenseVectorStorage)
+
+	int value = 0;
+
+	GroupVelocityTest() = default;
+	GroupVelocityTest(int p_value) :
+			value(p_value) {}
+};
+
+struct GroupSteadyTest {
+	COMPONENT(GroupSteadyTest, SteadyStorage)
+
+	int value = 0;
+};
+
+/// Checks that the packed range contains exactly the `Entities` having both
+/// the components, in the same order on both the storages.
+void check_group_packed(World &p_world) {
+	const godex::component_id ids[] = { GroupPositionTest::get_component_id(), GroupVelocityTest::get_component_id() };
+	const DenseGroup *group = p_world.get_group(ids, 2);
+	REQUIRE(group != nullptr);
+
+	Storage<GroupPositionTest> *positions = p_world.get_storage<GroupPositionTest>();
+	Storage<GroupVelocityTest> *velocities = p_world.get_storage<GroupVelocityTest>();
+
+	const EntitiesBuffer position_entities = positions->get_stored_entities();
+	const EntitiesBuffer velocity_entities = velocities->get_stored_entities();
+
+	uint32_t expected = 0;
+	for (uint32_t i = 0; i < position_entities.count; i += 1) {
+		if (velocities->has(position_entities.entities[i])) {
+			expected += 1;
+		}
+	}
+	CHECK(group->get_size() == expected);
+
+	const GroupPositionTest *position_data = static_cast<const GroupPositionTest *>(group->get_data(GroupPositionTest::get_component_id()));
+	const GroupVelocityTest *velocity_data = static_cast<const GroupVelocityTest *>(group->get_data(GroupVelocityTest::get_component_id()));
+	for (uint32_t i = 0; i < group->get_size(); i += 1) {
+		CHECK(position_entities.entities[i] == velocity_entities.entities[i]);
+		CHECK(positions->has(position_entities.entities[i]));
+		CHECK(velocities->has(position_entities.entities[i]));
+		// The data follows the `Entities`.
+		CHECK(position_data[i].value == int(position_entities.entities[i]));
+		CHECK(velocity_data[i].value == int(position_entities.entities[i]) * 2);
+	}
+}
+
+TEST_CASE("[Modules][ECS] Test DenseGroup keeps the storages co-sorted.") {
+	ECS::register_component<GroupPositionTest>();
+	ECS::register_component<GroupVelocityTest>();
+	ECS::register_component<GroupSteadyTest>();
+
+	CHECK(godex_is_group_component<GroupPositionTest>::value);
+	CHECK(godex_is_group_component<const GroupPositionTest>::value);
+	CHECK(godex_is_group_component<GroupSteadyTest>::value == false);
+	CHECK(godex_is_group_component<EntityID>::value == false);
+
+	World world;
+
+	// Some `Entities` exist before the group is created.
+	for (uint32_t i = 0; i < 100; i += 1) {
+		const EntityBuilder &builder = world.create_entity();
+		builder.with(GroupPositionTest(int(i)));
+		if (i % 3 == 0) {
+			builder.with(GroupVelocityTest(int(i) * 2));
+		}
+	}
+
+	world.create_group<GroupPositionTest, GroupVelocityTest>();
+	check_group_packed(world);
+
+	// Insert after the group is created.
+	for (uint32_t i = 100; i < 200; i += 1) {
+		const EntityBuilder &builder = world.create_entity();
+		if (i % 2 == 0) {
+			builder.with(GroupVelocityTest(int(i) * 2));
+		}
+		builder.with(GroupPositionTest(int(i)));
+	}
+	check_group_packed(world);
+
+	// Remove from both the storages.
+	for (uint32_t i = 0; i < 200; i += 5) {
+		if (world.get_storage<GroupVelocityTest>()->has(i)) {
+			world.remove_component<GroupVelocityTest>(i);
+		}
+	}
+	check_group_packed(world);
+	for (uint32_t i = 1; i < 200; i += 7) {
+		world.remove_component<GroupPositionTest>(i);
+	}
+	check_group_packed(world);
+
+	// Batch insert and destroy.
+	const EntitiesBuilder &entities = world.create_entities(50);
+	for (uint32_t i = 0; i < entities.size(); i += 1) {
+		world.add_component(entities[i], GroupPositionTest(int(entities[i])));
+		world.add_component(entities[i], GroupVelocityTest(int(entities[i]) * 2));
+	}
+	check_group_packed(world);
+
+	for (uint32_t i = 0; i < 250; i += 3) {
+		world.destroy_entity(i);
+	}
+	check_group_packed(world);
+
+	// The already grouped storages can't be grouped again.
+	ERR_PRINT_OFF;
+	world.create_group<GroupPositionTest, GroupVelocityTest>();
+	world.create_group<GroupPositionTest, GroupSteadyTest>();
+	ERR_PRINT_ON;
+	check_group_packed(world);
+
+	// Clearing a storage empties the group.
+	world.get_storage<GroupVelocityTest>()->clear();
+	check_group_packed(world);
+}
+
+TEST_CASE("[Modules][ECS] Test Query iterates the DenseGroup packed range.") {
+	CHECK(Query<GroupPositionTest, const GroupVelocityTest>::GROUP_MODE);
+	CHECK(Query<EntityID, const GroupPositionTest>::GROUP_MODE);
+	// These queries use the standard path.
+	CHECK(Query<GroupPositionTest, Not<GroupVelocityTest>>::GROUP_MODE == false);
+	CHECK(Query<GroupPositionTest, GroupSteadyTest>::GROUP_MODE == false);
+	CHECK(Query<EntityID>::GROUP_MODE == false);
+
+	World world;
+	world.create_group<GroupPositionTest, GroupVelocityTest>();
+
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		const EntityBuilder &builder = world.create_entity();
+		builder.with(GroupPositionTest(int(i)));
+		if (i % 4 == 0) {
+			builder.with(GroupVelocityTest(1));
+		}
+	}
+
+	{
+		Query<EntityID, GroupPositionTest, const GroupVelocityTest> query(&world);
+		query.initiate_process(&world);
+		CHECK(query.is_packed());
+
+		uint32_t count = 0;
+		for (auto [entity, position, velocity] : query) {
+			CHECK(entity % 4 == 0);
+			CHECK(position->value == int(entity));
+			position->value += velocity->value;
+			count += 1;
+		}
+		CHECK(count == 250);
+		CHECK(query.count() == 250);
+
+		// The random access still works.
+		CHECK(query.has(4));
+		CHECK(query.has(5) == false);
+		auto [entity, position, velocity] = query[4];
+		CHECK(entity == EntityID(4));
+		CHECK(position->value == 5);
+
+		query.conclude_process(&world);
+	}
+
+	{
+		// Not grouped: this `Query` uses the standard path.
+		Query<EntityID, const GroupPositionTest> query(&world);
+		query.initiate_process(&world);
+		CHECK(query.is_packed() == false);
+
+		uint32_t count = 0;
+		for (auto [entity, position] : query) {
+			CHECK(position->value == int(entity) + (entity % 4 == 0 ? 1 : 0));
+			count += 1;
+		}
+		CHECK(count == 1000);
+
+		query.conclude_process(&world);
+	}
+
+	{
+		// Without group, the result is the same.
+		World other;
+		for (uint32_t i = 0; i < 1000; i += 1) {
+			const EntityBuilder &builder = other.create_entity();
+			builder.with(GroupPositionTest(int(i)));
+			if (i % 4 == 0) {
+				builder.with(GroupVelocityTest(1));
+			}
+		}
+
+		Query<EntityID, const GroupPositionTest, const GroupVelocityTest> query(&other);
+		query.initiate_process(&other);
+		CHECK(query.is_packed() == false);
+		CHECK(query.count() == 250);
+		query.conclude_process(&other);
+	}
+}
+} // namespace godex_storage_group_tests
+
+#endif // TEST_ECS_STORAGE_GROUP_H
@@ -223,9 +223,9 @@ TEST_CASE("[Modules][ECS] Test Hierarchy.") {
 TEST_CASE("[Modules][ECS] Test HierarchicalStorage.") {
 	Hierarchy hierarchy;
 
-	EntityList changed_transforms;
 	HierarchicalStorage<TransformComponent> transform_storage;
-	transform_storage.add_change_listener(&changed_transforms);
+	// This storage is not part of a `World`, so the change tick is always 1.
+	const uint32_t change_tick = transform_storage.get_change_tick();
 
 	hierarchy.add_sub_storage(&transform_storage);
 
@@ -282,13 +282,13 @@ TEST_CASE("[Modules][ECS] Test HierarchicalStorage.") {
 		CHECK(ABS(tc_entity_1->origin[0] - 4.) <= CMP_EPSILON);
 		CHECK(ABS(tc_entity_2->origin[0] - 5.) <= CMP_EPSILON);
 
-		CHECK(changed_transforms.has(0));
-		CHECK(changed_transforms.has(1));
-		CHECK(changed_transforms.has(2));
+		CHECK(transform_storage.is_changed(0, change_tick - 1, change_tick));
+		CHECK(transform_storage.is_changed(1, change_tick - 1, change_tick));
+		CHECK(transform_storage.is_changed(2, change_tick - 1, change_tick));
 	}
 
 	transform_storage.flush_changes();
-	changed_transforms.clear();
+	transform_storage.flush_changed();
 
 	// Test update global transform bia `get`.
 	{
@@ -311,13 +311,13 @@ TEST_CASE("[Modules][ECS] Test HierarchicalStorage.") {
 		CHECK(ABS(tc_entity_2->origin[0] - 7.) <= CMP_EPSILON);
 		CHECK(ABS(tc_entity_2_local->origin[0] - 3.) <= CMP_EPSILON);
 
-		CHECK(changed_transforms.has(0) == false);
-		CHECK(changed_transforms.has(1) == false);
-		CHECK(changed_transforms.has(2));
+		CHECK(transform_storage.is_changed(0, change_tick - 1, change_tick) == false);
+		CHECK(transform_storage.is_changed(1, change_tick - 1, change_tick) == false);
+		CHECK(transform_storage.is_changed(2, change_tick - 1, change_tick));
 	}
 
 	transform_storage.flush_changes();
-	changed_transforms.clear();
+	transform_storage.flush_changed();
 
 	// Test change hierarchy
 	{
@@ -338,9 +338,9 @@ TEST_CASE("[Modules][ECS] Test HierarchicalStorage.") {
 		CHECK(ABS(tc_entity_2->origin[0] - 6.) <= CMP_EPSILON); // Child of `Entity0`.
 		CHECK(ABS(tc_entity_1->origin[0] - 1.) <= CMP_EPSILON); // Root
 
-		CHECK(changed_transforms.has(0) == false);
-		CHECK(changed_transforms.has(1));
-		CHECK(changed_transforms.has(2));
+		CHECK(transform_storage.is_changed(0, change_tick - 1, change_tick) == false);
+		CHECK(transform_storage.is_changed(1, change_tick - 1, change_tick));
+		CHECK(transform_storage.is_changed(2, change_tick - 1, change_tick));
 	}
 
 	// Check `get_stored_entities` fetch.
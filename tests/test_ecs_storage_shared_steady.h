@@ -3,6 +3,7 @@
 
 #include "../components/component.h"
 #include "../ecs.h"
+#include "../modules/godot/nodes/shared_component_resource.h"
 #include "../storage/shared_steady_storage.h"
 #include "core/math/math_funcs.h"
 
@@ -114,6 +115,79 @@ TEST_CASE("[SharedSteadyStorage] Check memory share.") {
 	}
 }
 
+TEST_CASE("[SharedSteadyStorage] Check reference count and deduplication.") {
+	SharedSteadyStorage<SharedSteadyComponentTest> storage;
+	Dictionary config;
+	config["page_size"] = 5;
+	storage.configure(config);
+
+	// Same data, same shared component.
+	const godex::SID sid_1 = storage.create_or_get_shared_component(SharedSteadyComponentTest(10));
+	const godex::SID sid_2 = storage.create_or_get_shared_component(SharedSteadyComponentTest(20));
+	CHECK(sid_1 != sid_2);
+	CHECK(storage.create_or_get_shared_component(SharedSteadyComponentTest(10)) == sid_1);
+	CHECK(storage.create_or_get_shared_component(SharedSteadyComponentTest(20)) == sid_2);
+	// The normal create always creates a new one.
+	const godex::SID sid_3 = storage.create_shared_component(SharedSteadyComponentTest(10));
+	CHECK(sid_3 != sid_1);
+
+	for (uint32_t i = 0; i < 100; i += 1) {
+		storage.insert(i, i % 2 == 0 ? sid_1 : sid_2);
+	}
+	CHECK(storage.get_reference_count(sid_1) == 50);
+	CHECK(storage.get_reference_count(sid_2) == 50);
+	CHECK(storage.get_reference_count(sid_3) == 0);
+
+	{
+		const SharedStorageStats stats = storage.get_shared_stats();
+		CHECK(stats.shared_count == 3);
+		CHECK(stats.reference_count == 100);
+		CHECK(stats.deduplicated_count == 2);
+		CHECK(stats.released_count == 0);
+		// 100 `Entities` use 2 components.
+		CHECK(stats.memory_saved == 98 * sizeof(SharedSteadyComponentTest));
+	}
+
+	// Moving an `Entity` to another shared component updates both the counters.
+	storage.insert(0, sid_2);
+	CHECK(storage.get_reference_count(sid_1) == 49);
+	CHECK(storage.get_reference_count(sid_2) == 51);
+	storage.insert(0, sid_2);
+	CHECK(storage.get_reference_count(sid_2) == 51);
+
+	// Remove all the `Entities` using `sid_1`: it's released.
+	for (uint32_t i = 2; i < 100; i += 2) {
+		storage.remove(i);
+	}
+	CHECK(storage.has_shared_component(sid_1) == false);
+	CHECK(storage.has_shared_component(sid_2));
+	CHECK(storage.get_shared_stats().released_count == 1);
+
+	// The released component is not deduplicated anymore.
+	const godex::SID sid_4 = storage.create_or_get_shared_component(SharedSteadyComponentTest(10));
+	CHECK(sid_4 != sid_1);
+	CHECK(storage.get_shared_component(sid_4)->number == 10);
+	CHECK(storage.create_or_get_shared_component(SharedSteadyComponentTest(10)) == sid_4);
+
+	// When the data changes, the component is not deduplicated anymore.
+	storage.get_shared_component(sid_4)->number = 11;
+	CHECK(storage.create_or_get_shared_component(SharedSteadyComponentTest(10)) != sid_4);
+	CHECK(storage.create_or_get_shared_component(SharedSteadyComponentTest(11)) != sid_4);
+}
+
+TEST_CASE("[SharedSteadyStorage] Check auto release disabled.") {
+	SharedSteadyStorage<SharedSteadyComponentTest> storage;
+	Dictionary config;
+	config["auto_release"] = false;
+	storage.configure(config);
+
+	const godex::SID sid = storage.create_or_get_shared_component(SharedSteadyComponentTest(10));
+	storage.insert(0, sid);
+	storage.remove(0);
+	CHECK(storage.has_shared_component(sid));
+	CHECK(storage.get_reference_count(sid) == 0);
+}
+
 TEST_CASE("[SharedSteadyStorage] Check memory steadness.") {
 	SharedSteadyStorage<SharedSteadyComponentTest> storage;
 	Dictionary config;
@@ -414,4 +488,33 @@ TEST_CASE("[SharedSteadyStorage] Check World storage usage.") {
 }
 } // namespace godex_ecs_shared_steady_storage_tests
 
+namespace godex_ecs_shared_steady_storage_tests {
+TEST_CASE("[SharedSteadyStorage] Check the SharedComponentResource SID is kept.") {
+	ECS::register_component<SharedComponentTest2>();
+
+	World world;
+
+	Ref<SharedComponentResource> resource;
+	resource.instantiate();
+	resource->init(SNAME("SharedComponentTest2"));
+
+	// The resource keeps the SID of each `World`, so the shared component is
+	// not released once the last `Entity` using it is removed.
+	const godex::SID sid = resource->get_sid(&world);
+	const EntityID entity_1 = world.create_entity();
+	world.add_shared_component(entity_1, SharedComponentTest2::get_component_id(), sid);
+	world.get_storage<SharedComponentTest2>()->remove(entity_1);
+
+	SharedStorage<SharedComponentTest2> *storage = world.get_shared_storage<SharedComponentTest2>();
+	CHECK(storage->has_shared_component(sid));
+
+	// The next `Entity` built from the resource gets the component.
+	CHECK(resource->get_sid(&world) == sid);
+	const EntityID entity_2 = world.create_entity();
+	world.add_shared_component(entity_2, SharedComponentTest2::get_component_id(), resource->get_sid(&world));
+	CHECK(storage->has(entity_2));
+	CHECK(storage->get_reference_count(sid) == 1);
+}
+} // namespace godex_ecs_shared_steady_storage_tests
+
 #endif // TEST_SHARED_STEADY_STORAGE_H
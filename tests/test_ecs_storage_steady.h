@@ -120,6 +120,46 @@ TEST_CASE("[SteadyStorage] Push and remove memory check.") {
 	// until explictly removed, even if other entities are added or removed.
 	// All the pointers remain valid until explicitly removed.
 }
+TEST_CASE("[SteadyStorage] Iterate the pages in memory order.") {
+	SteadyStorage<SteadyComponentTest> storage;
+	Dictionary config;
+	config["page_size"] = 5;
+	storage.configure(config);
+
+	// The page size is rounded to the next power of two.
+	CHECK(storage.get_page_size() == 8);
+
+	const uint32_t count = 100;
+	for (uint32_t i = 0; i < count; i += 1) {
+		storage.insert(i, i);
+	}
+	CHECK(storage.get_page_count() == 13);
+
+	// Remove and insert again, so the freed slots are reused out of order.
+	for (uint32_t i = 0; i < count; i += 3) {
+		storage.remove(i);
+	}
+	for (uint32_t i = 0; i < count; i += 6) {
+		storage.insert(i, i);
+	}
+
+	// The stored `Entities` are sorted in memory order at the end of the stage.
+	storage.on_system_release();
+
+	const EntitiesBuffer buf = storage.get_stored_entities();
+	uint32_t iterated = 0;
+	storage.for_each([&](EntityID p_entity, SteadyComponentTest *p_data) {
+		CHECK(p_data->number == int(p_entity));
+		CHECK(p_data == storage.get(p_entity));
+		// Same order of the `Entities` list.
+		CHECK(buf.entities[iterated] == p_entity);
+		iterated += 1;
+	});
+	CHECK(iterated == buf.count);
+	CHECK(buf.count == count - 34 + 17);
+	// The freed slots are reused, so no new page is allocated.
+	CHECK(storage.get_page_count() == 13);
+}
 } // namespace godex_ecs_steady_storage_tests
 
 #endif // TEST_STEADY_STORAGE_H
@@ -0,0 +1,101 @@
+#ifndef TEST_ECS_STORAGE_TAG_H
+#define TEST_ECS_STORAGE_TAG_H
+
+#include "tests/test_macros.h"
+
+#include "../components/component.h"
+#include "../iterators/query.h"
+#include "../storage/dense_vector_storage.h"
+#include "../storage/tag_storage.h"
+#include "../world/world.h"
+
+namespace godex_storage_tag_tests {
+
+struct TagTest {
+	COMPONENT_TAG(TagTest)
+};
+
+struct TagValueTest {
+	COMPONENT(TagValueTest, DenseVectorStorage)
+
+	int value = 0;
+};
+
+TEST_CASE("[Modules][ECS] Test tag storage insert and remove.") {
+	TagStorage<TagTest> storage;
+
+	storage.insert(0, TagTest());
+	storage.insert(3, TagTest());
+	storage.insert(3, TagTest());
+	storage.insert(700, TagTest());
+
+	CHECK(storage.has(0));
+	CHECK(storage.has(1) == false);
+	CHECK(storage.has(3));
+	CHECK(storage.has(700));
+	CHECK(storage.has(90000000) == false);
+	CHECK(storage.get_stored_entities().count == 3);
+	CHECK(storage.get(3) != nullptr);
+
+	storage.remove(3);
+	CHECK(storage.has(3) == false);
+	CHECK(storage.has(0));
+	CHECK(storage.has(700));
+	CHECK(storage.get_stored_entities().count == 2);
+
+	storage.clear();
+	CHECK(storage.has(0) == false);
+	CHECK(storage.has(700) == false);
+	CHECK(storage.get_stored_entities().count == 0);
+
+	// Still usable after the clear.
+	storage.insert(64, TagTest());
+	CHECK(storage.has(64));
+	CHECK(storage.get_stored_entities().count == 1);
+}
+
+TEST_CASE("[Modules][ECS] Test Query with tag components.") {
+	ECS::register_component<TagTest>();
+	ECS::register_component<TagValueTest>();
+
+	World world;
+
+	for (uint32_t i = 0; i < 100; i += 1) {
+		TagValueTest value;
+		value.value = i;
+		const EntityBuilder &builder = world.create_entity();
+		builder.with(value);
+		if (i % 4 == 0) {
+			builder.with(TagTest());
+		}
+	}
+
+	{
+		Query<EntityID, const TagValueTest, Not<TagTest>> query(&world);
+		query.initiate_process(&world);
+		uint32_t count = 0;
+		for (auto [entity, value] : query) {
+			CHECK(entity % 4 != 0);
+			CHECK(value->value == int(entity));
+			count += 1;
+		}
+		CHECK(count == 75);
+		query.conclude_process(&world);
+	}
+
+	{
+		// The tag storage is the determinant list.
+		Query<EntityID, const TagTest> query(&world);
+		query.initiate_process(&world);
+		uint32_t count = 0;
+		for (auto [entity, tag] : query) {
+			CHECK(entity % 4 == 0);
+			count += 1;
+		}
+		CHECK(count == 25);
+		query.conclude_process(&world);
+	}
+}
+} // namespace godex_storage_tag_tests
+
+#endif // TEST_ECS_STORAGE_TAG_H
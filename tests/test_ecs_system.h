@@ -13,6 +13,7 @@
 #include "../storage/dense_vector_storage.h"
 #include "../systems/dynamic_system.h"
 #include "../world/world.h"
+#include "core/os/thread.h"
 #include "test_utilities.h"
 
 struct TagTestComponent {
@@ -1122,6 +1123,115 @@ TEST_CASE("[Modules][ECS] Test system changed query filter.") {
 	CHECK(entity_3_tracer->trace == 1);
 }
 
+} // namespace godex_tests_system
+
+void test_changed_since_last_run(Query<Changed<const TransformComponent>, ChangeTracer> &p_query) {
+	for (auto [t, c] : p_query) {
+		c->trace += 1;
+	}
+}
+
+void test_change_after_reader(Query<TransformComponent> &p_query) {
+	// Entity 0 is changed after `test_changed` run.
+	if (p_query.has(0)) {
+		auto [transform] = p_query[0];
+		transform->origin.x += 1.0;
+	}
+}
+
+namespace godex_tests_system {
+TEST_CASE("[Modules][ECS] Test system changed query takes the changes since its last run.") {
+	godex::system_id reader_id = ECS::register_system(test_changed_since_last_run, "test_changed_since_last_run").get_id();
+	godex::system_id writer_id = ECS::register_system(test_change_after_reader, "test_change_after_reader").get_id();
+
+	World world;
+
+	PipelineBuilder pipeline_builder;
+	pipeline_builder.add_system(reader_id);
+	pipeline_builder.add_system(writer_id);
+
+	Pipeline pipeline;
+	pipeline_builder.build(pipeline);
+	Token token = pipeline.prepare_world(&world);
+	pipeline.set_active(token, true);
+
+	EntityID entity_1 = world
+								.create_entity()
+								.with(ChangeTracer())
+								.with(TransformComponent());
+
+	EntityID entity_2 = world
+								.create_entity()
+								.with(ChangeTracer())
+								.with(TransformComponent());
+
+	for (uint32_t i = 0; i < 3; i += 1) {
+		pipeline.dispatch(token);
+	}
+
+	const Storage<const ChangeTracer> *storage = world.get_storage<const ChangeTracer>();
+
+	// Changed each frame by the system that runs after the reader: the change
+	// is taken the next frame.
+	CHECK(storage->get(entity_1)->trace == 3);
+	// Only the initial insert.
+	CHECK(storage->get(entity_2)->trace == 1);
+}
+} // namespace godex_tests_system
+
+void test_changed_writes_filtered(Query<Changed<TransformComponent>, ChangeTracer> &p_query) {
+	for (auto [t, c] : p_query) {
+		t->origin.x += 1.0;
+		c->trace += 1;
+	}
+}
+
+namespace godex_tests_system {
+TEST_CASE("[Modules][ECS] Test system changed query skips its own changes.") {
+	godex::system_id system_id = ECS::register_system(test_changed_writes_filtered, "test_changed_writes_filtered").get_id();
+
+	World world;
+
+	PipelineBuilder pipeline_builder;
+	pipeline_builder.add_system(system_id);
+
+	Pipeline pipeline;
+	pipeline_builder.build(pipeline);
+	Token token = pipeline.prepare_world(&world);
+	pipeline.set_active(token, true);
+
+	EntityID entity_1 = world
+								.create_entity()
+								.with(ChangeTracer())
+								.with(TransformComponent());
+
+	EntityID entity_2 = world
+								.create_entity()
+								.with(ChangeTracer())
+								.with(TransformComponent());
+
+	// The system writes the component it filters: the change is not taken
+	// back the next frames.
+	for (uint32_t i = 0; i < 3; i += 1) {
+		pipeline.dispatch(token);
+	}
+
+	const Storage<const ChangeTracer> *storage = world.get_storage<const ChangeTracer>();
+	CHECK(storage->get(entity_1)->trace == 1);
+	CHECK(storage->get(entity_2)->trace == 1);
+
+	// The changes done outside the system are taken.
+	world.get_storage<TransformComponent>()->get(entity_2)->origin.x += 10.0;
+	pipeline.dispatch(token);
+	pipeline.dispatch(token);
+
+	CHECK(storage->get(entity_1)->trace == 1);
+	CHECK(storage->get(entity_2)->trace == 2);
+	const Storage<const TransformComponent> *transforms = world.get_storage<const TransformComponent>();
+	CHECK(ABS(transforms->get(entity_1)->origin.x - 1.0) <= CMP_EPSILON);
+	CHECK(ABS(transforms->get(entity_2)->origin.x - 12.0) <= CMP_EPSILON);
+}
+
 TEST_CASE("[Modules][ECS] Test fetch entity from nodepath, using a dynamic system.") {
 	initialize_script_ecs();
 	{
@@ -1434,6 +1544,225 @@ TEST_CASE("[Modules][ECS] Test EventEmitter and EventReceiver") {
 	}
 	finalize_script_ecs();
 }
+
+TEST_CASE("[Modules][ECS] Test EventStorage emitter IDs.") {
+	EventStorage<MyEvent1Test> storage;
+
+	const godex::EmitterId emitter_a = storage.add_event_emitter("EmitterA");
+	const godex::EmitterId emitter_b = storage.add_event_emitter("EmitterB");
+	CHECK(emitter_a != emitter_b);
+	CHECK(storage.get_emitter_id("EmitterA") == emitter_a);
+	CHECK(storage.get_emitter_id("EmitterB") == emitter_b);
+	CHECK(storage.get_emitter_id("EmitterC") == godex::EMITTER_NONE);
+	CHECK(storage.has_emitter("EmitterC") == false);
+
+	// Emit using the ID and the name.
+	MyEvent1Test e;
+	for (int i = 0; i < 10; i += 1) {
+		e.a = i;
+		storage.add_event(emitter_a, e);
+	}
+	e.a = 100;
+	storage.add_event("EmitterB", e);
+	storage.swap_events();
+
+	REQUIRE(storage.get_events(emitter_a) != nullptr);
+	CHECK(storage.get_events(emitter_a)->size() == 10);
+	CHECK((*storage.get_events(emitter_a))[9].a == 9);
+	CHECK(storage.get_events("EmitterA") == storage.get_events(emitter_a));
+	CHECK(storage.get_events(emitter_b)->size() == 1);
+	CHECK(storage.get_events(godex::EMITTER_NONE) == nullptr);
+
+	// Adding it again returns the same ID.
+	ERR_PRINT_OFF;
+	CHECK(storage.add_event_emitter("EmitterA") == emitter_a);
+	storage.add_event(godex::EMITTER_NONE, e);
+	ERR_PRINT_ON;
+
+	// The IDs remain valid after the flush.
+	storage.flush_events();
+	CHECK(storage.get_events(emitter_a)->size() == 0);
+	CHECK(storage.get_events(emitter_b)->size() == 0);
+	storage.add_event(emitter_b, e);
+	storage.swap_events();
+	CHECK(storage.get_events(emitter_b)->size() == 1);
+}
+
+TEST_CASE("[Modules][ECS] Test EventStorage double buffer and receivers.") {
+	EventStorage<MyEvent1Test> storage;
+	const godex::EmitterId emitter = storage.add_event_emitter("Emitter");
+
+	// Without receivers, the events last until the next swap.
+	MyEvent1Test e;
+	e.a = 1;
+	storage.add_event(emitter, e);
+	// The pending events are not readable.
+	CHECK(storage.get_events(emitter)->size() == 0);
+	storage.swap_events();
+	CHECK(storage.get_events(emitter)->size() == 1);
+	storage.swap_events();
+	CHECK(storage.get_events(emitter)->size() == 0);
+
+	// The fast receiver reads at each swap, the slow one each 3 swaps.
+	const uint32_t fast = storage.add_event_receiver(emitter);
+	const uint32_t slow = storage.add_event_receiver(emitter);
+	CHECK(fast != slow);
+
+	int fast_sum = 0;
+	int slow_sum = 0;
+	int emitted_sum = 0;
+	for (int i = 0; i < 9; i += 1) {
+		e.a = i;
+		storage.add_event(emitter, e);
+		emitted_sum += i;
+		storage.swap_events();
+
+		const LocalVector<MyEvent1Test> *events = storage.get_events(emitter);
+		for (uint32_t x = storage.receive_events(emitter, fast); x < events->size(); x += 1) {
+			fast_sum += (*events)[x].a;
+		}
+
+		if (i % 3 == 2) {
+			// The events not yet read by the slow receiver are still there.
+			CHECK(events->size() == 3);
+			for (uint32_t x = storage.receive_events(emitter, slow); x < events->size(); x += 1) {
+				slow_sum += (*events)[x].a;
+			}
+		}
+	}
+	// Each receiver read each event exactly once.
+	CHECK(fast_sum == emitted_sum);
+	CHECK(slow_sum == emitted_sum);
+
+	// Once the slow receiver is removed, the events read by the fast one are
+	// dropped.
+	storage.remove_event_receiver(emitter, slow);
+	e.a = 100;
+	storage.add_event(emitter, e);
+	storage.swap_events();
+	const uint32_t from = storage.receive_events(emitter, fast);
+	CHECK(storage.get_events(emitter)->size() - from == 1);
+	storage.swap_events();
+	CHECK(storage.get_events(emitter)->size() == 0);
+
+	// A new receiver reads only the new events, and reuses the free slot.
+	CHECK(storage.add_event_receiver(emitter) == slow);
+}
+
+TEST_CASE("[Modules][ECS] Test EventStorage inactive and idle receivers.") {
+	EventStorage<MyEvent1Test> storage;
+	const godex::EmitterId emitter = storage.add_event_emitter("Emitter");
+
+	const uint32_t reader = storage.add_event_receiver(emitter);
+	const uint32_t inactive = storage.add_event_receiver(emitter);
+	const uint32_t idle = storage.add_event_receiver(emitter);
+	storage.set_event_receiver_active(emitter, inactive, false);
+
+	MyEvent1Test e;
+	for (uint32_t i = 0; i < EventStorageBase::MAX_IDLE_SWAPS; i += 1) {
+		e.a = i;
+		storage.add_event(emitter, e);
+		storage.swap_events();
+		storage.receive_events(emitter, reader);
+	}
+
+	// The inactive receiver doesn't keep the events, the idle one still does.
+	CHECK(storage.get_events(emitter)->size() == EventStorageBase::MAX_IDLE_SWAPS);
+
+	// Once idle for too long, the events are dropped.
+	storage.add_event(emitter, e);
+	storage.swap_events();
+	storage.receive_events(emitter, reader);
+	storage.swap_events();
+	CHECK(storage.get_events(emitter)->size() == 0);
+
+	// Once active again, the receiver reads only the new events.
+	storage.set_event_receiver_active(emitter, inactive, true);
+	e.a = 100;
+	storage.add_event(emitter, e);
+	storage.swap_events();
+	const LocalVector<MyEvent1Test> *events = storage.get_events(emitter);
+	uint32_t from = storage.receive_events(emitter, inactive);
+	REQUIRE(events->size() - from == 1);
+	CHECK((*events)[from].a == 100);
+
+	// The idle receiver lost the old events, but reads the kept ones.
+	from = storage.receive_events(emitter, idle);
+	REQUIRE(events->size() - from == 1);
+	CHECK((*events)[from].a == 100);
+}
+
+TEST_CASE("[Modules][ECS] Test EventStorage columns export.") {
+	EventStorage<MyEvent1Test> storage;
+	const godex::EmitterId emitter = storage.add_event_emitter("Emitter");
+
+	MyEvent1Test e;
+	for (int i = 0; i < 100; i += 1) {
+		e.a = i;
+		storage.add_event(emitter, e);
+	}
+	storage.swap_events();
+
+	const Dictionary columns = storage.get_events_columns(emitter);
+	REQUIRE(columns.has("a"));
+	const PackedInt64Array a = columns["a"];
+	CHECK(a.size() == 100);
+	for (int i = 0; i < 100; i += 1) {
+		CHECK(a[i] == i);
+	}
+
+	// Starting from the given event.
+	const PackedInt64Array tail = storage.get_events_columns(emitter, 90)["a"];
+	CHECK(tail.size() == 10);
+	CHECK(tail[0] == 90);
+
+	// The columns exist even when there are no events.
+	const PackedInt64Array empty = storage.get_events_columns(emitter, 100)["a"];
+	CHECK(empty.size() == 0);
+}
+
+struct EventsThreadTest {
+	EventStorage<MyEvent1Test> *storage = nullptr;
+	godex::EmitterId emitter = godex::EMITTER_NONE;
+	int value = 0;
+
+	static void emit(void *p_data) {
+		EventsThreadTest *self = static_cast<EventsThreadTest *>(p_data);
+		MyEvent1Test e;
+		e.a = self->value;
+		for (int i = 0; i < 1000; i += 1) {
+			self->storage->add_event(self->emitter, e);
+		}
+	}
+};
+
+TEST_CASE("[Modules][ECS] Test EventStorage emitted from many threads.") {
+	EventStorage<MyEvent1Test> storage;
+	const godex::EmitterId emitter = storage.add_event_emitter("Emitter");
+
+	EventsThreadTest data[4];
+	Thread threads[4];
+	for (int i = 0; i < 4; i += 1) {
+		data[i].storage = &storage;
+		data[i].emitter = emitter;
+		data[i].value = i + 1;
+		threads[i].start(EventsThreadTest::emit, data + i);
+	}
+	for (int i = 0; i < 4; i += 1) {
+		threads[i].wait_to_finish();
+	}
+
+	// Each thread emitted into its own buffer, merged by the swap.
+	storage.swap_events();
+	const LocalVector<MyEvent1Test> *events = storage.get_events(emitter);
+	CHECK(events->size() == 4000);
+
+	int sum = 0;
+	for (uint32_t i = 0; i < events->size(); i += 1) {
+		sum += (*events)[i].a;
+	}
+	CHECK(sum == (1 + 2 + 3 + 4) * 1000);
+}
 } // namespace godex_tests
 
 struct MyEvent2Test {
@@ -1441,34 +1770,45 @@ struct MyEvent2Test {
 };
 
 void test2_emit_event(EventsEmitter<MyEvent2Test> &p_emitter) {}
+void test3_emit_event(EventsEmitter<MyEvent1Test> &p_emitter) {}
 void test2_fetch1_event(EventsReceiver<MyEvent2Test, EMITTER(Test1)> &p_events) {}
 void test2_fetch2_event(EventsReceiver<MyEvent2Test, EMITTER(Test1)> &p_events) {}
 void test2_fetch3_event(EventsReceiver<MyEvent2Test, EMITTER(Test2)> &p_events) {}
 
 void test_fetch_databag_mut(TestSystem1Databag *) {}
 void test_fetch_databag_const(TestSystem1Databag *) {}
+void test_cached_query_1(CachedQuery<const TagTestComponent> &p_query) {}
+void test_cached_query_2(CachedQuery<const TagTestComponent> &p_query) {}
+void test_not_cached_query(Query<const TagTestComponent> &p_query) {}
 
 namespace godex_tests {
 TEST_CASE("[Modules][ECS] Make sure the function `can_systems_run_in_parallel` works as expected.") {
 	ECS::register_system(test2_emit_event, "test2_emit_event");
+	ECS::register_system(test3_emit_event, "test3_emit_event");
 	ECS::register_system(test2_fetch1_event, "test2_fetch1_event");
 	ECS::register_system(test2_fetch2_event, "test2_fetch2_event");
 	ECS::register_system(test2_fetch3_event, "test2_fetch3_event");
 	ECS::register_system(test_fetch_databag_mut, "test_fetch_databag_mut");
 	ECS::register_system(test_fetch_databag_const, "test_fetch_databag_const");
+	ECS::register_system(test_cached_query_1, "test_cached_query_1");
+	ECS::register_system(test_cached_query_2, "test_cached_query_2");
+	ECS::register_system(test_not_cached_query, "test_not_cached_query");
 	ECS::register_event<MyEvent2Test>();
 
 	// Make sure that two systems that emits two different events can run in parallel.
 	CHECK(ECS::can_systems_run_in_parallel(ECS::get_system_id("test2_emit_event"), ECS::get_system_id("test_emit_event")));
 
-	// Make sure the system that emit the event can't run in parallel with the
-	// systems that fetch it.
-	CHECK(!ECS::can_systems_run_in_parallel(ECS::get_system_id("test_emit_event"), ECS::get_system_id("test_fetch_event")));
+	// Make sure that two systems that emits the same event can run in parallel.
+	CHECK(ECS::can_systems_run_in_parallel(ECS::get_system_id("test3_emit_event"), ECS::get_system_id("test_emit_event")));
+
+	// Make sure the system that emit the event can run in parallel with the
+	// systems that fetch it, since the events are double buffered.
+	CHECK(ECS::can_systems_run_in_parallel(ECS::get_system_id("test_emit_event"), ECS::get_system_id("test_fetch_event")));
 
 	// Check the above on the other set of systems.
-	CHECK(!ECS::can_systems_run_in_parallel(ECS::get_system_id("test2_emit_event"), ECS::get_system_id("test2_fetch1_event")));
-	CHECK(!ECS::can_systems_run_in_parallel(ECS::get_system_id("test2_emit_event"), ECS::get_system_id("test2_fetch2_event")));
-	CHECK(!ECS::can_systems_run_in_parallel(ECS::get_system_id("test2_emit_event"), ECS::get_system_id("test2_fetch3_event")));
+	CHECK(ECS::can_systems_run_in_parallel(ECS::get_system_id("test2_emit_event"), ECS::get_system_id("test2_fetch1_event")));
+	CHECK(ECS::can_systems_run_in_parallel(ECS::get_system_id("test2_emit_event"), ECS::get_system_id("test2_fetch2_event")));
+	CHECK(ECS::can_systems_run_in_parallel(ECS::get_system_id("test2_emit_event"), ECS::get_system_id("test2_fetch3_event")));
 
 	// Make sure the fetch events can run in parallel no matter what.
 	CHECK(ECS::can_systems_run_in_parallel(ECS::get_system_id("test2_fetch1_event"), ECS::get_system_id("test2_fetch2_event")));
@@ -1484,6 +1824,11 @@ TEST_CASE("[Modules][ECS] Make sure the function `can_systems_run_in_parallel` w
 	CHECK(ECS::can_systems_run_in_parallel(ECS::get_system_id("test_fetch_databag_const"), ECS::get_system_id("test2_emit_event")));
 	CHECK(ECS::can_systems_run_in_parallel(ECS::get_system_id("test_fetch_databag_const"), ECS::get_system_id("test2_fetch3_event")));
 
+	// The systems using the same `CachedQuery` update the same cache, even
+	// when they only read the components.
+	CHECK(!ECS::can_systems_run_in_parallel(ECS::get_system_id("test_cached_query_1"), ECS::get_system_id("test_cached_query_2")));
+	CHECK(ECS::can_systems_run_in_parallel(ECS::get_system_id("test_cached_query_1"), ECS::get_system_id("test_not_cached_query")));
+
 	// TODO add other checks, like query, etc??
 }
 } // namespace godex_tests
@@ -217,6 +217,151 @@ TEST_CASE("[Modules][ECS] Test World NodePath.") {
 	CHECK(world.get_entity_path(entity_3) == node_3);
 }
 
+TEST_CASE("[Modules][ECS] Test World reuses the destroyed Entity IDs.") {
+	World world;
+
+	const EntityID entity_1 = world.create_entity().with(TransformComponent());
+	const EntityID entity_2 = world.create_entity().with(TransformComponent());
+	CHECK(world.is_entity_alive(entity_1));
+	CHECK(world.is_entity_alive(entity_2));
+	CHECK(entity_1.get_generation() == 0);
+
+	world.destroy_entity(entity_1);
+	CHECK(world.is_entity_alive(entity_1) == false);
+	CHECK(world.is_entity_alive(entity_2));
+
+	// The index is not reused at once: the destroyed indices are reused in
+	// order, once enough of them are free.
+	for (uint32_t i = 0; i < WorldCommands::MIN_FREE_INDICES - 1; i += 1) {
+		const EntityID entity = world.create_entity();
+		CHECK(entity.get_index() != entity_1.get_index());
+		world.destroy_entity(entity);
+	}
+
+	// The index is reused, with a new generation.
+	const EntityID entity_3 = world.create_entity();
+	CHECK(entity_3.get_index() == entity_1.get_index());
+	CHECK(entity_3.get_generation() == 1);
+	CHECK((entity_3 == entity_1) == false);
+	CHECK(world.is_entity_alive(entity_3));
+	CHECK(world.is_entity_alive(entity_1) == false);
+
+	// The new `Entity` doesn't have the components of the destroyed one.
+	CHECK(world.has_component<TransformComponent>(entity_3) == false);
+
+	// Destroy the stale `EntityID` does nothing.
+	world.add_component(entity_3, TransformComponent());
+	world.destroy_entity(entity_1);
+	CHECK(world.is_entity_alive(entity_3));
+	CHECK(world.has_component<TransformComponent>(entity_3));
+
+	// The full ID survives the `Variant` conversion.
+	const Variant v = entity_3;
+	CHECK(EntityID(v) == entity_3);
+
+	// Spawn and despawn many times, the storages don't grow.
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		const EntityID entity = world.create_entity().with(TransformComponent());
+		CHECK(entity.get_index() < WorldCommands::MIN_FREE_INDICES + 2);
+		world.destroy_entity(entity);
+	}
+}
+
+TEST_CASE("[Modules][ECS] Test World tracks the components of each Entity.") {
+	World world;
+
+	const EntityID entity_1 = world.create_entity().with(TransformComponent());
+	const EntityID entity_2 = world.create_entity().with(TransformComponent());
+	const EntityID entity_3 = world.create_entity();
+
+	CHECK(world.has_component<TransformComponent>(entity_1));
+	CHECK(world.has_component<TransformComponent>(entity_2));
+	CHECK(world.has_component<TransformComponent>(entity_3) == false);
+
+	world.remove_component<TransformComponent>(entity_2);
+	CHECK(world.has_component<TransformComponent>(entity_2) == false);
+
+	// Inserting directly into the storage is tracked too.
+	world.get_storage<TransformComponent>()->insert(entity_3, TransformComponent());
+	CHECK(world.has_component<TransformComponent>(entity_3));
+
+	// Only the storages of the `Entity` are visited: all its components are
+	// removed, the other `Entities` are untouched.
+	world.destroy_entity(entity_1);
+	CHECK(world.get_storage<TransformComponent>()->has(entity_1) == false);
+	CHECK(world.has_component<TransformComponent>(entity_1) == false);
+	CHECK(world.has_component<TransformComponent>(entity_3));
+
+	// The recycled `Entity` starts without components.
+	for (uint32_t i = 0; i < WorldCommands::MIN_FREE_INDICES - 1; i += 1) {
+		world.destroy_entity(world.create_entity());
+	}
+	const EntityID entity_4 = world.create_entity();
+	CHECK(entity_4.get_index() == entity_1.get_index());
+	CHECK(world.has_component<TransformComponent>(entity_4) == false);
+
+	world.get_storage<TransformComponent>()->clear();
+	CHECK(world.has_component<TransformComponent>(entity_3) == false);
+}
+
+TEST_CASE("[Modules][ECS] Test World create entities in batch.") {
+	World world;
+
+	TransformComponent transform(Transform3D(Basis(), Vector3(1.0, 2.0, 3.0)));
+	const EntitiesBuilder &builder = world.create_entities(1000).with(transform);
+	CHECK(builder.size() == 1000);
+
+	const Storage<const TransformComponent> *storage = world.get_storage<const TransformComponent>();
+	for (uint32_t i = 0; i < builder.size(); i += 1) {
+		CHECK(world.is_entity_alive(builder[i]));
+		CHECK(world.has_component<TransformComponent>(builder[i]));
+		CHECK((storage->get(builder[i])->origin - Vector3(1.0, 2.0, 3.0)).length() < CMP_EPSILON);
+	}
+
+	LocalVector<EntityID> entities;
+	for (uint32_t i = 0; i < builder.size(); i += 1) {
+		entities.push_back(builder[i]);
+	}
+
+	world.remove_component_batch<TransformComponent>(entities.ptr(), 500);
+	for (uint32_t i = 0; i < entities.size(); i += 1) {
+		CHECK(world.has_component<TransformComponent>(entities[i]) == (i >= 500));
+	}
+}
+
+TEST_CASE("[Modules][ECS] Test World memory report.") {
+	World world;
+
+	LocalVector<EntityID> entities;
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		entities.push_back(world.create_entity().with(TransformComponent()));
+	}
+
+	const StorageMemoryStats stats = world.get_storage<TransformComponent>()->get_memory_stats();
+	CHECK(stats.live_count == 1000);
+	CHECK(stats.bytes_used >= 1000 * sizeof(TransformComponent));
+	CHECK(stats.bytes_reserved >= stats.bytes_used);
+
+	Dictionary report = world.get_memory_report();
+	REQUIRE(report.has(TransformComponent::get_class_static()));
+	Dictionary transform_report = report[TransformComponent::get_class_static()];
+	CHECK(uint32_t(transform_report["live_count"]) == 1000);
+	CHECK(uint64_t(transform_report["bytes_used"]) == stats.bytes_used);
+	CHECK(uint64_t(transform_report["bytes_reserved"]) == stats.bytes_reserved);
+
+	// Removing the components keeps the memory: the fragmentation grows.
+	world.remove_component_batch<TransformComponent>(entities.ptr(), 500);
+	const StorageMemoryStats after = world.get_storage<TransformComponent>()->get_memory_stats();
+	CHECK(after.live_count == 500);
+	CHECK(after.bytes_used < stats.bytes_used);
+	CHECK(after.get_fragmentation() > stats.get_fragmentation());
+	CHECK(after.get_fragmentation() < 1.0);
+
+	// Without memory, there is no fragmentation.
+	StorageMemoryStats empty;
+	CHECK(empty.get_fragmentation() == 0.0);
+}
+
 TEST_CASE("[Modules][ECS] Test WorldECS runtime API create entity from prefab.") {
 	WorldECS world;
 
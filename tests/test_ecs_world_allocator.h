@@ -0,0 +1,139 @@
+#ifndef TEST_ECS_WORLD_ALLOCATOR_H
+#define TEST_ECS_WORLD_ALLOCATOR_H
+
+#include "tests/test_macros.h"
+
+#include "../ecs.h"
+#include "../memory/world_allocator.h"
+#include "../storage/archetype_storage.h"
+#include "../storage/steady_storage.h"
+#include "../world/world.h"
+
+struct AllocatorArchetypeTest {
+	COMPONENT(AllocatorArchetypeTest, ArchetypeStorage)
+
+	int value = 0;
+};
+
+struct AllocatorSteadyTest {
+	COMPONENT(AllocatorSteadyTest, SteadyStorage)
+
+	int value = 0;
+};
+
+namespace godex_world_allocator_tests {
+
+TEST_CASE("[Modules][ECS] Test WorldAllocator reuses the released blocks.") {
+	WorldAllocator allocator;
+	allocator.configure(0, 4096);
+
+	void *a = allocator.alloc(100);
+	void *b = allocator.alloc(100);
+	CHECK(a != b);
+	CHECK((uintptr_t(a) % WorldAllocator::ALIGNMENT) == 0);
+	CHECK((uintptr_t(b) % WorldAllocator::ALIGNMENT) == 0);
+	CHECK(allocator.get_used() == 224);
+	CHECK(allocator.get_reserved() == 4096);
+
+	// The released block is reused by the next allocation of the same size.
+	allocator.free(a, 100);
+	CHECK(allocator.get_used() == 112);
+	CHECK(allocator.alloc(100) == a);
+
+	// The big blocks are taken from the system.
+	void *big = allocator.alloc(2048);
+	CHECK(allocator.get_reserved() == 4096 + 2048);
+	allocator.free(big, 2048);
+	CHECK(allocator.get_reserved() == 4096);
+	CHECK(allocator.get_peak_used() == 224 + 2048);
+
+	allocator.reset();
+	CHECK(allocator.get_used() == 0);
+	CHECK(allocator.get_reserved() == 0);
+}
+
+TEST_CASE("[Modules][ECS] Test WorldAllocator budget.") {
+	WorldAllocator allocator;
+	allocator.configure(1024, 4096);
+
+	void *a = allocator.alloc(1000);
+	CHECK(allocator.is_over_budget() == false);
+	CHECK(allocator.get_over_budget_count() == 0);
+
+	// Exceeding the budget is reported, the allocation is still done.
+	ERR_PRINT_OFF;
+	void *b = allocator.alloc(512);
+	ERR_PRINT_ON;
+	CHECK(b != nullptr);
+	CHECK(allocator.is_over_budget());
+	CHECK(allocator.get_over_budget_count() == 1);
+
+	allocator.free(b, 512);
+	CHECK(allocator.is_over_budget() == false);
+
+	// The budget can change while the blocks are in use, the slab size can't:
+	// the in use blocks are released using the slab size they were taken with.
+	ERR_PRINT_OFF;
+	allocator.configure(0, 64 * 1024);
+	ERR_PRINT_ON;
+	CHECK(allocator.get_budget() == 0);
+	allocator.free(a, 1000);
+	CHECK(allocator.get_used() == 0);
+	CHECK(allocator.get_reserved() == 4096);
+
+	// Once reset, the slab size can change.
+	allocator.reset();
+	allocator.configure(0, 64 * 1024);
+	allocator.alloc(2048);
+	CHECK(allocator.get_reserved() == 64 * 1024);
+}
+
+TEST_CASE("[Modules][ECS] Test World storages allocate from the WorldAllocator.") {
+	ECS::register_component<AllocatorArchetypeTest>();
+	ECS::register_component<AllocatorSteadyTest>();
+
+	World world;
+	CHECK(world.get_allocator().get_used() == 0);
+
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		AllocatorArchetypeTest archetype;
+		archetype.value = i;
+		AllocatorSteadyTest steady;
+		steady.value = i;
+		world.create_entity().with(archetype).with(steady);
+	}
+
+	// The chunks and the pages are taken from the allocator.
+	const uint64_t used = world.get_allocator().get_used();
+	CHECK(used > 1000 * (sizeof(AllocatorArchetypeTest) + sizeof(AllocatorSteadyTest)));
+
+	Dictionary report = world.get_memory_report();
+	REQUIRE(report.has("WorldAllocator"));
+	CHECK(uint64_t(Dictionary(report["WorldAllocator"])["bytes_used"]) == used);
+
+	// Destroying the `Entities` gives the memory back to the allocator,
+	// that keeps it for the next `Entities`.
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		world.destroy_entity(i);
+	}
+	CHECK(world.get_allocator().get_used() < used);
+	const uint64_t reserved = world.get_allocator().get_reserved();
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		world.create_entity().with(AllocatorArchetypeTest()).with(AllocatorSteadyTest());
+	}
+	CHECK(world.get_allocator().get_reserved() == reserved);
+
+	// The teardown frees everything at once, and the `World` can be used
+	// again.
+	world.teardown();
+	CHECK(world.get_allocator().get_used() == 0);
+	CHECK(world.get_allocator().get_reserved() == 0);
+	CHECK(world.get_storage<AllocatorSteadyTest>() == nullptr);
+
+	const EntityID entity = world.create_entity().with(AllocatorSteadyTest());
+	CHECK(world.get_storage<AllocatorSteadyTest>()->has(entity));
+	CHECK(world.get_allocator().get_used() > 0);
+}
+} // namespace godex_world_allocator_tests
+
+#endif // TEST_ECS_WORLD_ALLOCATOR_H
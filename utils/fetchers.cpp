@@ -265,9 +265,6 @@ void EventsEmitterDynamicFetcher::prepare_world(World *p_world) {}
 
 void EventsEmitterDynamicFetcher::initiate_process(World *p_world) {
 	event_storage_ptr = p_world->get_events_storage(event_id);
-	if (event_storage_ptr) {
-		event_storage_ptr->flush_events();
-	}
 }
 
 void EventsEmitterDynamicFetcher::conclude_process(World *p_world) {
@@ -287,6 +284,7 @@ void EventsReceiverDynamicFetcher::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_mutable"), &EventsReceiverDynamicFetcher::is_mutable);
 	ClassDB::bind_method(D_METHOD("is_valid"), &EventsReceiverDynamicFetcher::is_valid);
 	ClassDB::bind_method(D_METHOD("fetch"), &EventsReceiverDynamicFetcher::fetch);
+	ClassDB::bind_method(D_METHOD("fetch_columns"), &EventsReceiverDynamicFetcher::fetch_columns);
 }
 
 void EventsReceiverDynamicFetcher::init(uint32_t p_identifier, const String &p_emitter_name) {
@@ -324,21 +322,55 @@ void EventsReceiverDynamicFetcher::get_system_info(SystemExeInfo *r_info) const
 	emitters->insert(emitter_name);
 }
 
-void EventsReceiverDynamicFetcher::prepare_world(World *p_world) {}
+void EventsReceiverDynamicFetcher::prepare_world(World *p_world) {
+	// Registers the receiver, so the events are kept until it reads them.
+	EventStorageBase *storage = p_world->get_events_storage(event_id);
+	if (storage) {
+		emitter_id = storage->get_emitter_id(emitter_name);
+		if (emitter_id != godex::EMITTER_NONE) {
+			receiver = storage->add_event_receiver(emitter_id);
+			receiver_storage = storage;
+		}
+	}
+}
 
 void EventsReceiverDynamicFetcher::initiate_process(World *p_world) {
 	event_storage_ptr = p_world->get_events_storage(event_id);
+	if (event_storage_ptr && receiver != UINT32_MAX) {
+		from = event_storage_ptr->receive_events(emitter_id, receiver);
+	}
 }
 
 void EventsReceiverDynamicFetcher::conclude_process(World *p_world) {
 	event_storage_ptr = nullptr;
 }
 
-void EventsReceiverDynamicFetcher::release_world(World *p_world) {}
+void EventsReceiverDynamicFetcher::release_world(World *p_world) {
+	if (receiver != UINT32_MAX) {
+		EventStorageBase *storage = p_world->get_events_storage(event_id);
+		if (storage) {
+			storage->remove_event_receiver(emitter_id, receiver);
+		}
+	}
+	emitter_id = godex::EMITTER_NONE;
+	receiver = UINT32_MAX;
+	receiver_storage = nullptr;
+}
 
-void EventsReceiverDynamicFetcher::set_active(bool p_active) {}
+void EventsReceiverDynamicFetcher::set_active(bool p_active) {
+	if (receiver_storage != nullptr) {
+		receiver_storage->set_event_receiver_active(emitter_id, receiver, p_active);
+	}
+}
 
 Array EventsReceiverDynamicFetcher::fetch() {
 	ERR_FAIL_COND_V(event_storage_ptr == nullptr, Array());
-	return event_storage_ptr->get_events_array(emitter_name);
+	ERR_FAIL_COND_V(receiver == UINT32_MAX, Array());
+	return event_storage_ptr->get_events_array(emitter_id, from);
+}
+
+Dictionary EventsReceiverDynamicFetcher::fetch_columns() {
+	ERR_FAIL_COND_V(event_storage_ptr == nullptr, Dictionary());
+	ERR_FAIL_COND_V(receiver == UINT32_MAX, Dictionary());
+	return event_storage_ptr->get_events_columns(emitter_id, from);
 }
@@ -3,8 +3,14 @@
 
 #include "../ecs.h"
 #include "../pipeline/pipeline.h"
+#include "../storage/archetype_table.h"
+#include "../storage/dense_group.h"
 #include "../storage/hierarchical_storage.h"
 
+/// Seeds the `entities_version` of the storages, so the storages of all the
+/// `World`s have different versions.
+static SafeNumeric<uint32_t> storages_serial;
+
 EntityBuilder::EntityBuilder(World *p_world) :
 		world(p_world) {
 }
@@ -19,19 +25,68 @@ const EntityBuilder &EntityBuilder::with(uint32_t p_component_id, godex::SID p_s
 	return *this;
 }
 
+EntitiesBuilder::EntitiesBuilder(World *p_world) :
+		world(p_world) {
+}
+
 void WorldCommands::_bind_methods() {
 	add_method("create_entity", &WorldCommands::create_entity);
 	add_method("destroy_deferred", &WorldCommands::destroy_deferred);
 }
 
 EntityID WorldCommands::create_entity() {
-	return entity_register++;
+	if (free_indices.size() - free_indices_head >= MIN_FREE_INDICES) {
+		// Reuse the index of the `Entity` destroyed the longest time ago.
+		const uint32_t index = free_indices[free_indices_head];
+		free_indices_head += 1;
+		if (free_indices_head * 2 >= free_indices.size()) {
+			// Drop the consumed half, so the queue doesn't grow.
+			const uint32_t count = free_indices.size() - free_indices_head;
+			for (uint32_t i = 0; i < count; i += 1) {
+				free_indices[i] = free_indices[free_indices_head + i];
+			}
+			free_indices.resize(count);
+			free_indices_head = 0;
+		}
+		return EntityID(index, generations[index]);
+	}
+
+	CRASH_COND_MSG(entity_register >= EntityID::INDEX_MASK, "The maximum number of alive `Entities` is reached.");
+	generations.push_back(0);
+	const EntityID entity(entity_register++, 0);
+	if (entity_signatures) {
+		entity_signatures->reserve(entity);
+	}
+	return entity;
 }
 
 void WorldCommands::destroy_deferred(EntityID p_entity) {
 	garbage_list.push_back(p_entity);
 }
 
+bool WorldCommands::is_entity_alive(EntityID p_entity) const {
+	const uint32_t index = p_entity.get_index();
+	// When destroyed the generation is incremented, so the stale `EntityID`s
+	// don't match anymore.
+	return index < generations.size() && generations[index] == p_entity.get_generation();
+}
+
+bool WorldCommands::release_entity(EntityID p_entity) {
+	const uint32_t index = p_entity.get_index();
+	if (index >= generations.size()) {
+		// This index was never created by the `World`, nothing to release.
+		return true;
+	}
+	if (generations[index] != p_entity.get_generation()) {
+		// Stale `EntityID`: already destroyed.
+		return false;
+	}
+	// Any `EntityID` still pointing to this index is now stale.
+	generations[index] = (generations[index] + 1) & EntityID::GENERATION_MASK;
+	free_indices.push_back(index);
+	return true;
+}
+
 void World::_bind_methods() {
 	add_method("get_entity_from_path", &World::get_entity_from_path);
 	add_method("get_entity_path", &World::get_entity_path);
@@ -54,15 +109,33 @@ World::World(WorldECS *p_world_ecs) :
 	databags[WorldCommands::get_databag_id()] = &commands;
 	databags[World::get_databag_id()] = this;
 
+	archetype_table = memnew(ArchetypeTable(&allocator));
+	commands.entity_signatures = &entity_signatures;
+
 	create_storage<Child>();
 }
 
 World::~World() {
+	// The pipelines free the systems data from the allocator, and the
+	// systems use the storages: so release them first.
+	release_pipelines();
+
+	for (uint32_t i = 0; i < groups.size(); i += 1) {
+		memdelete(groups[i]);
+	}
+	groups.clear();
 	for (uint32_t i = 0; i < storages.size(); i += 1) {
 		if (storages[i]) {
 			delete storages[i];
 		}
 	}
+	// Deleted after the storages, since they notify the caches.
+	for (uint32_t i = 0; i < query_caches.size(); i += 1) {
+		memdelete(query_caches[i]);
+	}
+	query_caches.clear();
+	// Deleted after the storages, since the `ArchetypeStorage`s use it.
+	memdelete(archetype_table);
 	for (uint32_t i = 0; i < databags.size(); i += 1) {
 		if (i == World::get_databag_id() || i == WorldCommands::get_databag_id()) {
 			// This is automatic memory.
@@ -83,6 +156,14 @@ const EntityBuilder &World::create_entity() {
 	return entity_builder;
 }
 
+const EntitiesBuilder &World::create_entities(uint32_t p_count) {
+	entities_builder.entities.resize(p_count);
+	for (uint32_t i = 0; i < p_count; i += 1) {
+		entities_builder.entities[i] = create_entity_index();
+	}
+	return entities_builder;
+}
+
 void World::assign_nodepath_to_entity(EntityID p_entity, const NodePath &p_path) {
 	// TODO consider to convert the nodepath to a more efficient structure?
 	// maybe by partizioning each node to a tree structure, it's possible to find
@@ -99,14 +180,32 @@ void World::assign_nodepath_to_entity(EntityID p_entity, const NodePath &p_path)
 }
 
 void World::destroy_entity(EntityID p_entity) {
-	// Removes the components assigned to this entity.
-	for (uint32_t i = 0; i < storages.size(); i += 1) {
-		if (storages[i] != nullptr && storages[i]->has(p_entity)) {
-			storages[i]->remove(p_entity);
+	if (commands.release_entity(p_entity) == false) {
+		// Already destroyed, nothing to do.
+		return;
+	}
+
+	// Removes the components assigned to this entity, visiting only the
+	// storages that have it.
+	entity_signatures.for_each(p_entity, [&](uint32_t p_component_id) {
+		storages[p_component_id]->remove(p_entity);
+	});
+	entity_signatures.clear(p_entity);
+
+	for (uint32_t i = 0; i < untracked_storages.size(); i += 1) {
+		StorageBase *storage = storages[untracked_storages[i]];
+		if (storage->has(p_entity)) {
+			storage->remove(p_entity);
 		}
 	}
+}
+
+bool World::is_entity_alive(EntityID p_entity) const {
+	return commands.is_entity_alive(p_entity);
+}
 
-	// TODO consider to reuse this ID.
+uint32_t World::get_entity_index_limit() const {
+	return commands.entity_register;
 }
 
 EntityID World::get_entity_from_path(const NodePath &p_path) const {
@@ -155,11 +254,21 @@ void World::remove_component(EntityID p_entity, uint32_t p_component_id) {
 	storage->remove(p_entity);
 }
 
+void World::remove_component_batch(const EntityID *p_entities, uint32_t p_count, uint32_t p_component_id) {
+	StorageBase *storage = get_storage(p_component_id);
+	ERR_FAIL_COND(storage == nullptr);
+	storage->remove_batch(p_entities, p_count);
+}
+
 bool World::has_component(EntityID p_entity, uint32_t p_component_id) const {
 	const StorageBase *storage = get_storage(p_component_id);
 	if (unlikely(storage == nullptr)) {
 		return false;
 	}
+	if (storage->entity_signatures != nullptr) {
+		// No need to call the storage.
+		return entity_signatures.has(p_entity, p_component_id);
+	}
 	return storage->has(p_entity);
 }
 
@@ -214,6 +323,272 @@ const SharedStorageBase *World::get_shared_storage(uint32_t p_storage_id) const
 	return dynamic_cast<const SharedStorageBase *>(get_storage(p_storage_id));
 }
 
+void World::create_group(const LocalVector<godex::component_id> &p_components) {
+	ERR_FAIL_COND_MSG(p_components.size() < 2, "The group needs at least two components.");
+
+	LocalVector<DenseGroupStorage *> group_storages;
+	for (uint32_t i = 0; i < p_components.size(); i += 1) {
+		ERR_FAIL_COND_MSG(p_components.find(p_components[i]) != int64_t(i), "The component " + ECS::get_component_name(p_components[i]) + " is used twice by this group.");
+
+		create_storage(p_components[i]);
+		DenseGroupStorage *storage = dynamic_cast<DenseGroupStorage *>(get_storage(p_components[i]));
+		ERR_FAIL_COND_MSG(storage == nullptr, "The component " + ECS::get_component_name(p_components[i]) + " can't be grouped, only the `DenseVectorStorage` can be grouped.");
+		ERR_FAIL_COND_MSG(storage->group != nullptr, "The component " + ECS::get_component_name(p_components[i]) + " is already part of a group.");
+		group_storages.push_back(storage);
+	}
+
+	DenseGroup *group = memnew(DenseGroup(p_components, group_storages));
+	for (uint32_t i = 0; i < group_storages.size(); i += 1) {
+		group_storages[i]->group = group;
+	}
+	groups.push_back(group);
+
+	// Pack the `Entities` already stored.
+	group->pack();
+}
+
+const DenseGroup *World::get_group(const godex::component_id *p_components, uint32_t p_count) const {
+	for (uint32_t i = 0; i < groups.size(); i += 1) {
+		if (groups[i]->matches(p_components, p_count)) {
+			return groups[i];
+		}
+	}
+	return nullptr;
+}
+
+QueryMatchCache *World::get_query_cache(uint64_t p_key, const LocalVector<godex::component_id> &p_components) {
+	for (uint32_t i = 0; i < p_components.size(); i += 1) {
+		const StorageBase *storage = get_storage(p_components[i]);
+		if (storage != nullptr && storage->is_tracking_entities() == false) {
+			// This storage can't notify the cache.
+			return nullptr;
+		}
+	}
+
+	query_caches_lock.lock();
+	QueryMatchCache *cache = nullptr;
+	for (uint32_t i = 0; i < query_caches.size(); i += 1) {
+		if (query_caches[i]->get_key() == p_key) {
+			cache = query_caches[i];
+			break;
+		}
+	}
+
+	if (cache == nullptr) {
+		cache = memnew(QueryMatchCache(p_key, p_components));
+		for (uint32_t i = 0; i < p_components.size(); i += 1) {
+			StorageBase *storage = get_storage(p_components[i]);
+			if (storage != nullptr) {
+				storage->match_caches.push_back(cache);
+			}
+		}
+		query_caches.push_back(cache);
+	}
+	query_caches_lock.unlock();
+
+	return cache;
+}
+
+void World::request_entities_log(godex::component_id p_component) {
+	if (logged_components.find(p_component) == -1) {
+		logged_components.push_back(p_component);
+	}
+	StorageBase *storage = get_storage(p_component);
+	if (storage != nullptr) {
+		storage->entities_log_enabled = true;
+	}
+}
+
+void World::trim_entities_logs() {
+	const uint32_t tick = get_change_tick();
+	tick_readers_lock.lock();
+	for (uint32_t i = 0; i < logged_components.size(); i += 1) {
+		StorageBase *storage = get_storage(logged_components[i]);
+		if (storage == nullptr) {
+			continue;
+		}
+
+		// Keep the entries not yet taken by any active reader of this log.
+		uint32_t trim_tick = tick;
+		for (uint32_t r = 0; r < tick_readers.size(); r += 1) {
+			const ChangeTickReader *reader = tick_readers[r];
+			// Wrapping compare, so the ticks can overflow.
+			if (reader->active &&
+					int32_t(reader->last_run_tick - trim_tick) < 0 &&
+					reader->logged_components.find(logged_components[i]) != -1) {
+				trim_tick = reader->last_run_tick;
+			}
+		}
+		storage->trim_entities_log(trim_tick);
+	}
+	tick_readers_lock.unlock();
+}
+
+ArchetypeTable *World::get_archetype_table() {
+	return archetype_table;
+}
+
+const ArchetypeTable *World::get_archetype_table() const {
+	return archetype_table;
+}
+
+WorldAllocator &World::get_allocator() {
+	return allocator;
+}
+
+const WorldAllocator &World::get_allocator() const {
+	return allocator;
+}
+
+void World::teardown() {
+	ERR_FAIL_COND_MSG(is_dispatching_in_progress, "The World can't be torn down while the pipeline is dispatching.");
+
+	// The pipelines use the storages, so release them first.
+	release_pipelines();
+
+	for (uint32_t i = 0; i < groups.size(); i += 1) {
+		memdelete(groups[i]);
+	}
+	groups.reset();
+	for (uint32_t i = 0; i < storages.size(); i += 1) {
+		if (storages[i]) {
+			delete storages[i];
+		}
+	}
+	storages.reset();
+	untracked_storages.reset();
+	for (uint32_t i = 0; i < query_caches.size(); i += 1) {
+		memdelete(query_caches[i]);
+	}
+	query_caches.reset();
+	logged_components.reset();
+	compact_storage_index = 0;
+	for (uint32_t i = 0; i < events_storages.size(); i += 1) {
+		ECS::destroy_events_storage(i, events_storages[i]);
+	}
+	events_storages.reset();
+	archetype_table->reset();
+	entity_signatures.reset();
+	entity_paths.clear();
+
+	commands.entity_register = 0;
+	commands.generations.reset();
+	commands.free_indices.reset();
+	commands.free_indices_head = 0;
+	commands.garbage_list.reset();
+
+	// Nothing uses the memory anymore, free it at once.
+	allocator.reset();
+
+	create_storage<Child>();
+}
+
+bool World::compact_storages(uint32_t p_budget) {
+	ERR_FAIL_COND_V_MSG(is_dispatching_in_progress, false, "The storages can't be compacted while the pipeline is dispatching.");
+
+	for (uint32_t visited = 0; visited < storages.size(); visited += 1) {
+		if (compact_storage_index >= storages.size()) {
+			compact_storage_index = 0;
+		}
+		StorageBase *storage = storages[compact_storage_index];
+		if (storage != nullptr && storage->compact(p_budget) == false) {
+			// Out of budget, the next call continues from this storage.
+			return false;
+		}
+		compact_storage_index += 1;
+	}
+	return true;
+}
+
+Dictionary World::get_memory_report() const {
+	Dictionary report;
+	for (uint32_t i = 0; i < storages.size(); i += 1) {
+		if (storages[i] == nullptr) {
+			continue;
+		}
+		Dictionary stats = storages[i]->get_memory_stats().to_dictionary();
+		stats["storage"] = storages[i]->get_type_name();
+		report[ECS::get_component_name(i)] = stats;
+	}
+
+	if (archetype_table->get_archetype_count() > 0) {
+		StorageMemoryStats stats;
+		archetype_table->add_memory_stats(stats);
+		report["ArchetypeTable"] = stats.to_dictionary();
+	}
+
+	StorageMemoryStats allocator_stats;
+	allocator_stats.bytes_used = allocator.get_used();
+	allocator_stats.bytes_reserved = allocator.get_reserved();
+	Dictionary allocator_report = allocator_stats.to_dictionary();
+	allocator_report["peak_used"] = allocator.get_peak_used();
+	allocator_report["budget"] = allocator.get_budget();
+	allocator_report["over_budget_count"] = allocator.get_over_budget_count();
+	report["WorldAllocator"] = allocator_report;
+	return report;
+}
+
+uint32_t World::get_change_tick() const {
+	return change_tick.get();
+}
+
+uint32_t World::advance_change_tick() {
+	const uint32_t tick = change_tick.postincrement();
+	if (unlikely(tick + 1 == UINT32_MAX)) {
+		// `UINT32_MAX` is used by the storages to mark "not changed", skip it.
+		change_tick.postincrement();
+	}
+	return tick;
+}
+
+void World::register_tick_reader(ChangeTickReader *p_reader) {
+	tick_readers_lock.lock();
+	tick_readers.push_back(p_reader);
+	tick_readers_lock.unlock();
+}
+
+void World::unregister_tick_reader(ChangeTickReader *p_reader) {
+	tick_readers_lock.lock();
+	const int64_t index = tick_readers.find(p_reader);
+	if (index != -1) {
+		tick_readers.remove_at_unordered(index);
+	}
+	tick_readers_lock.unlock();
+}
+
+void World::check_change_ticks() {
+	const uint32_t tick = get_change_tick();
+	if ((tick - last_check_change_tick) < CHANGE_CHECK_INTERVAL) {
+		// Not yet.
+		return;
+	}
+	last_check_change_tick = tick;
+
+	uint32_t oldest_tick = tick - MAX_CHANGE_AGE;
+	if (unlikely(oldest_tick == UINT32_MAX)) {
+		// `UINT32_MAX` is used by the storages to mark "not changed".
+		oldest_tick -= 1;
+	}
+	clamp_change_ticks(oldest_tick);
+}
+
+void World::clamp_change_ticks(uint32_t p_oldest_tick) {
+	for (uint32_t i = 0; i < storages.size(); i += 1) {
+		if (storages[i] != nullptr) {
+			storages[i]->clamp_change_ticks(p_oldest_tick);
+		}
+	}
+
+	tick_readers_lock.lock();
+	for (uint32_t i = 0; i < tick_readers.size(); i += 1) {
+		// Wrapping compare, so the ticks can overflow.
+		if (int32_t(tick_readers[i]->last_run_tick - p_oldest_tick) < 0) {
+			tick_readers[i]->last_run_tick = p_oldest_tick;
+		}
+	}
+	tick_readers_lock.unlock();
+}
+
 void World::create_storage(uint32_t p_component_id) {
 	if (is_dispatching_in_progress) {
 		// When dispatching is in progress, the storage is already created:
@@ -235,6 +610,31 @@ void World::create_storage(uint32_t p_component_id) {
 	}
 
 	storages[p_component_id] = ECS::create_storage(p_component_id);
+	storages[p_component_id]->entities_version = uint64_t(storages_serial.increment()) << 32;
+	storages[p_component_id]->world_change_tick = &change_tick;
+	storages[p_component_id]->allocator = &allocator;
+
+	if (storages[p_component_id]->is_tracking_entities()) {
+		entity_signatures.set_component_count(MAX(ECS::get_components_count(), p_component_id + 1));
+		storages[p_component_id]->entity_signatures = &entity_signatures;
+		storages[p_component_id]->signature_component_id = p_component_id;
+	} else {
+		untracked_storages.push_back(p_component_id);
+	}
+
+	if (logged_components.find(p_component_id) != -1) {
+		storages[p_component_id]->entities_log_enabled = true;
+	}
+
+	// The cached queries using this component have to see the new storage.
+	for (uint32_t i = 0; i < query_caches.size(); i += 1) {
+		if (query_caches[i]->uses_component(p_component_id)) {
+			if (storages[p_component_id]->is_tracking_entities()) {
+				storages[p_component_id]->match_caches.push_back(query_caches[i]);
+			}
+			query_caches[i]->invalidate();
+		}
+	}
 
 	// Automatically set the hierarchy, if this is a HierarchicalStorage.
 	HierarchicalStorageBase *hs = dynamic_cast<HierarchicalStorageBase *>(storages[p_component_id]);
@@ -244,6 +644,12 @@ void World::create_storage(uint32_t p_component_id) {
 		hierarchy->add_sub_storage(hs);
 	}
 
+	// Automatically set the archetype table, if this is an ArchetypeStorage.
+	ArchetypeStorageBase *as = dynamic_cast<ArchetypeStorageBase *>(storages[p_component_id]);
+	if (as) {
+		as->set_table(archetype_table);
+	}
+
 	// Search the config for this storage.
 	Dictionary config = storages_config.get(
 			ECS::get_component_name(p_component_id),
@@ -267,6 +673,28 @@ void World::destroy_storage(uint32_t p_component_id) {
 		return;
 	}
 
+	if (storages[p_component_id]->entity_signatures != nullptr) {
+		entity_signatures.remove_component(p_component_id);
+	} else {
+		untracked_storages.erase(p_component_id);
+	}
+
+	DenseGroupStorage *gs = dynamic_cast<DenseGroupStorage *>(storages[p_component_id]);
+	if (gs && gs->group) {
+		// The group can't exist without this storage: disband it.
+		DenseGroup *group = gs->group;
+		for (uint32_t i = 0; i < group->get_components().size(); i += 1) {
+			DenseGroupStorage *member = dynamic_cast<DenseGroupStorage *>(storages[group->get_components()[i]]);
+			member->group = nullptr;
+		}
+		groups.erase(group);
+		memdelete(group);
+	}
+
+	for (uint32_t i = 0; i < storages[p_component_id]->match_caches.size(); i += 1) {
+		storages[p_component_id]->match_caches[i]->invalidate();
+	}
+
 	delete storages[p_component_id];
 	storages[p_component_id] = nullptr;
 }
@@ -383,9 +811,10 @@ const EventStorageBase *World::get_events_storage(godex::event_id p_id) const {
 }
 
 void World::release_pipelines() {
-	for (uint32_t i = 0; i < associated_pipelines.size(); i += 1) {
-		Token token = associated_pipelines[i]->get_token(this);
-		associated_pipelines[i]->release_world(token);
+	while (associated_pipelines.size() > 0) {
+		// Popped before releasing, since `release_world` removes it too.
+		Pipeline *pipeline = associated_pipelines[associated_pipelines.size() - 1];
+		associated_pipelines.resize(associated_pipelines.size() - 1);
+		pipeline->release_world(pipeline->get_token(this));
 	}
-	associated_pipelines.clear();
 }
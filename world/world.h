@@ -4,10 +4,13 @@
 #include "../ecs_types.h"
 #include "../storage/event_storage.h"
 #include "../storage/storage.h"
+#include "core/os/spin_lock.h"
 #include "core/string/string_name.h"
 #include "core/templates/local_vector.h"
 
 class StorageBase;
+class ArchetypeTable;
+class DenseGroup;
 class World;
 class WorldECS;
 class Pipeline;
@@ -54,6 +57,47 @@ public:
 	}
 };
 
+/// Utility that can be used to create many entities with the same components.
+/// You can use it in this way:
+/// ```
+///	World world;
+///
+///	world.create_entities(20000)
+///			.with(TransformComponent())
+///			.with(MeshComponent());
+/// ```
+/// Each component is inserted to all the `Entities` at once, using the storage
+/// `insert_batch`.
+class EntitiesBuilder {
+	friend class World;
+
+	LocalVector<EntityID> entities;
+	World *world;
+
+private:
+	EntitiesBuilder(World *p_world);
+	EntitiesBuilder &operator=(const EntitiesBuilder &) = delete;
+	EntitiesBuilder &operator=(EntitiesBuilder) = delete;
+	EntitiesBuilder(const EntitiesBuilder &) = delete;
+	EntitiesBuilder() = delete;
+
+public:
+	template <class C>
+	const EntitiesBuilder &with(const C &p_data) const;
+
+	uint32_t size() const {
+		return entities.size();
+	}
+
+	const EntityID *get_entities() const {
+		return entities.ptr();
+	}
+
+	EntityID operator[](uint32_t p_index) const {
+		return entities[p_index];
+	}
+};
+
 // TODO make this under godex namespace.
 
 // TODO consider to split this in multiple `Databag`, one for removal and the
@@ -67,17 +111,46 @@ class WorldCommands : public godex::Databag {
 	/// Used to keep tracks of entity IDs.
 	uint32_t entity_register = 0;
 
+	/// The current generation of each `Entity` index.
+	LocalVector<uint8_t> generations;
+
+	/// The indices of the destroyed `Entities`, reused by `create_entity` so
+	/// the storages don't grow each time an `Entity` is created.
+	/// It's a FIFO queue starting at `free_indices_head`: the index destroyed
+	/// the longest time ago is reused first.
+	LocalVector<uint32_t> free_indices;
+	uint32_t free_indices_head = 0;
+
+	/// The components of each `Entity`, owned by the `World`.
+	EntitySignatures *entity_signatures = nullptr;
+
 	/// List of `Entity` to destroy.
 	LocalVector<EntityID> garbage_list;
 
 	static void _bind_methods();
 
 public:
+	/// A destroyed index is reused only once this many indices are free. The
+	/// generation has only 8 bits: so an index is not destroyed and reused
+	/// over and over, wrapping its generation while a stale `EntityID` to it
+	/// is still around.
+	static constexpr uint32_t MIN_FREE_INDICES = 1024;
+
 	/// Immediately creates a new `Entity`.
 	EntityID create_entity();
 
 	/// Mark this `Entity` for disposal.
 	void destroy_deferred(EntityID p_entity);
+
+	/// Returns `true` if this `Entity` is not yet destroyed. Returns `false`
+	/// for a stale `EntityID`, that refers to a destroyed `Entity`, even if
+	/// its index is now used by another one.
+	bool is_entity_alive(EntityID p_entity) const;
+
+private:
+	/// Releases the index of this `Entity`, so it can be reused.
+	/// Returns `false` if the `Entity` is already destroyed.
+	bool release_entity(EntityID p_entity);
 };
 
 /// The World is a special `Databag` because it's used to store all the ECS storages.
@@ -96,13 +169,45 @@ class World : public godex::Databag {
 
 	friend class Pipeline;
 
+	/// The storages, the `ArchetypeTable` and the systems data allocate from
+	/// here. Declared first, so it's destroyed last.
+	WorldAllocator allocator;
 	LocalVector<Pipeline *> associated_pipelines;
 	WorldCommands commands;
 	LocalVector<StorageBase *> storages;
 	LocalVector<godex::Databag *> databags;
 	LocalVector<EventStorageBase *> events_storages;
+	/// Stores the components that use the `ArchetypeStorage`.
+	ArchetypeTable *archetype_table = nullptr;
+	/// The components of each `Entity`, updated by the storages that track
+	/// their `Entities`.
+	EntitySignatures entity_signatures;
+	/// The storages that don't track their `Entities`, so `has` is used.
+	LocalVector<uint32_t> untracked_storages;
+	/// The owning groups, check `create_group`.
+	LocalVector<DenseGroup *> groups;
+	/// The caches of the cached `Query`s, check `get_query_cache`.
+	LocalVector<QueryMatchCache *> query_caches;
+	/// The cached `Query`s running in parallel may create the caches at the
+	/// same time.
+	SpinLock query_caches_lock;
+	/// The components whose storages log the inserted and removed `Entities`,
+	/// check `request_entities_log`.
+	LocalVector<godex::component_id> logged_components;
+	/// Tick used by the change detection, the storages mark the changed
+	/// components with it.
+	SafeNumeric<uint32_t> change_tick = SafeNumeric<uint32_t>(1);
+	/// The change detection filters, check `register_tick_reader`.
+	LocalVector<ChangeTickReader *> tick_readers;
+	/// The `DynamicQuery` may register while the systems run in parallel.
+	SpinLock tick_readers_lock;
+	/// The tick of the last `check_change_ticks` clamp.
+	uint32_t last_check_change_tick = 1;
 	EntityBuilder entity_builder = EntityBuilder(this);
+	EntitiesBuilder entities_builder = EntitiesBuilder(this);
 	bool is_dispatching_in_progress = false;
+	/// The storage `compact_storages` continues from.
+	uint32_t compact_storage_index = 0;
 	OAHashMap<NodePath, EntityID> entity_paths;
 
 	/// Storages configuration, the format is as follows:
@@ -144,13 +249,33 @@ public:
 	/// It's undefined behavior use it in any other way than the above one.
 	const EntityBuilder &create_entity();
 
+	/// Creates `p_count` new Entities and returns an `EntitiesBuilder`, that
+	/// adds the same components to all of them at once.
+	/// ```
+	///	world.create_entities(20000)
+	///			.with(TransformComponent());
+	/// ```
+	///
+	/// Note: The `EntitiesBuilder` reference points to an internal variable,
+	/// the next call to this function overwrites it.
+	const EntitiesBuilder &create_entities(uint32_t p_count);
+
 	/// This function can be used to associate a NodePath to an entity,
 	/// so it's possible to uniquly identify the entity.
 	void assign_nodepath_to_entity(EntityID p_entity, const NodePath &p_path);
 
 	/// Remove the entity from this World.
+	/// The `Entity` index is reused by the next created `Entity`, this
+	/// function does nothing when called with a stale `EntityID`.
 	void destroy_entity(EntityID p_entity);
 
+	/// Returns `true` if this `Entity` is not yet destroyed.
+	bool is_entity_alive(EntityID p_entity) const;
+
+	/// Returns the biggest `Entity` index ever created plus one: all the
+	/// `Entity` indices are smaller than this.
+	uint32_t get_entity_index_limit() const;
+
 	EntityID get_entity_from_path(const NodePath &p_path) const;
 	NodePath get_entity_path(EntityID p_id) const;
 
@@ -171,6 +296,19 @@ public:
 	template <class C>
 	bool has_component(EntityID p_entity) const;
 
+	/// Adds the components to all these `Entities` at once: `p_data[i]` is
+	/// assigned to `p_entities[i]`.
+	template <class C>
+	void add_component_batch(const EntityID *p_entities, const C *p_data, uint32_t p_count);
+
+	/// Adds the same component to all these `Entities` at once.
+	template <class C>
+	void add_component_batch(const EntityID *p_entities, const C &p_data, uint32_t p_count);
+
+	template <class C>
+	void remove_component_batch(const EntityID *p_entities, uint32_t p_count);
+	void remove_component_batch(const EntityID *p_entities, uint32_t p_count, uint32_t p_component_id);
+
 	/// Adds a new component using the component id and  a `Dictionary` that
 	/// contains the initialization parameters.
 	/// Usually this function is used to initialize the script components.
@@ -181,6 +319,11 @@ public:
 	template <class C>
 	godex::SID create_shared_component(const C &p_component);
 	godex::SID create_shared_component(uint32_t p_component_id, const Dictionary &p_component_data);
+
+	/// Returns the shared component that has the same data, if any, otherwise
+	/// creates it. Check `SharedSteadyStorage::create_or_get_shared_component`.
+	template <class C>
+	godex::SID create_or_get_shared_component(const C &p_component);
 	void add_shared_component(EntityID p_entity, uint32_t p_component_id, godex::SID p_shared_component_id);
 
 	/// Returns the const storage pointed by the give ID.
@@ -221,6 +364,117 @@ public:
 	template <class C>
 	const SharedStorage<const C> *get_shared_storage() const;
 
+	/// Creates an owning group: the storages of these components are kept
+	/// co-sorted, so the `Entities` that have all of them are packed at the
+	/// front of each storage, in the same order.
+	/// The `Query` that fetches exactly these components iterates the packed
+	/// range linearly, without any lookup.
+	/// ```
+	///	world.create_group<Position, Velocity>();
+	/// ```
+	///
+	/// Only the `DenseVectorStorage` can be grouped, and each storage can be
+	/// part of one group only.
+	/// Note: inserting or removing a grouped component reorders all the
+	/// grouped storages, so do it from a system that fetches all the grouped
+	/// components mutably.
+	template <class... Cs>
+	void create_group();
+	void create_group(const LocalVector<godex::component_id> &p_components);
+
+	/// Returns the group that has exactly these components, or `nullptr`.
+	/// The `UINT32_MAX` IDs are ignored.
+	const DenseGroup *get_group(const godex::component_id *p_components, uint32_t p_count) const;
+
+	/// Returns the cache identified by `p_key`, created the first time, used
+	/// by the cached `Query`: check `Query::set_cached`.
+	/// `p_components` are all the components used by the `Query`, their
+	/// storages notify the cache when an `Entity` gains or loses a component.
+	/// Returns `nullptr` when a storage doesn't track its `Entities`, since it
+	/// can't notify the cache.
+	QueryMatchCache *get_query_cache(uint64_t p_key, const LocalVector<godex::component_id> &p_components);
+
+	/// Makes the storage of this component log the inserted and removed
+	/// `Entities`, from now on: used by the `Added` and `Removed` filters.
+	void request_entities_log(godex::component_id p_component);
+
+	/// Drops the log entries already taken by all the active `Added` and
+	/// `Removed` filters reading them, check `ChangeTickReader`.
+	/// Called by the `Pipeline` each dispatch.
+	void trim_entities_logs();
+
+	/// Returns the table shared by all the `ArchetypeStorage`s of this `World`.
+	ArchetypeTable *get_archetype_table();
+	const ArchetypeTable *get_archetype_table() const;
+
+	/// Returns the allocator of this `World`: use `configure` to set the
+	/// memory budget.
+	WorldAllocator &get_allocator();
+	const WorldAllocator &get_allocator() const;
+
+	/// Destroys all the `Entities`, the storages and the events storages, and
+	/// frees their memory at once. The databags are kept.
+	/// The pipelines are released, so they prepare the `World` again before
+	/// dispatching it. The `EntityID`s taken before are not valid anymore,
+	/// and may point to the new `Entities`.
+	void teardown();
+
+	/// Compacts the storages, doing at most `p_budget` units of work (about
+	/// one element moved each): sorts the components in `Entity` order, so
+	/// the `Query`s that join many storages read the memory linearly, and
+	/// releases the over-reserved memory.
+	/// The pass is incremental: each call continues from where the previous
+	/// one stopped, so it's possible to run a slice each frame.
+	/// Returns `true` once the pass went through all the storages; the
+	/// `Entities` inserted in between the calls may be left out of order, for
+	/// the next pass to sort.
+	///
+	/// Note: the storages are reordered, so call it while the pipeline is not
+	/// dispatching.
+	bool compact_storages(uint32_t p_budget = 1024);
+
+	/// Returns the memory used by the storages: the key is the component name,
+	/// the value is a `Dictionary` with `bytes_used`, `bytes_reserved`,
+	/// `live_count`, `fragmentation` and the `storage` type name.
+	/// The components stored in the `ArchetypeTable` are reported together,
+	/// under the `ArchetypeTable` key; the `WorldAllocator` key reports the
+	/// allocator, with its `budget` and `over_budget_count`.
+	Dictionary get_memory_report() const;
+
+	/// The change ticks older than this are clamped by `check_change_ticks`,
+	/// so the wrapping compare of two ticks never overflows.
+	static constexpr uint32_t MAX_CHANGE_AGE = 1 << 30;
+	/// `check_change_ticks` clamps the ticks each time the change tick
+	/// advances this much: the ticks never get older than
+	/// `MAX_CHANGE_AGE + CHANGE_CHECK_INTERVAL`, that is less than `2^31`.
+	static constexpr uint32_t CHANGE_CHECK_INTERVAL = 1 << 29;
+
+	/// Returns the tick the storages use to mark the changed components.
+	uint32_t get_change_tick() const;
+
+	/// Returns the current change tick and advances it: the changes done
+	/// after this call are marked with a newer tick.
+	/// The `Changed` filter uses this to detect the changes happened since its
+	/// last run.
+	uint32_t advance_change_tick();
+
+	/// Registers the tick of a change detection filter, so
+	/// `check_change_ticks` clamps it. It must be unregistered before it's
+	/// destroyed.
+	void register_tick_reader(ChangeTickReader *p_reader);
+	void unregister_tick_reader(ChangeTickReader *p_reader);
+
+	/// The filters advance the change tick a few times each run, so it wraps
+	/// around after some days: once each `CHANGE_CHECK_INTERVAL` ticks, this
+	/// clamps the ticks older than `MAX_CHANGE_AGE`. The changes that old are
+	/// not taken anymore, but they are never taken as new.
+	/// Called by the `Pipeline` each dispatch.
+	void check_change_ticks();
+
+	/// Moves the change ticks of the storages, and the ticks of the
+	/// registered filters, older than `p_oldest_tick` to it.
+	void clamp_change_ticks(uint32_t p_oldest_tick);
+
 	/// Adds a new databag or does nothing.
 	template <class R>
 	R &create_databag();
@@ -260,6 +514,7 @@ public:
 	/// Retuns the events storage constant pointer.
 	const EventStorageBase *get_events_storage(godex::event_id p_id) const;
 
+	/// Releases this `World` from the pipelines that prepared it.
 	void release_pipelines();
 
 	/// Creates a new component storage into the world, if the storage
@@ -297,6 +552,33 @@ void World::add_component(EntityID p_entity, const C &p_data) {
 	storage->insert(p_entity, p_data);
 }
 
+template <class C>
+const EntitiesBuilder &EntitiesBuilder::with(const C &p_data) const {
+	world->add_component_batch(entities.ptr(), p_data, entities.size());
+	return *this;
+}
+
+template <class C>
+void World::add_component_batch(const EntityID *p_entities, const C *p_data, uint32_t p_count) {
+	create_storage<C>();
+	Storage<C> *storage = get_storage<C>();
+	ERR_FAIL_COND(storage == nullptr);
+	storage->insert_batch(p_entities, p_data, p_count);
+}
+
+template <class C>
+void World::add_component_batch(const EntityID *p_entities, const C &p_data, uint32_t p_count) {
+	create_storage<C>();
+	Storage<C> *storage = get_storage<C>();
+	ERR_FAIL_COND(storage == nullptr);
+	storage->insert_batch(p_entities, p_data, p_count);
+}
+
+template <class C>
+void World::remove_component_batch(const EntityID *p_entities, uint32_t p_count) {
+	remove_component_batch(p_entities, p_count, C::get_component_id());
+}
+
 template <class C>
 void World::remove_component(EntityID p_entity) {
 	remove_component(p_entity, C::get_component_id());
@@ -315,6 +597,17 @@ godex::SID World::create_shared_component(const C &p_component_data) {
 	return storage->create_shared_component(p_component_data);
 }
 
+template <class C>
+godex::SID World::create_or_get_shared_component(const C &p_component_data) {
+	typedef typename godex_component_storage<C>::type StorageType;
+	static_assert(!std::is_void<StorageType>::value, "The storage of this component is not known at compile time.");
+
+	create_storage<C>();
+	SharedStorage<C> *storage = get_shared_storage<C>();
+	ERR_FAIL_COND_V_MSG(storage == nullptr, godex::SID_NONE, "The storage is not supposed to be `nullptr` at this point.");
+	return static_cast<StorageType *>(storage)->create_or_get_shared_component(p_component_data);
+}
+
 template <class C>
 const Storage<const C> *World::get_storage() const {
 	const uint32_t id = C::get_component_id();
@@ -381,6 +674,14 @@ void World::create_storage() {
 	create_storage(C::get_component_id());
 }
 
+template <class... Cs>
+void World::create_group() {
+	LocalVector<godex::component_id> components;
+	components.reserve(sizeof...(Cs));
+	(components.push_back(Cs::get_component_id()), ...);
+	create_group(components);
+}
+
 template <class C>
 void World::destroy_storage() {
 	destroy_storage(C::get_component_id());